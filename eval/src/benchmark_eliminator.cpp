@@ -133,6 +133,13 @@ int main(int argc, char* argv[])
             eliminate(texts, texts.size());
         }
         history.record("elimination", repeat);
+
+        Eliminator<string_type> eliminate;
+        for(size_t i = 0; i < repeat; ++i){
+            eliminate.init(texts[i % texts.size()]);
+            eliminate(texts, texts.size());
+        }
+        history.record("reinitialization+elimination", repeat);
     }
     catch(const std::exception& e){
         std::cerr << "error: " << e.what() << std::endl;
@@ -0,0 +1,140 @@
+/*
+Resembla: Word-based Japanese similar sentence search library
+https://github.com/tuem/resembla
+
+Copyright 2017 Takashi Uemura
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <algorithm>
+#include <stdexcept>
+
+#include <paramset.hpp>
+
+#include "string_util.hpp"
+#include "measure/mecab_analyzer.hpp"
+
+using namespace resembla;
+
+// parses all texts repeat times using num_threads threads and returns elapsed time in milliseconds
+double parseAll(const MeCabAnalyzer& analyze, const std::vector<string_type>& texts, size_t repeat, size_t num_threads)
+{
+    auto start = std::chrono::system_clock::now();
+    std::vector<std::thread> threads;
+    for(size_t t = 0; t < num_threads; ++t){
+        threads.emplace_back([&analyze, &texts, repeat, num_threads, t](){
+            for(size_t i = t; i < texts.size() * repeat; i += num_threads){
+                analyze(texts[i % texts.size()]);
+            }
+        });
+    }
+    for(auto& thread: threads){
+        thread.join();
+    }
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now() - start).count() / 1000.0;
+}
+
+int main(int argc, char* argv[])
+{
+    init_locale();
+
+    paramset::definitions defs = {
+        {"col", 0, {"col"}, "col", 'i', "column number of text in tab-separated lines. use whole string of line if col=0"},
+        {"repeat", 1, {"repeat"}, "repeat", 'r', "repeat count of parsing all texts"},
+        {"max_threads", 0, {"max_threads"}, "max-threads", 't', "max number of threads (0: number of cores)"},
+        {"mecab_options", "", {"mecab_options"}, "mecab-options", 'm', "MeCab options"},
+        {"conf_path", "", "config", 'c', "config file path"}
+    };
+    paramset::manager pm(defs);
+    try{
+        pm.load(argc, argv, "config");
+        std::string path = pm.rest.size() > 0 ? pm.rest[0] : "";
+        size_t col = pm.get<int>("col");
+        size_t repeat = pm.get<int>("repeat");
+        size_t max_threads = pm.get<int>("max_threads");
+        if(max_threads == 0){
+            max_threads = std::max(std::thread::hardware_concurrency(), 1u);
+        }
+
+        std::vector<string_type> texts;
+        std::istream* is = path.empty() ? &std::cin : new std::ifstream(path);
+        while(is->good()){
+            std::string line;
+            std::getline(*is, line);
+            if(is->eof()){
+                break;
+            }
+            else if(line.empty()){
+                continue;
+            }
+
+            if(col == 0){
+                texts.push_back(cast_string<string_type>(line));
+            }
+            else{
+                auto columns = split(line, column_delimiter<>());
+                if(col - 1 < columns.size()){
+                    texts.push_back(cast_string<string_type>(columns[col - 1]));
+                }
+            }
+        }
+        if(is != &std::cin){
+            delete is;
+        }
+        if(texts.empty()){
+            throw std::runtime_error("no text");
+        }
+        std::cout << "corpus size: " << texts.size() << std::endl;
+
+        MeCabAnalyzer analyze(pm.get<std::string>("mecab_options"));
+        // warm up dictionary pages and lattices
+        parseAll(analyze, texts, 1, max_threads);
+
+        std::cout << std::endl;
+        std::cout << "threads\ttime[ms]\tthroughput[texts/s]\tspeedup" << std::endl;
+        // 1, 2, 4, ..., max_threads
+        std::vector<size_t> thread_counts;
+        for(size_t num_threads = 1; num_threads < max_threads; num_threads *= 2){
+            thread_counts.push_back(num_threads);
+        }
+        thread_counts.push_back(max_threads);
+
+        double base = 0.0;
+        for(auto num_threads: thread_counts){
+            double t = parseAll(analyze, texts, repeat, num_threads);
+            double throughput = texts.size() * repeat / (t / 1000.0);
+            if(num_threads == 1){
+                base = throughput;
+            }
+            std::cout <<
+                num_threads << "\t" <<
+                std::setprecision(10) << t << "\t" <<
+                std::setprecision(10) << throughput << "\t" <<
+                std::setprecision(4) << throughput / base <<
+                std::endl;
+        }
+    }
+    catch(const std::exception& e){
+        std::cerr << "error: " << e.what() << std::endl;
+        exit(1);
+    }
+
+    return 0;
+}
@@ -0,0 +1,155 @@
+/*
+Resembla: Word-based Japanese similar sentence search library
+https://github.com/tuem/resembla
+
+Copyright 2017 Takashi Uemura
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <regex>
+#include <chrono>
+#include <functional>
+#include <stdexcept>
+#include <stdlib.h>
+
+#include <paramset.hpp>
+
+#include "string_util.hpp"
+#include "regression/extractor/regex_set.hpp"
+
+using namespace resembla;
+
+// runs task repeat times and prints elapsed time
+void measure(const std::string& name, size_t repeat, size_t count, const std::function<void()>& task)
+{
+    auto start = std::chrono::system_clock::now();
+    for(size_t i = 0; i < repeat; ++i){
+        task();
+    }
+    auto t = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now() - start).count() / 1000.0;
+    std::cout <<
+        name << "\t" <<
+        std::setprecision(10) << t << "\t" <<
+        repeat * count << "\t" <<
+        std::setprecision(10) << t * 1000000.0 / (repeat * count) <<
+        std::endl;
+}
+
+// loads patterns in the format of RegexFeatureExtractor, i.e. score and pattern separated by a tab
+std::vector<std::string> load_patterns(const std::string& path)
+{
+    std::ifstream ifs(path);
+    if(ifs.fail()){
+        throw std::runtime_error("input file is not available: " + path);
+    }
+    std::vector<std::string> patterns;
+    std::string line;
+    while(std::getline(ifs, line) && !line.empty()){
+        size_t i = line.find(column_delimiter<>());
+        if(i != std::string::npos){
+            patterns.push_back(line.substr(i + 1));
+        }
+    }
+    return patterns;
+}
+
+// compares std::regex_match of each pattern with RegexSet on texts
+int main(int argc, char* argv[])
+{
+    init_locale();
+
+    paramset::definitions defs = {
+        {"col", 0, {"col"}, "col", 'i', "column number of text in tab-separated lines. use whole string of line if col=0"},
+        {"repeat", 10, {"repeat"}, "repeat", 'r', "repeat count of matching all texts"},
+        {"conf_path", "", "config", 'c', "config file path"}
+    };
+    paramset::manager pm(defs);
+    try{
+        pm.load(argc, argv, "config");
+        if(pm.rest.size() < 2){
+            throw std::invalid_argument("usage: benchmark_regex_set [options] text_file pattern_file...");
+        }
+        size_t col = pm.get<int>("col");
+        size_t repeat = pm.get<int>("repeat");
+
+        std::vector<string_type> texts;
+        std::vector<std::wstring> wtexts;
+        const std::string text_path = pm.rest[0];
+        std::ifstream ifs(text_path);
+        std::string line;
+        while(std::getline(ifs, line)){
+            if(line.empty()){
+                continue;
+            }
+            if(col > 0){
+                auto columns = split(line, column_delimiter<>());
+                if(col - 1 >= columns.size()){
+                    continue;
+                }
+                line = columns[col - 1];
+            }
+            texts.push_back(cast_string<string_type>(line));
+            wtexts.push_back(cast_string<std::wstring>(line));
+        }
+        if(texts.empty()){
+            throw std::runtime_error("no text");
+        }
+        std::cout << "corpus size: " << texts.size() << std::endl;
+        std::cout << std::endl;
+
+        std::cout << "task\ttime[ms]\tcount\taverage[ns]" << std::endl;
+        for(size_t p = 1; p < pm.rest.size(); ++p){
+            const std::string path = pm.rest[p];
+            auto patterns = load_patterns(path);
+            std::vector<std::wregex> re_all;
+            std::vector<string_type> converted;
+            for(const auto& pattern: patterns){
+                re_all.push_back(std::wregex(cast_string<std::wstring>(pattern)));
+                converted.push_back(cast_string<string_type>(pattern));
+            }
+            RegexSet re_set(converted);
+
+            std::vector<size_t> expected(texts.size(), RegexSet::npos), actual(texts.size());
+            measure(path + "(std::regex)", repeat, texts.size(), [&](){
+                for(size_t i = 0; i < wtexts.size(); ++i){
+                    for(size_t j = 0; j < re_all.size(); ++j){
+                        if(std::regex_match(wtexts[i], re_all[j])){
+                            expected[i] = j;
+                            break;
+                        }
+                    }
+                }
+            });
+            measure(path + "(RegexSet)", repeat, texts.size(), [&](){
+                for(size_t i = 0; i < texts.size(); ++i){
+                    actual[i] = re_set.match(texts[i]);
+                }
+            });
+            if(actual != expected){
+                throw std::runtime_error("results of RegexSet differ from std::regex: " + path);
+            }
+        }
+    }
+    catch(const std::exception& e){
+        std::cerr << "error: " << e.what() << std::endl;
+        exit(1);
+    }
+
+    return 0;
+}
@@ -0,0 +1,190 @@
+/*
+Resembla: Word-based Japanese similar sentence search library
+https://github.com/tuem/resembla
+
+Copyright 2017 Takashi Uemura
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <vector>
+#include <chrono>
+#include <functional>
+#include <stdexcept>
+#include <stdlib.h>
+
+#include <unicode/unistr.h>
+
+#include <paramset.hpp>
+
+#include "string_util.hpp"
+
+using namespace resembla;
+
+// conversions of earlier versions, which depend on locale
+
+void legacy_cast_string(const std::string& src, std::wstring& dest)
+{
+    std::wstring::value_type *wcs = new std::wstring::value_type[src.length() + 1];
+    mbstowcs(wcs, src.c_str(), src.length() + 1);
+    dest = wcs;
+    delete [] wcs;
+}
+
+void legacy_cast_string(const std::wstring& src, std::string& dest)
+{
+    std::string::value_type *mbs = new std::string::value_type[src.length() * MB_CUR_MAX + 1];
+    wcstombs(mbs, src.c_str(), src.length() * MB_CUR_MAX + 1);
+    dest = mbs;
+    delete [] mbs;
+}
+
+void legacy_cast_string(const std::wstring& src, UnicodeString& dest)
+{
+    std::string tmp;
+    legacy_cast_string(src, tmp);
+    dest = UnicodeString::fromUTF8(tmp);
+}
+
+void legacy_cast_string(const UnicodeString& src, std::wstring& dest)
+{
+    std::string tmp;
+    src.toUTF8String(tmp);
+    legacy_cast_string(tmp, dest);
+}
+
+// runs task repeat times and prints elapsed time
+void measure(const std::string& name, size_t repeat, size_t count, const std::function<void()>& task)
+{
+    auto start = std::chrono::system_clock::now();
+    for(size_t i = 0; i < repeat; ++i){
+        task();
+    }
+    auto t = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now() - start).count() / 1000.0;
+    std::cout <<
+        name << "\t" <<
+        std::setprecision(10) << t << "\t" <<
+        repeat * count << "\t" <<
+        std::setprecision(10) << t * 1000000.0 / (repeat * count) <<
+        std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+    init_locale();
+
+    paramset::definitions defs = {
+        {"col", 0, {"col"}, "col", 'i', "column number of text in tab-separated lines. use whole string of line if col=0"},
+        {"repeat", 10, {"repeat"}, "repeat", 'r', "repeat count of converting all texts"},
+        {"conf_path", "", "config", 'c', "config file path"}
+    };
+    paramset::manager pm(defs);
+    try{
+        pm.load(argc, argv, "config");
+        std::string path = pm.rest.size() > 0 ? pm.rest[0] : "";
+        size_t col = pm.get<int>("col");
+        size_t repeat = pm.get<int>("repeat");
+
+        std::vector<std::string> texts;
+        std::istream* is = path.empty() ? &std::cin : new std::ifstream(path);
+        while(is->good()){
+            std::string line;
+            std::getline(*is, line);
+            if(is->eof()){
+                break;
+            }
+            else if(line.empty()){
+                continue;
+            }
+
+            if(col == 0){
+                texts.push_back(line);
+            }
+            else{
+                auto columns = split(line, column_delimiter<>());
+                if(col - 1 < columns.size()){
+                    texts.push_back(columns[col - 1]);
+                }
+            }
+        }
+        if(is != &std::cin){
+            delete is;
+        }
+        if(texts.empty()){
+            throw std::runtime_error("no text");
+        }
+
+        std::vector<std::wstring> wtexts;
+        std::vector<UnicodeString> utexts;
+        for(const auto& text: texts){
+            wtexts.push_back(cast_string<std::wstring>(text));
+            utexts.push_back(cast_string<UnicodeString>(text));
+        }
+        std::cout << "corpus size: " << texts.size() << std::endl;
+        std::cout << std::endl;
+
+        std::cout << "task\ttime[ms]\tcount\taverage[ns]" << std::endl;
+        std::wstring w;
+        std::string s;
+        UnicodeString u;
+        measure("string->wstring(legacy)", repeat, texts.size(), [&](){
+            for(const auto& text: texts){
+                legacy_cast_string(text, w);
+            }
+        });
+        measure("string->wstring", repeat, texts.size(), [&](){
+            for(const auto& text: texts){
+                cast_string(text, w);
+            }
+        });
+        measure("wstring->string(legacy)", repeat, texts.size(), [&](){
+            for(const auto& text: wtexts){
+                legacy_cast_string(text, s);
+            }
+        });
+        measure("wstring->string", repeat, texts.size(), [&](){
+            for(const auto& text: wtexts){
+                cast_string(text, s);
+            }
+        });
+        measure("wstring->UnicodeString(legacy)", repeat, texts.size(), [&](){
+            for(const auto& text: wtexts){
+                legacy_cast_string(text, u);
+            }
+        });
+        measure("wstring->UnicodeString", repeat, texts.size(), [&](){
+            for(const auto& text: wtexts){
+                cast_string(text, u);
+            }
+        });
+        measure("UnicodeString->wstring(legacy)", repeat, texts.size(), [&](){
+            for(const auto& text: utexts){
+                legacy_cast_string(text, w);
+            }
+        });
+        measure("UnicodeString->wstring", repeat, texts.size(), [&](){
+            for(const auto& text: utexts){
+                cast_string(text, w);
+            }
+        });
+    }
+    catch(const std::exception& e){
+        std::cerr << "error: " << e.what() << std::endl;
+        exit(1);
+    }
+
+    return 0;
+}
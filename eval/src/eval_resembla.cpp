@@ -52,10 +52,10 @@ limitations under the License.
 using namespace resembla;
 
 // list of {true_text, list of {input_text, freq}}
-using TestData = std::vector<std::pair<std::wstring, std::vector<std::pair<std::wstring, int>>>>;
+using TestData = std::vector<std::pair<string_type, std::vector<std::pair<string_type, int>>>>;
 
-const string_type DELIMITER = L"\t";
-const string_type WORD_FREQ_SEPARATOR = L"/";
+const string_type DELIMITER = RESEMBLA_TEXT("\t");
+const string_type WORD_FREQ_SEPARATOR = RESEMBLA_TEXT("/");
 
 // generates SimString index and test data
 template<typename Preprocessor>
@@ -63,29 +63,30 @@ TestData prepare_data(std::string test_data_path, std::string db_path, std::stri
         int simstring_ngram_unit, Preprocessor preprocess)
 {
     simstring::ngram_generator gen(simstring_ngram_unit, false);
-    simstring::writer_base<std::wstring> dbw(gen, db_path);
-    std::unordered_map<std::wstring, std::unordered_set<std::wstring>> inverse;
+    simstring::writer_base<string_type> dbw(gen, db_path);
+    std::unordered_map<string_type, std::unordered_set<string_type>> inverse;
 
     TestData test_data;
     bool first = true;
-    std::wifstream wifs(test_data_path);
-    while(wifs.good()){
+    std::ifstream ifs(test_data_path);
+    while(ifs.good()){
         // format: {true}\t{input0}/{freq0}\t{input1}\t{freq1}...
-        std::wstring line;
-        std::getline(wifs, line);
+        std::string raw_line;
+        std::getline(ifs, raw_line);
         if(first){
             first = false;
             continue;
         }
-        if(wifs.eof() || line.length() == 0){
+        if(ifs.eof() || raw_line.length() == 0){
             break;
         }
+        auto line = cast_string<string_type>(raw_line);
         size_t start = 0;
         bool first = true;
         while(start < line.size()){
             size_t end = line.find(DELIMITER, start);
             if(first){
-                std::wstring original(line, start, end == std::wstring::npos ? line.size() : end - start);
+                string_type original(line, start, end == string_type::npos ? line.size() : end - start);
                 auto s = preprocess.index(original);
                 if(inverse.count(s) == 0){
                     dbw.insert(s);
@@ -94,35 +95,35 @@ TestData prepare_data(std::string test_data_path, std::string db_path, std::stri
                 else{
                     inverse[s].insert(original);
                 }
-                test_data.push_back(std::make_pair(original, std::vector<std::pair<std::wstring, int>>()));
+                test_data.push_back(std::make_pair(original, std::vector<std::pair<string_type, int>>()));
                 first = false;
             }
             else{
-                std::wstring s;
+                string_type s;
                 int f = 0;
                 size_t sep = line.find(WORD_FREQ_SEPARATOR, start);
-                if(sep != std::wstring::npos && (end == std::wstring::npos || sep < end)){
-                    s = std::wstring(line, start, sep - start);
-                    f = std::stoi(std::wstring(line, sep + 1, end == std::wstring::npos ? line.size() : end - start));
+                if(sep != string_type::npos && (end == string_type::npos || sep < end)){
+                    s = string_type(line, start, sep - start);
+                    f = std::stoi(cast_string<std::string>(string_type(line, sep + 1, end == string_type::npos ? line.size() : end - start)));
                 }
                 else{
-                    s = std::wstring(line, start, end == std::wstring::npos ? line.size() : end - start);
+                    s = string_type(line, start, end == string_type::npos ? line.size() : end - start);
                 }
                 test_data.back().second.push_back(std::make_pair(s, f));
             }
 
-            if(end == std::wstring::npos){
+            if(end == string_type::npos){
                 break;
             }
             start = end + 1;
         }
     }
     dbw.close();
-    std::wofstream wofs;
-    wofs.open(inverse_path);
+    std::ofstream ofs;
+    ofs.open(inverse_path);
     for(auto p: inverse){
         for(auto original: p.second){
-            wofs << p.first << L'\t' << original << std::endl;
+            ofs << cast_string<std::string>(p.first) << column_delimiter<>() << cast_string<std::string>(original) << std::endl;
         }
     }
     return test_data;
@@ -140,6 +141,15 @@ int main(int argc, char* argv[])
         {"resembla_threshold", 0.2, {"resembla", "threshold"}, "threshold", 't', "measure for scoring"},
         {"resembla_max_response", 20, {"resembla", "max_response"}, "max-response", 'n', "max number of responses from Resembla"},
         {"resembla_max_reranking_num", 1000, {"resembla", "max_reranking_num"}, "max-reranking-num", 'r', "max number of reranking texts in Resembla"},
+        {"resembla_num_threads", 0, {"resembla", "num_threads"}, "num-threads", 0, "number of worker threads for reranking (0: disable parallel reranking)"},
+        {"resembla_batch_num_threads", 0, {"resembla", "batch_num_threads"}, "batch-num-threads", 0, "number of worker threads for queries in batch of ensemble, in addition to num_threads (0: process queries one by one)"},
+        {"resembla_parallel_reranking_threshold", 500, {"resembla", "parallel_reranking_threshold"}, "parallel-reranking-threshold", 0, "min number of candidates to rerank in parallel"},
+        {"resembla_reranking_chunk_size", 0, {"resembla", "reranking_chunk_size"}, "reranking-chunk-size", 0, "number of candidates scored by a task in parallel reranking (0: auto)"},
+        {"resembla_ensemble_timeout", 0, {"resembla", "ensemble_timeout"}, "ensemble-timeout", 0, "timeout in milliseconds for each measure in ensemble, requires num-threads > 0 (0: no timeout)"},
+        {"resembla_ensemble_candidates", "", {"resembla", "ensemble_candidates"}, "ensemble-candidates", 0, "measures whose indexes generate candidates scored by all measures in ensemble (empty: each measure uses its own index)"},
+        {"cache_max_memory", 0, {"cache", "max_memory"}, "cache-max-memory", 0, "max memory in MB for caching responses (0: disable cache)"},
+        {"cache_shards", 16, {"cache", "shards"}, "cache-shards", 0, "number of independently locked cache shards"},
+        {"cache_ttl", 0.0, {"cache", "ttl"}, "cache-ttl", 0, "lifetime of cached responses in seconds (0: never expire). must be positive if date_period or time_period features are used"},
         {"simstring_ngram_unit", 2, {"simstring", "ngram_unit"}, "simstring-ngram-unit", 'N', "Unit of N-gram for SimString"},
         {"simstring_text_preprocess", "asis", {"simstring", "text_preprocess"}, "simstring-text-preprocess", 'P', "preprocessing method for texts to create index"},
         {"simstring_measure_str", "cosine", {"simstring", "measure"}, "simstring-measure", 's', "SimString measure"},
@@ -198,6 +208,13 @@ int main(int argc, char* argv[])
         {"svr_features_path", "features.tsv", {"svr", "features_path"}, "svr-features-path", 0, "feature definition file for support vector regression"},
         {"svr_patterns_home", ".", {"svr", "patterns_home"}, "svr-patterns-home", 0, "directory for pattern files for regular expression-based feature extractors"},
         {"svr_model_path", "model", {"svr", "model_path"}, "svr-model-path", 0, "LibSVM model file"},
+        {"svr_approximation_dimension", 0, {"svr", "approximation_dimension"}, "svr-approximation-dimension", 0, "number of random features to approximate SVR with RBF kernel, e.g. 512. SVR is not approximated if 0"},
+        {"svr_approximation_max_error", 0.05, {"svr", "approximation_max_error"}, "svr-approximation-max-error", 0, "max error of approximated SVR on validation data"},
+        {"svr_approximation_validation_path", "", {"svr", "approximation_validation_path"}, "svr-approximation-validation-path", 0, "LibSVM data file of features on evaluation data to validate approximated SVR. required if SVR is approximated"},
+        {"svr_approximation_seed", 0, {"svr", "approximation_seed"}, "svr-approximation-seed", 0, "seed of random features for approximated SVR"},
+        {"svr_cascade_size", 0, {"svr", "cascade_size"}, "svr-cascade-size", 0, "max number of candidates with the best base similarity passed to SVR. all candidates are passed if 0"},
+        {"svr_cascade_min_base_score", 0.0, {"svr", "cascade_min_base_score"}, "svr-cascade-min-base-score", 0, "min base similarity of candidates passed to SVR"},
+        {"svr_cascade_check_interval", 0, {"svr", "cascade_check_interval"}, "svr-cascade-check-interval", 0, "interval of queries to check changes of results by cascade. never checked if 0"},
         {"svr_features_col", 2, {"svr", "features_col"}, "svr-features-col", 0, "column number of features for support vector regression"},
         {"corpus_path", "", {"common", "corpus_path"}},
         {"id_col", 0, {"common", "id_col"}, "id-col", 0, "column number (starts with 1) of ID in corpus rows. ignored if id_col==0"},
@@ -280,6 +297,9 @@ int main(int argc, char* argv[])
         std::cerr << "    measure=" << pm.get<std::string>("resembla_measure") << std::endl;
         std::cerr << "    threshold=" << pm.get<double>("resembla_threshold") << std::endl;
         std::cerr << "    max_reranking_num=" << pm.get<int>("resembla_max_reranking_num") << std::endl;
+        std::cerr << "    num_threads=" << pm.get<int>("resembla_num_threads") << std::endl;
+        std::cerr << "    batch_num_threads=" << pm.get<int>("resembla_batch_num_threads") << std::endl;
+        std::cerr << "    parallel_reranking_threshold=" << pm.get<int>("resembla_parallel_reranking_threshold") << std::endl;
         std::cerr << "    max_response=" << pm.get<int>("resembla_max_response") << std::endl;
         for(const auto& resembla_measure: resembla_measures){
             if(resembla_measure == edit_distance && pm.get<double>("ed_ensemble_weight") > 0){
@@ -349,6 +369,9 @@ int main(int argc, char* argv[])
                 std::cerr << "    features_path=" << pm.get<std::string>("svr_features_path") << std::endl;
                 std::cerr << "    patterns_home=" << pm.get<std::string>("svr_patterns_home") << std::endl;
                 std::cerr << "    model_path=" << pm.get<std::string>("svr_model_path") << std::endl;
+                std::cerr << "    approximation_dimension=" << pm.get<int>("svr_approximation_dimension") << std::endl;
+                std::cerr << "    cascade_size=" << pm.get<int>("svr_cascade_size") << std::endl;
+                std::cerr << "    cascade_min_base_score=" << pm.get<double>("svr_cascade_min_base_score") << std::endl;
             }
         }
         time_points.push_back(std::make_pair(std::chrono::system_clock::now(), "config"));
@@ -400,7 +423,7 @@ int main(int argc, char* argv[])
                 }
                 case edit_distance: {
                     if(pm.get<double>("ed_ensemble_weight") > 0){
-                        AsIsSequenceBuilder<std::wstring> builder;
+                        AsIsSequenceBuilder<string_type> builder;
                         test_data = prepare_data(corpus_path, db_path, inverse_path, pm.get<int>("ed_simstring_ngram_unit"), builder);
                     }
                     break;
@@ -462,24 +485,26 @@ int main(int argc, char* argv[])
         std::cerr << "construction finished" << std::endl;
 
         // execute evaluation
-        std::vector<std::vector<ResemblaInterface::output_type>> answers;
+        std::vector<string_type> queries;
         for(const auto& d: test_data){
             for(const auto& i: d.second){
-                answers.push_back(resembla->find(i.first, resembla_threshold, resembla_max_response));
+                queries.push_back(i.first);
             }
         }
+        auto answers = resembla->find_batch(queries, resembla_threshold, resembla_max_response);
         time_points.push_back(std::make_pair(std::chrono::system_clock::now(), "answer"));
         std::cerr << "answering finished" << std::endl;
 
         // output results
         auto it = std::begin(answers);
-        std::wcout <<
-            "freq" << DELIMITER <<
-            "input" << DELIMITER <<
-            "pred" << DELIMITER <<
-            "true" << DELIMITER <<
-            "score" << DELIMITER <<
-            "score_of_correct_answer" << DELIMITER <<
+        const auto delimiter = cast_string<std::string>(DELIMITER);
+        std::cout <<
+            "freq" << delimiter <<
+            "input" << delimiter <<
+            "pred" << delimiter <<
+            "true" << delimiter <<
+            "score" << delimiter <<
+            "score_of_correct_answer" << delimiter <<
             "rank_of_correct_answer" << std::endl;
         for(const auto& d: test_data){
             const auto& original = d.first;
@@ -489,20 +514,20 @@ int main(int argc, char* argv[])
 
                 auto response = *it++;
 
-                std::wstring best = !response.empty() ? response[0].text : L"NONE";
+                string_type best = !response.empty() ? response[0].text : RESEMBLA_TEXT("NONE");
                 double score_best = !response.empty() ? response[0].score : -1;
                 auto p = std::find_if(response.begin(), response.end(),
                         [original](ResemblaInterface::output_type& r) -> bool {return original == r.text;});
                 int rank_correct = p != response.end() ? p - response.begin() + 1 : -1;
                 double score_correct = rank_correct != -1 ? response[rank_correct - 1].score : -1;
 
-                std::wcout <<
-                    freq << DELIMITER <<
-                    query << DELIMITER <<
-                    best << DELIMITER <<
-                    original << DELIMITER <<
-                    score_best << DELIMITER <<
-                    score_correct << DELIMITER <<
+                std::cout <<
+                    freq << delimiter <<
+                    cast_string<std::string>(query) << delimiter <<
+                    cast_string<std::string>(best) << delimiter <<
+                    cast_string<std::string>(original) << delimiter <<
+                    score_best << delimiter <<
+                    score_correct << delimiter <<
                     rank_correct << std::endl;
             }
         }
@@ -0,0 +1,106 @@
+/*
+Resembla: Word-based Japanese similar sentence search library
+https://github.com/tuem/resembla
+
+Copyright 2017 Takashi Uemura
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cmath>
+#include <stdexcept>
+#include <stdlib.h>
+
+#include <paramset.hpp>
+
+#include "string_util.hpp"
+#include "resembla_util.hpp"
+#include "regression/predictor/svr_model.hpp"
+#include "regression/predictor/approximate_svr_model.hpp"
+
+using namespace resembla;
+
+// compares SVR with its approximations by random Fourier features on a data file in LIBSVM format
+int main(int argc, char* argv[])
+{
+    paramset::definitions defs = {
+        {"dimensions", "64,256,512,1024,4096", {"dimensions"}, "dimensions", 'd', "comma-separated numbers of random features"},
+        {"seed", 0, {"seed"}, "seed", 's', "seed of random features"},
+        {"repeat", 10, {"repeat"}, "repeat", 'r', "repeat count of predicting all inputs"},
+        {"conf_path", "", "config", 'c', "config file path"}
+    };
+    paramset::manager pm(defs);
+    try{
+        pm.load(argc, argv, "config");
+        if(pm.rest.size() < 2){
+            throw std::invalid_argument("usage: eval_svr_approximation [options] model_file data_file");
+        }
+        SVRModel model(pm.rest[0]);
+        size_t repeat = pm.get<int>("repeat");
+
+        const size_t n = model.dimension();
+        auto inputs = load_svr_inputs(pm.rest[1], n);
+        if(inputs.empty()){
+            throw std::runtime_error("no input");
+        }
+        std::vector<double> xs;
+        for(const auto& x: inputs){
+            for(auto v: x){
+                xs.push_back(Feature::isMissing(v) ? 0.0 : v);
+            }
+        }
+        std::cout << "support vectors: " << model.size() << std::endl;
+        std::cout << "inputs: " << inputs.size() << std::endl;
+        std::cout << std::endl;
+
+        std::vector<double> expected(inputs.size());
+        auto t0 = std::chrono::system_clock::now();
+        for(size_t r = 0; r < repeat; ++r){
+            model.predict(xs.data(), n, inputs.size(), expected.data());
+        }
+        auto t = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now() - t0).count();
+
+        std::cout << "features\tmax_error\tmean_error\taverage[ns]" << std::endl;
+        std::cout << "exact\t0\t0\t" << std::setprecision(10) << t / static_cast<double>(repeat * inputs.size()) << std::endl;
+        for(const auto& d: split(pm.get<std::string>("dimensions"), ',')){
+            ApproximateSVRModel approximated(model, std::stoul(d), pm.get<int>("seed"));
+
+            std::vector<double> actual(inputs.size());
+            t0 = std::chrono::system_clock::now();
+            for(size_t r = 0; r < repeat; ++r){
+                approximated.predict(xs.data(), n, inputs.size(), actual.data());
+            }
+            t = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now() - t0).count();
+
+            double max_error = 0.0, total_error = 0.0;
+            for(size_t i = 0; i < inputs.size(); ++i){
+                auto e = std::abs(actual[i] - expected[i]);
+                max_error = std::max(max_error, e);
+                total_error += e;
+            }
+            std::cout << d << "\t" << max_error << "\t" << total_error / inputs.size() << "\t" <<
+                std::setprecision(10) << t / static_cast<double>(repeat * inputs.size()) << std::endl;
+        }
+    }
+    catch(const std::exception& e){
+        std::cerr << "error: " << e.what() << std::endl;
+        exit(1);
+    }
+
+    return 0;
+}
@@ -34,6 +34,7 @@
 #define __NGRAM_H__
 
 #include <map>
+#include <cstdio>
 #include <sstream>
 #include <string>
 
@@ -61,7 +62,6 @@ ngrams(
     )
 {
     typedef typename string_type::value_type char_type;
-    typedef std::basic_stringstream<char_type> stringstream_type;
     typedef std::map<string_type, int> ngram_stat_type;
     const char_type mark = (char_type)0x01;
 
@@ -93,10 +93,15 @@ ngrams(
     for (it = stat.begin();it != stat.end();++it) {
         *ins = it->first;
         // Append numbers if the same n-gram occurs more than once.
+        // Digits are appended without streams, which lack facets for char32_t.
         for (int i = 2;i <= it->second;++i) {
-            stringstream_type ss;
-            ss << it->first << i;
-            *ins = ss.str();
+            string_type numbered = it->first;
+            char digits[16];
+            int length = std::sprintf(digits, "%d", i);
+            for (int j = 0;j < length;++j) {
+                numbered += (char_type)digits[j];
+            }
+            *ins = numbered;
         }
     }
 }
@@ -18,8 +18,10 @@ limitations under the License.
 */
 
 #include <iostream>
+#include <algorithm>
 #include <memory>
 #include <string>
+#include <vector>
 #include <thread>
 
 #include <grpc++/grpc++.h>
@@ -27,6 +29,8 @@ limitations under the License.
 #include <paramset.hpp>
 
 #include "resembla_util.hpp"
+#include "async_resembla.hpp"
+#include "thread_affinity.hpp"
 #include "resembla.grpc.pb.h"
 
 using grpc::Server;
@@ -41,23 +45,41 @@ using namespace resembla;
 class ResemblaServerImpl final
 {
 public:
-    ResemblaServerImpl(std::shared_ptr<ResemblaInterface> resembla, double threshold, size_t max_response):
+    ResemblaServerImpl(std::shared_ptr<AsyncResembla> resembla, double threshold, size_t max_response):
         resembla(resembla), threshold(threshold), max_response(max_response) {}
 
     ~ResemblaServerImpl()
     {
         server_->Shutdown();
-        cq_->Shutdown();
+        for(auto& cq: cqs_){
+            cq->Shutdown();
+        }
     }
 
-    void Run(const std::string& server_address)
+    // polls num_queues completion queues with num_pollers threads for each.
+    // if cpus is not empty, polling threads are bound to them in turn
+    void Run(const std::string& server_address, size_t num_queues, size_t num_pollers, const std::vector<size_t>& cpus)
     {
         ServerBuilder builder;
         builder.AddListeningPort(server_address, grpc::InsecureServerCredentials());
         builder.RegisterService(&service_);
-        cq_ = builder.AddCompletionQueue();
+        for(size_t i = 0; i < std::max<size_t>(num_queues, 1); ++i){
+            cqs_.push_back(builder.AddCompletionQueue());
+        }
         server_ = builder.BuildAndStart();
-        HandleRpcs();
+
+        std::vector<std::thread> pollers;
+        for(auto& cq: cqs_){
+            for(size_t i = 0; i < std::max<size_t>(num_pollers, 1); ++i){
+                pollers.emplace_back(&ResemblaServerImpl::HandleRpcs, this, cq.get());
+                if(!cpus.empty()){
+                    set_thread_affinity(pollers.back(), cpus[(pollers.size() - 1) % cpus.size()]);
+                }
+            }
+        }
+        for(auto& poller: pollers){
+            poller.join();
+        }
     }
 
 private:
@@ -65,7 +87,7 @@ private:
     {
     public:
         CallData(server::ResemblaService::AsyncService* service, ServerCompletionQueue* cq,
-                std::shared_ptr<ResemblaInterface> resembla, double threshold, size_t max_response):
+                std::shared_ptr<AsyncResembla> resembla, double threshold, size_t max_response):
             service_(service), cq_(cq), writer_(&ctx_), status_(CREATE),
             resembla(resembla), threshold(threshold), max_response(max_response)
         {
@@ -81,11 +103,27 @@ private:
             else if(status_ == PROCESS){
                 new CallData(service_, cq_, resembla, threshold, max_response);
 
-                // The actual processing.
-                response_buffer_ = resembla->find(cast_string<string_type>(request_.query()), threshold, max_response);
-                i = 0;
-                status_ = RESPONSE;
-                write();
+                // The actual processing runs on threads of AsyncResembla to keep this thread polling
+                resembla->find_async(cast_string<string_type>(request_.query()), threshold, max_response,
+                        [this](std::vector<ResemblaInterface::output_type>&& response, std::exception_ptr error){
+                    if(error){
+                        std::string message = "search failed";
+                        try{
+                            std::rethrow_exception(error);
+                        }
+                        catch(const std::exception& e){
+                            message = e.what();
+                        }
+                        catch(...){}
+                        status_ = FINISH;
+                        writer_.Finish(Status(grpc::StatusCode::UNAVAILABLE, message), this);
+                        return;
+                    }
+                    response_buffer_ = std::move(response);
+                    i = 0;
+                    status_ = RESPONSE;
+                    write();
+                });
             }
             else if(status_ == RESPONSE){
                 write();
@@ -108,7 +146,7 @@ private:
         enum CallStatus { CREATE, PROCESS, RESPONSE, FINISH };
         CallStatus status_;  // The current serving state.
 
-        std::shared_ptr<ResemblaInterface> resembla;
+        std::shared_ptr<AsyncResembla> resembla;
         double threshold;
         size_t max_response;
 
@@ -125,28 +163,34 @@ private:
                 writer_.Write(_r, this);
             }
             else{
-                writer_.Finish(Status::OK, this);
                 status_ = FINISH;
+                writer_.Finish(Status::OK, this);
             }
         }
     };
 
-    void HandleRpcs()
+    // each polling thread keeps a call waiting for a new request, so requests are accepted on all threads
+    void HandleRpcs(ServerCompletionQueue* cq)
     {
-        new CallData(&service_, cq_.get(), resembla, threshold, max_response);
+        new CallData(&service_, cq, resembla, threshold, max_response);
         void* tag;  // uniquely identifies a request.
         bool ok;
-        while (true) {
-            cq_->Next(&tag, &ok);
-            static_cast<CallData*>(tag)->Proceed();
+        while(cq->Next(&tag, &ok)){
+            if(ok){
+                static_cast<CallData*>(tag)->Proceed();
+            }
+            else{
+                // the server is shutting down or the client is gone
+                delete static_cast<CallData*>(tag);
+            }
         }
     }
 
-    std::unique_ptr<ServerCompletionQueue> cq_;
+    std::vector<std::unique_ptr<ServerCompletionQueue>> cqs_;
     server::ResemblaService::AsyncService service_;
     std::unique_ptr<Server> server_;
 
-    std::shared_ptr<ResemblaInterface> resembla;
+    std::shared_ptr<AsyncResembla> resembla;
     double threshold;
     size_t max_response;
 };
@@ -160,6 +204,15 @@ int main(int argc, char** argv)
         {"resembla_threshold", 0.2, {"resembla", "threshold"}, "threshold", 't', "measure for scoring"},
         {"resembla_max_response", 20, {"resembla", "max_response"}, "max-response", 'n', "max number of responses from Resembla"},
         {"resembla_max_reranking_num", 1000, {"resembla", "max_reranking_num"}, "max-reranking-num", 'r', "max number of reranking texts in Resembla"},
+        {"resembla_num_threads", 0, {"resembla", "num_threads"}, "num-threads", 0, "number of worker threads for reranking (0: disable parallel reranking)"},
+        {"resembla_batch_num_threads", 0, {"resembla", "batch_num_threads"}, "batch-num-threads", 0, "number of worker threads for queries in batch of ensemble, in addition to num_threads (0: process queries one by one)"},
+        {"resembla_parallel_reranking_threshold", 500, {"resembla", "parallel_reranking_threshold"}, "parallel-reranking-threshold", 0, "min number of candidates to rerank in parallel"},
+        {"resembla_reranking_chunk_size", 0, {"resembla", "reranking_chunk_size"}, "reranking-chunk-size", 0, "number of candidates scored by a task in parallel reranking (0: auto)"},
+        {"resembla_ensemble_timeout", 0, {"resembla", "ensemble_timeout"}, "ensemble-timeout", 0, "timeout in milliseconds for each measure in ensemble, requires num-threads > 0 (0: no timeout)"},
+        {"resembla_ensemble_candidates", "", {"resembla", "ensemble_candidates"}, "ensemble-candidates", 0, "measures whose indexes generate candidates scored by all measures in ensemble (empty: each measure uses its own index)"},
+        {"cache_max_memory", 0, {"cache", "max_memory"}, "cache-max-memory", 0, "max memory in MB for caching responses (0: disable cache)"},
+        {"cache_shards", 16, {"cache", "shards"}, "cache-shards", 0, "number of independently locked cache shards"},
+        {"cache_ttl", 0.0, {"cache", "ttl"}, "cache-ttl", 0, "lifetime of cached responses in seconds (0: never expire). must be positive if date_period or time_period features are used"},
         {"simstring_text_preprocess", "asis", {"simstring", "text_preprocess"}, "simstring-text-preprocess", 'P', "preprocessing method for texts to create index"},
         {"simstring_measure_str", "cosine", {"simstring", "measure"}, "simstring-measure", 's', "SimString measure"},
         {"simstring_threshold", 0.2, {"simstring", "threshold"}, "simstring-threshold", 'T', "SimString threshold"},
@@ -206,7 +259,20 @@ int main(int argc, char** argv)
         {"svr_features_path", "features.tsv", {"svr", "features_path"}, "svr-features-path", 0, "feature definition file for support vector regression"},
         {"svr_patterns_home", ".", {"svr", "patterns_home"}, "svr-patterns-home", 0, "directory for pattern files for regular expression-based feature extractors"},
         {"svr_model_path", "model", {"svr", "model_path"}, "svr-model-path", 0, "LibSVM model file"},
+        {"svr_approximation_dimension", 0, {"svr", "approximation_dimension"}, "svr-approximation-dimension", 0, "number of random features to approximate SVR with RBF kernel, e.g. 512. SVR is not approximated if 0"},
+        {"svr_approximation_max_error", 0.05, {"svr", "approximation_max_error"}, "svr-approximation-max-error", 0, "max error of approximated SVR on validation data"},
+        {"svr_approximation_validation_path", "", {"svr", "approximation_validation_path"}, "svr-approximation-validation-path", 0, "LibSVM data file of features on evaluation data to validate approximated SVR. required if SVR is approximated"},
+        {"svr_approximation_seed", 0, {"svr", "approximation_seed"}, "svr-approximation-seed", 0, "seed of random features for approximated SVR"},
+        {"svr_cascade_size", 0, {"svr", "cascade_size"}, "svr-cascade-size", 0, "max number of candidates with the best base similarity passed to SVR. all candidates are passed if 0"},
+        {"svr_cascade_min_base_score", 0.0, {"svr", "cascade_min_base_score"}, "svr-cascade-min-base-score", 0, "min base similarity of candidates passed to SVR"},
+        {"svr_cascade_check_interval", 0, {"svr", "cascade_check_interval"}, "svr-cascade-check-interval", 0, "interval of queries to check changes of results by cascade. never checked if 0"},
         {"grpc_server_address", "localhost:50051", {"grpc", "server_address"}, "grpc-server-address", 0, "gRPC server address"},
+        {"async_num_threads", 4, {"async", "num_threads"}, "async-num-threads", 0, "number of threads processing requests asynchronously"},
+        {"async_max_queue", 0, {"async", "max_queue"}, "async-max-queue", 0, "max number of requests waiting to be processed, more requests are rejected (0: unlimited)"},
+        {"async_cpus", "", {"async", "cpus"}, "async-cpus", 0, "CPUs to which threads processing requests are bound, such as 0-3,8 (empty: not bound)"},
+        {"grpc_num_completion_queues", 1, {"grpc", "num_completion_queues"}, "grpc-num-completion-queues", 0, "number of completion queues polling gRPC events"},
+        {"grpc_num_pollers", 1, {"grpc", "num_pollers"}, "grpc-num-pollers", 0, "number of threads polling each completion queue"},
+        {"grpc_cpus", "", {"grpc", "cpus"}, "grpc-cpus", 0, "CPUs to which polling threads are bound, such as 0-1 (empty: not bound)"},
         {"corpus_path", "", {"common", "corpus_path"}},
         {"id_col", 0, {"common", "id_col"}, "id-col", 0, "column number (starts with 1) of ID in corpus rows. ignored if id_col==0"},
         {"text_col", 1, {"common", "text_col"}, "text-col", 0, "column mumber of text in corpus rows"},
@@ -284,10 +350,19 @@ int main(int argc, char** argv)
             std::cerr << "    ensemble_weight=" << pm.get<double>("wred_ensemble_weight") << std::endl;
             std::cerr << "  gRPC:" << std::endl;
             std::cerr << "    server_address=" << pm.get<std::string>("grpc_server_address") << std::endl;
+            std::cerr << "    num_completion_queues=" << pm.get<int>("grpc_num_completion_queues") << std::endl;
+            std::cerr << "    num_pollers=" << pm.get<int>("grpc_num_pollers") << std::endl;
+            std::cerr << "    cpus=" << pm.get<std::string>("grpc_cpus") << std::endl;
+            std::cerr << "  Async:" << std::endl;
+            std::cerr << "    num_threads=" << pm.get<int>("async_num_threads") << std::endl;
+            std::cerr << "    max_queue=" << pm.get<int>("async_max_queue") << std::endl;
+            std::cerr << "    cpus=" << pm.get<std::string>("async_cpus") << std::endl;
         }
-        auto resembla = construct_resembla(corpus_path, pm);
+        auto resembla = std::make_shared<AsyncResembla>(construct_resembla(corpus_path, pm),
+                pm.get<int>("async_num_threads"), pm.get<int>("async_max_queue"), parse_cpu_list(pm.get<std::string>("async_cpus")));
         ResemblaServerImpl server(resembla, pm.get<double>("resembla_threshold"), pm.get<int>("resembla_max_response"));
-        server.Run(pm.get<std::string>("grpc_server_address"));
+        server.Run(pm.get<std::string>("grpc_server_address"), pm.get<int>("grpc_num_completion_queues"),
+                pm.get<int>("grpc_num_pollers"), parse_cpu_list(pm.get<std::string>("grpc_cpus")));
     }
     catch(const std::exception& e){
         std::cerr << "error: " << e.what() << std::endl;
@@ -0,0 +1,185 @@
+/*
+Resembla: Word-based Japanese similar sentence search library
+https://github.com/tuem/resembla
+
+Copyright 2017 Takashi Uemura
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <algorithm>
+#include <atomic>
+#include <stdexcept>
+
+#include <grpc++/grpc++.h>
+#include <paramset.hpp>
+
+#include "string_util.hpp"
+#include "resembla.grpc.pb.h"
+
+using grpc::Channel;
+using grpc::ClientContext;
+using grpc::ClientReader;
+using grpc::Status;
+
+using namespace resembla;
+
+struct LoadTestResult
+{
+    size_t num_requests;
+    size_t num_errors;
+    double seconds;
+    // latencies of all requests in milliseconds, sorted
+    std::vector<double> latencies;
+};
+
+// sends queries from num_clients threads for the duration and measures latencies of successful requests
+LoadTestResult run_load_test(const std::string& server_address, const std::vector<std::string>& queries,
+        size_t num_clients, double duration, bool shared_channel)
+{
+    auto channel = grpc::CreateChannel(server_address, grpc::InsecureChannelCredentials());
+    std::vector<std::vector<double>> latencies(num_clients);
+    std::atomic<size_t> num_errors(0);
+
+    auto start = std::chrono::steady_clock::now();
+    auto deadline = start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<double>(duration));
+    std::vector<std::thread> clients;
+    for(size_t c = 0; c < num_clients; ++c){
+        clients.emplace_back([&, c](){
+            // separate channels use separate connections, so clients do not share one HTTP/2 connection
+            auto stub = server::ResemblaService::NewStub(shared_channel ? channel :
+                    grpc::CreateChannel(server_address, grpc::InsecureChannelCredentials()));
+            for(size_t i = c; std::chrono::steady_clock::now() < deadline; ++i){
+                server::ResemblaRequest request;
+                request.set_query(queries[i % queries.size()]);
+
+                auto t0 = std::chrono::steady_clock::now();
+                ClientContext context;
+                std::unique_ptr<ClientReader<server::ResemblaResponse>> reader(stub->find(&context, request));
+                server::ResemblaResponse response;
+                while(reader->Read(&response)){}
+                Status status = reader->Finish();
+                auto t1 = std::chrono::steady_clock::now();
+
+                if(status.ok()){
+                    latencies[c].push_back(std::chrono::duration<double, std::milli>(t1 - t0).count());
+                }
+                else{
+                    ++num_errors;
+                }
+            }
+        });
+    }
+    for(auto& client: clients){
+        client.join();
+    }
+
+    LoadTestResult result;
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    for(const auto& l: latencies){
+        result.latencies.insert(std::end(result.latencies), std::begin(l), std::end(l));
+    }
+    std::sort(std::begin(result.latencies), std::end(result.latencies));
+    result.num_errors = num_errors;
+    result.num_requests = result.latencies.size() + result.num_errors;
+    return result;
+}
+
+double percentile(const std::vector<double>& sorted, double p)
+{
+    if(sorted.empty()){
+        return 0.0;
+    }
+    return sorted[std::min(static_cast<size_t>(p * sorted.size()), sorted.size() - 1)];
+}
+
+// measures throughput of a running server with increasing numbers of concurrent clients
+int main(int argc, char* argv[])
+{
+    init_locale();
+
+    paramset::definitions defs = {
+        {"server_address", "localhost:50051", {"grpc", "server_address"}, "server-address", 's', "gRPC server address"},
+        {"clients", "1,2,4,8", {"load_test", "clients"}, "clients", 'n', "comma-separated numbers of concurrent clients"},
+        {"duration", 10.0, {"load_test", "duration"}, "duration", 'd', "seconds to send requests for each number of clients"},
+        {"shared_channel", false, {"load_test", "shared_channel"}, "shared-channel", 0, "share one channel among clients"},
+        {"conf_path", "", "config", 'c', "config file path"}
+    };
+    paramset::manager pm(defs);
+    try{
+        pm.load(argc, argv, "config");
+
+        std::vector<std::string> queries;
+        if(!pm.rest.empty()){
+            const std::string query_path = pm.rest[0];
+            std::ifstream ifs(query_path);
+            if(ifs.fail()){
+                throw std::runtime_error("input file is not available: " + query_path);
+            }
+            std::string line;
+            while(std::getline(ifs, line)){
+                if(!line.empty()){
+                    queries.push_back(line);
+                }
+            }
+        }
+        else{
+            queries = {"りんごはおいしいよね", "りんごおいしくねえ", "りんごまずいから好きじゃない"};
+        }
+        if(queries.empty()){
+            throw std::runtime_error("no query");
+        }
+
+        std::cout << "clients\trequests\terrors\tqps\tscaling\tmean[ms]\tp50[ms]\tp99[ms]" << std::endl;
+        double base_qps = 0.0;
+        size_t base_clients = 0;
+        for(const auto& n: split(pm.get<std::string>("clients"), ',')){
+            size_t num_clients = std::stoul(n);
+            auto result = run_load_test(pm.get<std::string>("server_address"), queries, num_clients,
+                    pm.get<double>("duration"), pm.get<bool>("shared_channel"));
+
+            double qps = result.latencies.size() / result.seconds;
+            if(base_clients == 0){
+                base_qps = qps;
+                base_clients = num_clients;
+            }
+            double mean = 0.0;
+            for(auto l: result.latencies){
+                mean += l;
+            }
+            mean /= std::max<size_t>(result.latencies.size(), 1);
+            // 1.0 means throughput grows linearly with the number of clients
+            double scaling = base_qps > 0.0 ? qps / (base_qps * num_clients / base_clients) : 0.0;
+
+            std::cout << num_clients << "\t" << result.num_requests << "\t" << result.num_errors << "\t" <<
+                std::fixed << std::setprecision(1) << qps << "\t" << std::setprecision(3) << scaling << "\t" <<
+                mean << "\t" << percentile(result.latencies, 0.5) << "\t" << percentile(result.latencies, 0.99) <<
+                std::defaultfloat << std::endl;
+        }
+    }
+    catch(const std::exception& e){
+        std::cerr << "error: " << e.what() << std::endl;
+        exit(1);
+    }
+
+    return 0;
+}
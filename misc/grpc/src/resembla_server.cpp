@@ -102,6 +102,15 @@ int main(int argc, char** argv) {
         {"resembla_max_response", 20, {"resembla", "max_response"}, "max-response", 'n', "max number of responses from Resembla"},
         {"resembla_threshold", 0.2, {"resembla", "threshold"}, "threshold", 't', "measure for scoring"},
         {"resembla_max_reranking_num", 1000, {"resembla", "max_reranking_num"}, "max-reranking-num", 'r', "max number of reranking texts in Resembla"},
+        {"resembla_num_threads", 0, {"resembla", "num_threads"}, "num-threads", 0, "number of worker threads for reranking (0: disable parallel reranking)"},
+        {"resembla_batch_num_threads", 0, {"resembla", "batch_num_threads"}, "batch-num-threads", 0, "number of worker threads for queries in batch of ensemble, in addition to num_threads (0: process queries one by one)"},
+        {"resembla_parallel_reranking_threshold", 500, {"resembla", "parallel_reranking_threshold"}, "parallel-reranking-threshold", 0, "min number of candidates to rerank in parallel"},
+        {"resembla_reranking_chunk_size", 0, {"resembla", "reranking_chunk_size"}, "reranking-chunk-size", 0, "number of candidates scored by a task in parallel reranking (0: auto)"},
+        {"resembla_ensemble_timeout", 0, {"resembla", "ensemble_timeout"}, "ensemble-timeout", 0, "timeout in milliseconds for each measure in ensemble, requires num-threads > 0 (0: no timeout)"},
+        {"resembla_ensemble_candidates", "", {"resembla", "ensemble_candidates"}, "ensemble-candidates", 0, "measures whose indexes generate candidates scored by all measures in ensemble (empty: each measure uses its own index)"},
+        {"cache_max_memory", 0, {"cache", "max_memory"}, "cache-max-memory", 0, "max memory in MB for caching responses (0: disable cache)"},
+        {"cache_shards", 16, {"cache", "shards"}, "cache-shards", 0, "number of independently locked cache shards"},
+        {"cache_ttl", 0.0, {"cache", "ttl"}, "cache-ttl", 0, "lifetime of cached responses in seconds (0: never expire). must be positive if date_period or time_period features are used"},
         {"simstring_measure_str", "cosine", {"simstring", "measure"}, "simstring-measure", 's', "SimString measure"},
         {"simstring_threshold", 0.2, {"simstring", "threshold"}, "simstring-threshold", 'T', "SimString threshold"},
         {"ed_simstring_threshold", -1, {"edit_distance", "simstring_threshold"}, "ed-simstring-threshold", 0, "SimString threshold for edit distance"},
@@ -149,6 +158,13 @@ int main(int argc, char** argv) {
         {"svr_features_path", "features.tsv", {"svr", "features_path"}, "svr-features-path", 0, "feature definition file for support vector regression"},
         {"svr_patterns_home", ".", {"svr", "patterns_home"}, "svr-patterns-home", 0, "directory for pattern files for regular expression-based feature extractors"},
         {"svr_model_path", "model", {"svr", "model_path"}, "svr-model-path", 0, "LibSVM model file"},
+        {"svr_approximation_dimension", 0, {"svr", "approximation_dimension"}, "svr-approximation-dimension", 0, "number of random features to approximate SVR with RBF kernel, e.g. 512. SVR is not approximated if 0"},
+        {"svr_approximation_max_error", 0.05, {"svr", "approximation_max_error"}, "svr-approximation-max-error", 0, "max error of approximated SVR on validation data"},
+        {"svr_approximation_validation_path", "", {"svr", "approximation_validation_path"}, "svr-approximation-validation-path", 0, "LibSVM data file of features on evaluation data to validate approximated SVR. required if SVR is approximated"},
+        {"svr_approximation_seed", 0, {"svr", "approximation_seed"}, "svr-approximation-seed", 0, "seed of random features for approximated SVR"},
+        {"svr_cascade_size", 0, {"svr", "cascade_size"}, "svr-cascade-size", 0, "max number of candidates with the best base similarity passed to SVR. all candidates are passed if 0"},
+        {"svr_cascade_min_base_score", 0.0, {"svr", "cascade_min_base_score"}, "svr-cascade-min-base-score", 0, "min base similarity of candidates passed to SVR"},
+        {"svr_cascade_check_interval", 0, {"svr", "cascade_check_interval"}, "svr-cascade-check-interval", 0, "interval of queries to check changes of results by cascade. never checked if 0"},
         {"grpc_server_address", "localhost:50051", {"grpc", "server_address"}, "grpc-server-address", 0, "gRPC server address"},
         {"corpus_path", "", {"common", "corpus_path"}},
         {"id_col", 0, {"common", "id_col"}, "id-col", 0, "column number (starts with 1) of ID in corpus rows. ignored if id_col==0"},
@@ -226,6 +242,9 @@ int main(int argc, char** argv) {
             std::cerr << "    measure=" << pm.get<std::string>("resembla_measure") << std::endl;
             std::cerr << "    threshold=" << pm.get<double>("resembla_threshold") << std::endl;
             std::cerr << "    max_reranking_num=" << pm.get<int>("resembla_max_reranking_num") << std::endl;
+            std::cerr << "    num_threads=" << pm.get<int>("resembla_num_threads") << std::endl;
+            std::cerr << "    batch_num_threads=" << pm.get<int>("resembla_batch_num_threads") << std::endl;
+            std::cerr << "    parallel_reranking_threshold=" << pm.get<int>("resembla_parallel_reranking_threshold") << std::endl;
             for(const auto& measure: measures){
                 if(measure == edit_distance && pm.get<double>("ed_ensemble_weight") > 0){
                     std::cerr << "  Edit distance:" << std::endl;
@@ -288,6 +307,9 @@ int main(int argc, char** argv) {
                     std::cerr << "    features_path=" << pm.get<std::string>("svr_features_path") << std::endl;
                     std::cerr << "    patterns_home=" << pm.get<std::string>("svr_patterns_home") << std::endl;
                     std::cerr << "    model_path=" << pm.get<std::string>("svr_model_path") << std::endl;
+                    std::cerr << "    approximation_dimension=" << pm.get<int>("svr_approximation_dimension") << std::endl;
+                    std::cerr << "    cascade_size=" << pm.get<int>("svr_cascade_size") << std::endl;
+                    std::cerr << "    cascade_min_base_score=" << pm.get<double>("svr_cascade_min_base_score") << std::endl;
                 }
             }
             std::cerr << "  gRPC:" << std::endl;
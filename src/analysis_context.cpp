@@ -0,0 +1,185 @@
+/*
+Resembla: Word-based Japanese similar sentence search library
+https://github.com/tuem/resembla
+
+Copyright 2017 Takashi Uemura
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <cstdint>
+#include <algorithm>
+#include <stdexcept>
+
+#include "analysis_context.hpp"
+
+namespace resembla {
+
+static const std::string ANALYSIS_MAGIC = "RSMBANL1";
+
+static void writeSize(std::ostream& os, uint64_t n)
+{
+    os.write(reinterpret_cast<const char*>(&n), sizeof(n));
+}
+
+static void writeString(std::ostream& os, const std::string& s)
+{
+    writeSize(os, s.size());
+    os.write(s.data(), s.size());
+}
+
+// thread-safe conversion unlike std::localtime
+static std::tm toLocalTime(std::time_t t)
+{
+    std::tm local;
+    if(localtime_r(&t, &local) == nullptr){
+        throw std::runtime_error("failed to convert time");
+    }
+    return local;
+}
+
+static uint64_t readSize(std::istream& is)
+{
+    uint64_t n;
+    if(!is.read(reinterpret_cast<char*>(&n), sizeof(n))){
+        throw std::runtime_error("analysis results are truncated");
+    }
+    return n;
+}
+
+// reads in blocks, so a corrupt length fails at the end of input instead of allocating a huge buffer
+static std::string readString(std::istream& is)
+{
+    std::string s;
+    char buffer[4096];
+    for(auto n = readSize(is); n > 0;){
+        auto k = std::min<uint64_t>(n, sizeof(buffer));
+        if(!is.read(buffer, k)){
+            throw std::runtime_error("analysis results are truncated");
+        }
+        s.append(buffer, k);
+        n -= k;
+    }
+    return s;
+}
+
+thread_local std::shared_ptr<AnalysisContext> AnalysisContext::active;
+
+AnalysisContext::AnalysisContext(std::time_t request_time):
+    request_time(request_time), request_local_time(toLocalTime(request_time)), query_only(false)
+{}
+
+AnalysisContext::AnalysisContext(const string_type& query, std::time_t request_time):
+    request_time(request_time), request_local_time(toLocalTime(request_time)), query_only(true), query(query)
+{}
+
+AnalysisContext::Scope::Scope(const string_type& query): previous(active)
+{
+    if(active == nullptr){
+        active = std::make_shared<AnalysisContext>(query);
+    }
+}
+
+AnalysisContext::Scope::Scope(std::shared_ptr<AnalysisContext> context): previous(active)
+{
+    active = context;
+}
+
+AnalysisContext::Scope::~Scope()
+{
+    active = previous;
+}
+
+std::shared_ptr<AnalysisContext> AnalysisContext::current()
+{
+    return active;
+}
+
+std::tm AnalysisContext::currentLocalTime()
+{
+    return active != nullptr ? active->localTime() : toLocalTime(std::time(nullptr));
+}
+
+std::shared_ptr<const AnalysisContext::morphemes_type> AnalysisContext::get(const void* analyzer, const string_type& text,
+        const std::function<morphemes_type()>& analyze)
+{
+    if(query_only && text != query){
+        return std::make_shared<const morphemes_type>(analyze());
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        const auto& r = results[analyzer];
+        auto i = r.find(text);
+        if(i != std::end(r)){
+            return i->second;
+        }
+    }
+
+    // analyze without lock. concurrent requests for the same text may analyze it twice
+    auto morphemes = std::make_shared<const morphemes_type>(analyze());
+    std::lock_guard<std::mutex> lock(mutex);
+    results[analyzer].emplace(text, morphemes);
+    return morphemes;
+}
+
+void AnalysisContext::save(const void* analyzer, std::ostream& os) const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    os.write(ANALYSIS_MAGIC.data(), ANALYSIS_MAGIC.size());
+    auto r = results.find(analyzer);
+    if(r == std::end(results)){
+        writeSize(os, 0);
+        return;
+    }
+
+    writeSize(os, r->second.size());
+    for(const auto& p: r->second){
+        writeString(os, cast_string<std::string>(p.first));
+        writeSize(os, p.second->size());
+        for(const auto& m: *p.second){
+            writeString(os, cast_string<std::string>(m.surface));
+            writeString(os, m.feature);
+        }
+    }
+    if(!os){
+        throw std::runtime_error("failed to write analysis results");
+    }
+}
+
+void AnalysisContext::load(const void* analyzer, std::istream& is)
+{
+    std::string magic(ANALYSIS_MAGIC.size(), '\0');
+    if(!is.read(&magic[0], magic.size()) || magic != ANALYSIS_MAGIC){
+        throw std::runtime_error("unknown format of analysis results");
+    }
+
+    std::unordered_map<string_type, std::shared_ptr<const morphemes_type>> loaded;
+    for(auto n = readSize(is); n > 0; --n){
+        auto text = cast_string<string_type>(readString(is));
+        morphemes_type morphemes;
+        for(auto m = readSize(is); m > 0; --m){
+            auto surface = cast_string<string_type>(readString(is));
+            morphemes.push_back({surface, readString(is)});
+        }
+        loaded.emplace(std::move(text), std::make_shared<const morphemes_type>(std::move(morphemes)));
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto& r = results[analyzer];
+    for(auto& p: loaded){
+        r.emplace(p.first, std::move(p.second));
+    }
+}
+
+}
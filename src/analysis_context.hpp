@@ -0,0 +1,107 @@
+/*
+Resembla: Word-based Japanese similar sentence search library
+https://github.com/tuem/resembla
+
+Copyright 2017 Takashi Uemura
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef RESEMBLA_ANALYSIS_CONTEXT_HPP
+#define RESEMBLA_ANALYSIS_CONTEXT_HPP
+
+#include <vector>
+#include <memory>
+#include <unordered_map>
+#include <mutex>
+#include <functional>
+#include <istream>
+#include <ostream>
+#include <ctime>
+
+#include "string_util.hpp"
+#include "word.hpp"
+
+namespace resembla {
+
+// results of morphological analysis and query-independent values shared in a request.
+// find, eval and score activate a context for their query, so the query is analyzed once per analyzer
+// even by different measures, sequence builders and nested Resembla instances
+class AnalysisContext
+{
+public:
+    using morphemes_type = std::vector<Morpheme>;
+
+    // keeps results of all texts, e.g. to analyze a corpus once for all measures.
+    // request_time is converted to local time once here, not for each feature extraction
+    AnalysisContext(std::time_t request_time = std::time(nullptr));
+    // keeps results of query only. candidates differ for each request, so they are analyzed without cache
+    AnalysisContext(const string_type& query, std::time_t request_time = std::time(nullptr));
+
+    // activates a context on the current thread while alive.
+    // the constructor with query reuses the active context if exists, so nested calls share the same context
+    class Scope
+    {
+    public:
+        Scope(const string_type& query);
+        Scope(std::shared_ptr<AnalysisContext> context);
+        ~Scope();
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    protected:
+        std::shared_ptr<AnalysisContext> previous;
+    };
+
+    // returns the context active on the current thread, or nullptr
+    static std::shared_ptr<AnalysisContext> current();
+
+    // returns the local time of the active request, or the current local time if no context is active
+    static std::tm currentLocalTime();
+
+    std::time_t time() const
+    {
+        return request_time;
+    }
+
+    const std::tm& localTime() const
+    {
+        return request_local_time;
+    }
+
+    // returns the cached result of analyzer for text, or computes it with analyze.
+    // texts other than query of a request context are neither cached nor locked
+    std::shared_ptr<const morphemes_type> get(const void* analyzer, const string_type& text,
+            const std::function<morphemes_type()>& analyze);
+
+    // writes all results of analyzer in a binary format
+    void save(const void* analyzer, std::ostream& os) const;
+    // adds results saved by save() as results of analyzer
+    void load(const void* analyzer, std::istream& is);
+
+protected:
+    const std::time_t request_time;
+    std::tm request_local_time;
+
+    const bool query_only;
+    const string_type query;
+
+    mutable std::mutex mutex;
+    std::unordered_map<const void*, std::unordered_map<string_type, std::shared_ptr<const morphemes_type>>> results;
+
+    static thread_local std::shared_ptr<AnalysisContext> active;
+};
+
+}
+#endif
@@ -0,0 +1,97 @@
+/*
+Resembla: Word-based Japanese similar sentence search library
+https://github.com/tuem/resembla
+
+Copyright 2017 Takashi Uemura
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "async_resembla.hpp"
+
+#include <stdexcept>
+
+namespace resembla {
+
+AsyncResembla::AsyncResembla(const std::shared_ptr<ResemblaInterface> resembla, size_t num_threads, size_t max_queue_size,
+        const std::vector<size_t>& cpus):
+    resembla(resembla), executor(new Executor(num_threads, max_queue_size, cpus))
+{}
+
+std::future<std::vector<AsyncResembla::output_type>> AsyncResembla::find_async(const string_type& query,
+        double threshold, size_t max_response) const
+{
+    auto promise = std::make_shared<std::promise<std::vector<output_type>>>();
+    find_async(query, threshold, max_response, [promise](std::vector<output_type>&& response, std::exception_ptr error){
+        if(error){
+            promise->set_exception(error);
+        }
+        else{
+            promise->set_value(std::move(response));
+        }
+    });
+    return promise->get_future();
+}
+
+std::future<std::vector<AsyncResembla::output_type>> AsyncResembla::eval_async(const string_type& query,
+        const std::vector<string_type>& targets, double threshold, size_t max_response) const
+{
+    auto promise = std::make_shared<std::promise<std::vector<output_type>>>();
+    eval_async(query, targets, threshold, max_response, [promise](std::vector<output_type>&& response, std::exception_ptr error){
+        if(error){
+            promise->set_exception(error);
+        }
+        else{
+            promise->set_value(std::move(response));
+        }
+    });
+    return promise->get_future();
+}
+
+void AsyncResembla::find_async(const string_type& query, double threshold, size_t max_response,
+        callback_type callback) const
+{
+    auto resembla = this->resembla;
+    run([resembla, query, threshold, max_response](){
+        return resembla->find(query, threshold, max_response);
+    }, callback);
+}
+
+void AsyncResembla::eval_async(const string_type& query, const std::vector<string_type>& targets,
+        double threshold, size_t max_response, callback_type callback) const
+{
+    auto resembla = this->resembla;
+    run([resembla, query, targets, threshold, max_response](){
+        return resembla->eval(query, targets, threshold, max_response);
+    }, callback);
+}
+
+void AsyncResembla::run(std::function<std::vector<output_type>()> search, callback_type callback) const
+{
+    bool accepted = executor->trySubmit([search, callback](){
+        std::vector<output_type> response;
+        std::exception_ptr error;
+        try{
+            response = search();
+        }
+        catch(...){
+            error = std::current_exception();
+        }
+        callback(std::move(response), error);
+    });
+    if(!accepted){
+        callback({}, std::make_exception_ptr(std::runtime_error("too many requests are waiting")));
+    }
+}
+
+}
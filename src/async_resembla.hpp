@@ -0,0 +1,65 @@
+/*
+Resembla: Word-based Japanese similar sentence search library
+https://github.com/tuem/resembla
+
+Copyright 2017 Takashi Uemura
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef RESEMBLA_ASYNC_RESEMBLA_HPP
+#define RESEMBLA_ASYNC_RESEMBLA_HPP
+
+#include <vector>
+#include <memory>
+#include <future>
+#include <functional>
+#include <exception>
+
+#include "resembla_interface.hpp"
+#include "executor.hpp"
+
+namespace resembla {
+
+// runs searches of wrapped Resembla on its own threads.
+// requests are rejected with std::runtime_error when max_queue_size requests are already waiting
+class AsyncResembla
+{
+public:
+    using output_type = ResemblaInterface::output_type;
+    // receives response, or error if failed
+    using callback_type = std::function<void(std::vector<output_type>&& response, std::exception_ptr error)>;
+
+    // threads are bound to cpus in turn if cpus is not empty
+    AsyncResembla(const std::shared_ptr<ResemblaInterface> resembla, size_t num_threads, size_t max_queue_size = 0,
+            const std::vector<size_t>& cpus = {});
+
+    std::future<std::vector<output_type>> find_async(const string_type& query,
+            double threshold = 0.0, size_t max_response = 0) const;
+    std::future<std::vector<output_type>> eval_async(const string_type& query, const std::vector<string_type>& targets,
+            double threshold = 0.0, size_t max_response = 0) const;
+
+    // callback is called on a thread of executor, or on the calling thread if the request is rejected
+    void find_async(const string_type& query, double threshold, size_t max_response, callback_type callback) const;
+    void eval_async(const string_type& query, const std::vector<string_type>& targets,
+            double threshold, size_t max_response, callback_type callback) const;
+
+protected:
+    const std::shared_ptr<ResemblaInterface> resembla;
+    const std::unique_ptr<Executor> executor;
+
+    void run(std::function<std::vector<output_type>()> search, callback_type callback) const;
+};
+
+}
+#endif
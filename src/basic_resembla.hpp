@@ -32,6 +32,7 @@ limitations under the License.
 #include <json.hpp>
 
 #include "resembla_interface.hpp"
+#include "analysis_context.hpp"
 #include "eliminator.hpp"
 #include "reranker.hpp"
 
@@ -48,22 +49,24 @@ public:
     BasicResembla(const std::string& db_path, const std::string& inverse_path,
             const int simstring_measure, const double simstring_threshold, const size_t max_reranking_num,
             std::shared_ptr<Preprocessor> preprocess, std::shared_ptr<ScoreFunction> score_func,
-            bool preprocess_corpus = true, size_t preprocessed_data_col = 3):
+            bool preprocess_corpus = true, size_t preprocessed_data_col = 3,
+            const Reranker<string_type>& reranker = Reranker<string_type>()):
         simstring_measure(simstring_measure), simstring_threshold(simstring_threshold), max_reranking_num(max_reranking_num),
-        reranker(), preprocess(preprocess), score_func(score_func), preprocess_corpus(preprocess_corpus)
+        reranker(reranker), preprocess(preprocess), score_func(score_func), preprocess_corpus(preprocess_corpus)
     {
         db.open(db_path);
-        std::basic_ifstream<string_type::value_type> ifs(inverse_path);
+        std::ifstream ifs(inverse_path);
         if(ifs.fail()){
             throw std::runtime_error("input file is not available: " + inverse_path);
         }
         while(ifs.good()){
-            string_type line;
-            std::getline(ifs, line);
-            if(ifs.eof() || line.length() == 0){
+            std::string raw_line;
+            std::getline(ifs, raw_line);
+            if(ifs.eof() || raw_line.length() == 0){
                 break;
             }
 
+            auto line = cast_string<string_type>(raw_line);
             auto columns = split(line, column_delimiter<string_type::value_type>());
             if(columns.size() < 2){
                 throw std::runtime_error("too few columns, corpus=" + inverse_path + ", line=" + cast_string<std::string>(line));
@@ -94,6 +97,32 @@ public:
 
     std::vector<output_type> find(const string_type& query, double threshold = 0.0, size_t max_response = 0) const
     {
+        AnalysisContext::Scope scope(query);
+        auto candidate_texts = candidates(query);
+        if(candidate_texts.empty()){
+            return {};
+        }
+        return eval(query, candidate_texts, threshold, max_response);
+    }
+
+    std::vector<output_type> eval(const string_type& query, const std::vector<string_type>& targets,
+            double threshold = 0.0, size_t max_response = 0) const
+    {
+        AnalysisContext::Scope scope(query);
+        auto candidates = load(targets);
+
+        // execute reranking
+        WorkData input_data = std::make_pair(query, (*preprocess)(query, false));
+        std::vector<output_type> response;
+        for(const auto& r: reranker.rerank(input_data, std::begin(candidates), std::end(candidates), *score_func, threshold, max_response)){
+            response.push_back({r.first, score_func->name, r.second});
+        }
+        return response;
+    }
+
+    std::vector<string_type> candidates(const string_type& query) const
+    {
+        AnalysisContext::Scope scope(query);
         string_type search_query = preprocess->index(query);
 
         // search from N-gram index
@@ -102,11 +131,87 @@ public:
             std::lock_guard<std::mutex> lock(mutex_simstring);
             db.retrieve(search_query, simstring_measure, simstring_threshold, std::back_inserter(simstring_result));
         }
+        return expand(search_query, simstring_result);
+    }
+
+    std::vector<std::vector<output_type>> find_batch(const std::vector<string_type>& queries,
+            double threshold = 0.0, size_t max_response = 0) const
+    {
+        std::vector<std::shared_ptr<AnalysisContext>> contexts;
+        for(size_t i = 0; i < queries.size(); ++i){
+            contexts.push_back(std::make_shared<AnalysisContext>(queries[i]));
+        }
+
+        std::vector<string_type> search_queries(queries.size());
+        forEachQuery(queries, batchPool(), [&](size_t i){
+            AnalysisContext::Scope scope(contexts[i]);
+            search_queries[i] = preprocess->index(queries[i]);
+        });
+
+        // search from N-gram index for all queries at once
+        std::vector<std::vector<string_type>> simstring_results(queries.size());
+        {
+            std::lock_guard<std::mutex> lock(mutex_simstring);
+            for(size_t i = 0; i < queries.size(); ++i){
+                db.retrieve(search_queries[i], simstring_measure, simstring_threshold,
+                        std::back_inserter(simstring_results[i]));
+            }
+        }
+
+        std::vector<std::vector<output_type>> results(queries.size());
+        forEachQuery(queries, batchPool(), [&](size_t i){
+            AnalysisContext::Scope scope(contexts[i]);
+            auto candidate_texts = expand(search_queries[i], simstring_results[i]);
+            if(!candidate_texts.empty()){
+                results[i] = eval(queries[i], candidate_texts, threshold, max_response);
+            }
+            contexts[i] = nullptr;
+        });
+        return results;
+    }
+
+    std::vector<double> score(const string_type& query, const std::vector<string_type>& targets) const
+    {
+        AnalysisContext::Scope scope(query);
+        auto candidates = load(targets);
+        WorkData input_data = std::make_pair(query, (*preprocess)(query, false));
+        return reranker.score(input_data, std::begin(candidates), std::end(candidates), *score_func);
+    }
+
+protected:
+    using WorkData = std::pair<string_type, typename Preprocessor::output_type>;
+
+    mutable simstring::reader db;
+    std::unordered_map<string_type, std::vector<string_type>> inverse;
+
+    const int simstring_measure;
+    const double simstring_threshold;
+    const size_t max_reranking_num;
+    const Reranker<string_type> reranker;
+
+    const std::shared_ptr<Preprocessor> preprocess;
+    const std::shared_ptr<ScoreFunction> score_func;
+
+    const bool preprocess_corpus;
+    std::unordered_map<string_type, WorkData> preprocessed_corpus;
+
+    mutable std::mutex mutex_simstring;
+
+    std::shared_ptr<ThreadPool> batchPool() const
+    {
+        return reranker.threadPool();
+    }
+
+    // narrows down the result of SimString and converts indexed texts to original ones
+    std::vector<string_type> expand(const string_type& search_query, std::vector<string_type>& simstring_result) const
+    {
         if(simstring_result.empty()){
             return {};
         }
         else if(simstring_result.size() > max_reranking_num){
-            Eliminator<string_type> eliminate(search_query);
+            // reuse buffers of eliminator in each thread
+            thread_local Eliminator<string_type> eliminate;
+            eliminate.init(search_query);
             eliminate(simstring_result, max_reranking_num);
         }
 
@@ -118,15 +223,14 @@ public:
             const auto& j = inverse.at(i);
             std::copy(std::begin(j), std::end(j), std::back_inserter(candidate_texts));
         }
-
-        return eval(query, candidate_texts, threshold, max_response);
+        return candidate_texts;
     }
 
-    std::vector<output_type> eval(const string_type& query, const std::vector<string_type>& targets,
-            double threshold = 0.0, size_t max_response = 0) const
+    // load preprocessed data if preprocessing is enabled. otherwise, process corpus texts on demand
+    std::vector<WorkData> load(const std::vector<string_type>& targets) const
     {
-        // load preprocessed data if preprocessing is enabled. otherwise, process corpus texts on demand
         std::vector<WorkData> candidates;
+        candidates.reserve(targets.size());
         for(const auto& t: targets){
             if(preprocess_corpus){
                 const auto i = preprocessed_corpus.find(t);
@@ -140,34 +244,8 @@ public:
                 tabpos != string_type::npos ? t.substr(0, tabpos) : t,
                 (*preprocess)(t, true)));
         }
-
-        // execute reranking
-        WorkData input_data = std::make_pair(query, (*preprocess)(query, false));
-        std::vector<output_type> response;
-        for(const auto& r: reranker.rerank(input_data, std::begin(candidates), std::end(candidates), *score_func, threshold, max_response)){
-            response.push_back({r.first, score_func->name, r.second});
-        }
-        return response;
+        return candidates;
     }
-
-protected:
-    using WorkData = std::pair<string_type, typename Preprocessor::output_type>;
-
-    mutable simstring::reader db;
-    std::unordered_map<string_type, std::vector<string_type>> inverse;
-
-    const int simstring_measure;
-    const double simstring_threshold;
-    const size_t max_reranking_num;
-    const Reranker<string_type> reranker;
-
-    const std::shared_ptr<Preprocessor> preprocess;
-    const std::shared_ptr<ScoreFunction> score_func;
-
-    const bool preprocess_corpus;
-    std::unordered_map<string_type, WorkData> preprocessed_corpus;
-
-    mutable std::mutex mutex_simstring;
 };
 
 }
@@ -0,0 +1,226 @@
+/*
+Resembla: Word-based Japanese similar sentence search library
+https://github.com/tuem/resembla
+
+Copyright 2017 Takashi Uemura
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "cached_resembla.hpp"
+
+#include <functional>
+#include <stdexcept>
+
+namespace resembla {
+
+CachedResembla::CachedResembla(const std::shared_ptr<ResemblaInterface> resembla, size_t max_bytes,
+        size_t num_shards, double ttl):
+    resembla(resembla), max_shard_bytes(max_bytes / (num_shards > 0 ? num_shards : 1)),
+    ttl(std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(ttl))),
+    num_hits(0), num_misses(0)
+{
+    if(num_shards == 0){
+        throw std::invalid_argument("number of cache shards must be positive");
+    }
+    if(ttl < 0.0){
+        throw std::invalid_argument("ttl of cache must not be negative");
+    }
+    for(size_t i = 0; i < num_shards; ++i){
+        shards.emplace_back(new Shard());
+    }
+}
+
+std::vector<CachedResembla::output_type> CachedResembla::find(const string_type& query,
+        double threshold, size_t max_response) const
+{
+    Key key = {query, threshold, max_response};
+    std::vector<output_type> response;
+    if(lookup(key, response)){
+        return response;
+    }
+
+    // search without lock. concurrent misses for the same key just overwrite each other
+    response = resembla->find(query, threshold, max_response);
+    store(key, response);
+    return response;
+}
+
+std::vector<std::vector<CachedResembla::output_type>> CachedResembla::find_batch(
+        const std::vector<string_type>& queries, double threshold, size_t max_response) const
+{
+    std::vector<std::vector<output_type>> responses(queries.size());
+    std::vector<size_t> missed;
+    std::vector<string_type> missed_queries;
+    for(size_t i = 0; i < queries.size(); ++i){
+        if(!lookup({queries[i], threshold, max_response}, responses[i])){
+            missed.push_back(i);
+            missed_queries.push_back(queries[i]);
+        }
+    }
+    if(missed.empty()){
+        return responses;
+    }
+
+    auto missed_responses = resembla->find_batch(missed_queries, threshold, max_response);
+    for(size_t i = 0; i < missed.size(); ++i){
+        store({missed_queries[i], threshold, max_response}, missed_responses[i]);
+        responses[missed[i]] = std::move(missed_responses[i]);
+    }
+    return responses;
+}
+
+std::vector<std::vector<CachedResembla::output_type>> CachedResembla::eval_batch(
+        const std::vector<string_type>& queries, const std::vector<std::vector<string_type>>& targets,
+        double threshold, size_t max_response) const
+{
+    return resembla->eval_batch(queries, targets, threshold, max_response);
+}
+
+std::vector<CachedResembla::output_type> CachedResembla::eval(const string_type& query,
+        const std::vector<string_type>& targets, double threshold, size_t max_response) const
+{
+    return resembla->eval(query, targets, threshold, max_response);
+}
+
+std::vector<string_type> CachedResembla::candidates(const string_type& query) const
+{
+    return resembla->candidates(query);
+}
+
+std::vector<double> CachedResembla::score(const string_type& query, const std::vector<string_type>& targets) const
+{
+    return resembla->score(query, targets);
+}
+
+void CachedResembla::invalidate()
+{
+    for(auto& s: shards){
+        std::lock_guard<std::mutex> lock(s->mutex);
+        s->index.clear();
+        s->entries.clear();
+        s->bytes = 0;
+    }
+}
+
+size_t CachedResembla::hits() const
+{
+    return num_hits;
+}
+
+size_t CachedResembla::misses() const
+{
+    return num_misses;
+}
+
+size_t CachedResembla::size() const
+{
+    size_t total = 0;
+    for(auto& s: shards){
+        std::lock_guard<std::mutex> lock(s->mutex);
+        total += s->entries.size();
+    }
+    return total;
+}
+
+size_t CachedResembla::bytes() const
+{
+    size_t total = 0;
+    for(auto& s: shards){
+        std::lock_guard<std::mutex> lock(s->mutex);
+        total += s->bytes;
+    }
+    return total;
+}
+
+bool CachedResembla::Key::operator==(const Key& key) const
+{
+    return query == key.query && threshold == key.threshold && max_response == key.max_response;
+}
+
+size_t CachedResembla::KeyHash::operator()(const Key& key) const
+{
+    size_t h = std::hash<string_type>()(key.query);
+    h ^= std::hash<double>()(key.threshold) + 0x9e3779b9 + (h << 6) + (h >> 2);
+    h ^= std::hash<size_t>()(key.max_response) + 0x9e3779b9 + (h << 6) + (h >> 2);
+    return h;
+}
+
+bool CachedResembla::lookup(const Key& key, std::vector<output_type>& response) const
+{
+    auto& s = shard(key);
+    {
+        std::lock_guard<std::mutex> lock(s.mutex);
+        auto i = s.index.find(key);
+        if(i != std::end(s.index)){
+            auto e = i->second;
+            if(ttl == clock::duration::zero() || clock::now() < e->expiration){
+                s.entries.splice(std::begin(s.entries), s.entries, e);
+                ++num_hits;
+                response = e->response;
+                return true;
+            }
+            s.bytes -= e->bytes;
+            s.index.erase(i);
+            s.entries.erase(e);
+        }
+    }
+    ++num_misses;
+    return false;
+}
+
+void CachedResembla::store(const Key& key, const std::vector<output_type>& response) const
+{
+    Entry entry = {key, response, 0, clock::now() + ttl};
+    entry.bytes = estimate(entry);
+    if(entry.bytes > max_shard_bytes){
+        return;
+    }
+
+    auto& s = shard(key);
+    std::lock_guard<std::mutex> lock(s.mutex);
+    auto i = s.index.find(key);
+    if(i != std::end(s.index)){
+        s.bytes -= i->second->bytes;
+        s.entries.erase(i->second);
+        s.index.erase(i);
+    }
+    while(!s.entries.empty() && s.bytes + entry.bytes > max_shard_bytes){
+        s.bytes -= s.entries.back().bytes;
+        s.index.erase(s.entries.back().key);
+        s.entries.pop_back();
+    }
+    s.bytes += entry.bytes;
+    s.entries.push_front(std::move(entry));
+    s.index[key] = std::begin(s.entries);
+}
+
+CachedResembla::Shard& CachedResembla::shard(const Key& key) const
+{
+    // upper bits are used to avoid correlation with buckets of unordered_map
+    size_t h = KeyHash()(key);
+    return *shards[(h ^ (h >> 16)) % shards.size()];
+}
+
+size_t CachedResembla::estimate(const Entry& entry)
+{
+    // list node, index node and contents of strings
+    size_t bytes = sizeof(Entry) + 2 * sizeof(void*) + sizeof(Key) + 4 * sizeof(void*) +
+        2 * entry.key.query.capacity() * sizeof(string_type::value_type);
+    for(const auto& r: entry.response){
+        bytes += sizeof(output_type) + r.text.capacity() * sizeof(string_type::value_type) + r.measure.capacity();
+    }
+    return bytes;
+}
+
+}
@@ -0,0 +1,127 @@
+/*
+Resembla: Word-based Japanese similar sentence search library
+https://github.com/tuem/resembla
+
+Copyright 2017 Takashi Uemura
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef RESEMBLA_CACHED_RESEMBLA_HPP
+#define RESEMBLA_CACHED_RESEMBLA_HPP
+
+#include <vector>
+#include <list>
+#include <unordered_map>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+
+#include "resembla_interface.hpp"
+
+namespace resembla {
+
+// caches responses of find for each (query, threshold, max_response) with LRU eviction.
+// entries are spread over shards with independent locks, and each shard evicts entries to keep
+// the estimated memory usage under max_bytes / num_shards. entries expire after ttl seconds if ttl > 0.
+// responses depending on the time of requests, e.g. scores of date_period or time_period features, need ttl > 0
+// since they are cached regardless of the time
+class CachedResembla: public ResemblaInterface
+{
+public:
+    CachedResembla(const std::shared_ptr<ResemblaInterface> resembla, size_t max_bytes,
+            size_t num_shards = 16, double ttl = 0.0);
+
+    std::vector<output_type> find(const string_type& query, double threshold = 0.0, size_t max_response = 0) const;
+    std::vector<output_type> eval(const string_type& query, const std::vector<string_type>& targets,
+            double threshold = 0.0, size_t max_response = 0) const;
+
+    // only queries not in cache are passed to the wrapped Resembla
+    std::vector<std::vector<output_type>> find_batch(const std::vector<string_type>& queries,
+            double threshold = 0.0, size_t max_response = 0) const;
+    std::vector<std::vector<output_type>> eval_batch(const std::vector<string_type>& queries,
+            const std::vector<std::vector<string_type>>& targets, double threshold = 0.0, size_t max_response = 0) const;
+
+    std::vector<string_type> candidates(const string_type& query) const;
+    std::vector<double> score(const string_type& query, const std::vector<string_type>& targets) const;
+
+    // removes all entries. must be called when the index of wrapped Resembla is reloaded
+    void invalidate();
+
+    const std::shared_ptr<ResemblaInterface>& wrapped() const
+    {
+        return resembla;
+    }
+
+    size_t hits() const;
+    size_t misses() const;
+    size_t size() const;
+    size_t bytes() const;
+
+protected:
+    using clock = std::chrono::steady_clock;
+
+    struct Key
+    {
+        string_type query;
+        double threshold;
+        size_t max_response;
+
+        bool operator==(const Key& key) const;
+    };
+
+    struct KeyHash
+    {
+        size_t operator()(const Key& key) const;
+    };
+
+    struct Entry
+    {
+        Key key;
+        std::vector<output_type> response;
+        size_t bytes;
+        clock::time_point expiration;
+    };
+
+    // entries are ordered from the most recently used one
+    struct Shard
+    {
+        std::mutex mutex;
+        std::list<Entry> entries;
+        std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> index;
+        size_t bytes = 0;
+    };
+
+    const std::shared_ptr<ResemblaInterface> resembla;
+
+    const size_t max_shard_bytes;
+    const clock::duration ttl;
+
+    mutable std::vector<std::unique_ptr<Shard>> shards;
+
+    mutable std::atomic<size_t> num_hits;
+    mutable std::atomic<size_t> num_misses;
+
+    Shard& shard(const Key& key) const;
+
+    // returns true and stores cached response if key exists
+    bool lookup(const Key& key, std::vector<output_type>& response) const;
+    void store(const Key& key, const std::vector<output_type>& response) const;
+
+    // estimated memory usage of an entry
+    static size_t estimate(const Entry& entry);
+};
+
+}
+#endif
@@ -0,0 +1,73 @@
+/*
+Resembla: Word-based Japanese similar sentence search library
+https://github.com/tuem/resembla
+
+Copyright 2017 Takashi Uemura
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "cascade.hpp"
+
+#include <algorithm>
+
+namespace resembla {
+
+Cascade::Cascade():
+    size(0), min_score(0.0), check_interval(0), num_cascaded(0), num_checked(0), num_changed(0)
+{}
+
+void Cascade::configure(size_t size, double min_score, size_t check_interval)
+{
+    this->size = size;
+    this->min_score = min_score;
+    this->check_interval = check_interval;
+}
+
+std::vector<size_t> Cascade::select(const std::vector<double>& scores) const
+{
+    std::vector<size_t> selected;
+    for(size_t i = 0; i < scores.size(); ++i){
+        if(min_score <= 0.0 || scores[i] >= min_score){
+            selected.push_back(i);
+        }
+    }
+
+    if(size > 0 && selected.size() > size){
+        // ties are broken by index, so the top size candidates are unique without stable sort
+        std::nth_element(std::begin(selected), std::begin(selected) + size - 1, std::end(selected),
+                [&scores](size_t a, size_t b){
+                    return scores[a] > scores[b] || (scores[a] == scores[b] && a < b);
+                });
+        selected.resize(size);
+        std::sort(std::begin(selected), std::end(selected));
+    }
+    return selected;
+}
+
+bool Cascade::countCascaded() const
+{
+    auto n = ++num_cascaded;
+    if(check_interval == 0 || n % check_interval != 0){
+        return false;
+    }
+    ++num_checked;
+    return true;
+}
+
+void Cascade::countChanged() const
+{
+    ++num_changed;
+}
+
+}
@@ -0,0 +1,82 @@
+/*
+Resembla: Word-based Japanese similar sentence search library
+https://github.com/tuem/resembla
+
+Copyright 2017 Takashi Uemura
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef RESEMBLA_CASCADE_HPP
+#define RESEMBLA_CASCADE_HPP
+
+#include <vector>
+#include <atomic>
+#include <cstddef>
+
+namespace resembla {
+
+// selects candidates to be passed to an expensive score function by the scores of a cheaper measure,
+// and counts queries in which candidates are dropped
+class Cascade
+{
+public:
+    Cascade();
+
+    // candidates are selected only if they are in top size by score (all if 0) and the score is at least min_score.
+    // every check_interval-th query dropping candidates is to be checked without cascade (never if 0)
+    void configure(size_t size, double min_score = 0.0, size_t check_interval = 0);
+
+    bool enabled() const
+    {
+        return size > 0 || min_score > 0.0;
+    }
+
+    // returns indices of selected candidates in ascending order. candidates with the same score are selected in order
+    std::vector<size_t> select(const std::vector<double>& scores) const;
+
+    // counts a query in which candidates are dropped, and returns true if the query is to be checked
+    bool countCascaded() const;
+    // counts a checked query in which cascade changed results
+    void countChanged() const;
+
+    // number of queries in which cascade dropped candidates
+    size_t cascadedQueries() const
+    {
+        return num_cascaded;
+    }
+
+    // number of cascaded queries also processed without cascade
+    size_t checkedQueries() const
+    {
+        return num_checked;
+    }
+
+    // number of checked queries in which cascade changed results
+    size_t changedQueries() const
+    {
+        return num_changed;
+    }
+
+protected:
+    size_t size;
+    double min_score;
+    size_t check_interval;
+
+    mutable std::atomic<size_t> num_cascaded;
+    mutable std::atomic<size_t> num_checked;
+    mutable std::atomic<size_t> num_changed;
+};
+
+}
+#endif
@@ -21,7 +21,9 @@ limitations under the License.
 #define RESEMBLA_COMPOSITION_HPP
 
 #include <string>
+#include <vector>
 #include <memory>
+#include <utility>
 
 namespace resembla {
 
@@ -38,14 +40,44 @@ public:
         name(!name.empty() ? name : g->name), f(f), g(g)
     {}
 
-    output_type operator()(const input_type& a, const input_type& b) const
+    // a and b can be of any type accepted by f, e.g. views of input_type
+    template<typename Input>
+    output_type operator()(const Input& a, const Input& b) const
     {
         return (*g)((*f)(a, b));
     }
 
+    // applies f to a and each of bs, then g to all the results at once. available if g accepts a vector of inputs
+    template<typename Input, typename H = G>
+    auto operator()(const Input& a, const std::vector<const Input*>& bs) const
+        -> decltype(std::declval<const H&>()(std::declval<const std::vector<typename F::output_type>&>()))
+    {
+        return (*g)(applyAll(*f, a, bs, 0));
+    }
+
 protected:
     const std::shared_ptr<F> f;
     const std::shared_ptr<G> g;
+
+    // uses the batch version of f if available
+    template<typename H, typename Input>
+    static auto applyAll(const H& h, const Input& a, const std::vector<const Input*>& bs, int)
+        -> decltype(h(a, bs))
+    {
+        return h(a, bs);
+    }
+
+    template<typename H, typename Input>
+    static std::vector<typename F::output_type> applyAll(const H& h, const Input& a,
+            const std::vector<const Input*>& bs, long)
+    {
+        std::vector<typename F::output_type> xs;
+        xs.reserve(bs.size());
+        for(const auto b: bs){
+            xs.push_back(h(a, *b));
+        }
+        return xs;
+    }
 };
 
 }
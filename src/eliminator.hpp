@@ -22,7 +22,7 @@ limitations under the License.
 
 #include <string>
 #include <vector>
-#include <map>
+#include <algorithm>
 
 #include "string_util.hpp"
 
@@ -40,20 +40,21 @@ struct Eliminator
         init(pattern);
     }
 
+    // (re)initialize with a new pattern. buffers allocated by previous calls are reused
     void init(string_type const& pattern)
     {
         this->pattern = pattern;
+        pattern_length = pattern.size();
         if(pattern.empty()){
             return;
         }
 
-        pattern_length = pattern.size();
         block_size = ((pattern_length - 1) >> bitOffset<bitvector_type>()) + 1;
         rest_bits = pattern_length - (block_size - 1) * bitWidth<bitvector_type>();
         sink = bitvector_type{1} << (rest_bits - 1);
 
         constructPM();
-        zeroes.resize(block_size, 0);
+        zeroes.assign(block_size, 0);
         work.resize(block_size);
 
         VP0 = 0;
@@ -64,50 +65,32 @@ struct Eliminator
 
     void operator()(std::vector<string_type>& candidates, size_type k, bool keep_tie = true)
     {
-        using index_distance = std::pair<size_type, distance_type>;
+        eliminate(candidates, k, nullptr, keep_tie);
+    }
 
-        // calculate scores
-        std::vector<index_distance> work(candidates.size());
-        for(size_type i = 0; i < work.size(); ++i){
-            work[i].first = i;
-            work[i].second = -distance(candidates[i]);
-        }
+    // same as above, but also stores the distance of each remaining candidate to distances
+    void operator()(std::vector<string_type>& candidates, size_type k, std::vector<distance_type>& distances,
+            bool keep_tie = true)
+    {
+        eliminate(candidates, k, &distances, keep_tie);
+    }
 
-        if(keep_tie){
-            // sort partially to obtain top-k elements
-            std::nth_element(std::begin(work), std::begin(work) + k, std::end(work),
-                [](const index_distance& a, const index_distance& b) -> bool{
-                    return a.second > b.second;
-                });
+    // bit-parallel edit distance between pattern and text
+    distance_type distance(string_type const &text)
+    {
+        if(text.empty()){
+            return pattern_length;
         }
-        else{
-            std::sort(std::begin(work), std::end(work),
-                [](const index_distance& a, const index_distance& b) -> bool{
-                    return a.second > b.second;
-                });
-            // expand k so that work[l] < work[k] for all l > k
-            while(k < work.size() - 1 && work[k] == work[k + 1]){
-                ++k;
-            }
+        else if(pattern_length == 0){
+            return text.size();
         }
 
-        // ensure that work[i].first < work[j].first if i < j < k
-        std::sort(std::begin(work), std::begin(work) + k,
-            [](const index_distance& a, const index_distance& b) -> bool{
-                return a.first < b.first;
-            });
-#ifdef DEBUG
-        std::cerr << "narrow " << work.size() << " strings" << std::endl;
-        for(size_type i = 0; i < k; ++i){
-            std::cerr << cast_string<std::string>(candidates[work[i].first]) << ": " << work[i].second << std::endl;
+        if(block_size == 1){
+            return distance_sp(text);
         }
-#endif
-
-        // sort original list
-        for(size_type i = 0; i < k; ++i){
-            std::swap(candidates[i], candidates[work[i].first]);
+        else{
+            return distance_lp(text);
         }
-        candidates.erase(std::begin(candidates) + k, std::end(candidates));
     }
 
 protected:
@@ -118,9 +101,15 @@ protected:
     size_type rest_bits;
     bitvector_type sink;
 
+    // PM[0..alphabet_size) is valid. elements beyond alphabet_size are kept to reuse their buffers
     std::vector<std::pair<symbol_type, std::vector<bitvector_type>>> PM;
+    size_type alphabet_size;
+    std::vector<std::pair<symbol_type, size_type>> positions;
     std::vector<bitvector_type> zeroes;
 
+    using index_distance = std::pair<size_type, distance_type>;
+    std::vector<index_distance> scores;
+
     struct WorkData
     {
         bitvector_type D0;
@@ -153,65 +142,129 @@ protected:
         return bitOffset(bitWidth<Integer>());
     }
 
-    template<typename key_type, typename value_type>
-    const value_type& findValue(const std::vector<std::pair<key_type, value_type>>& data,
-            const key_type c, const value_type& default_value) const
+    const std::vector<bitvector_type>& findValue(const symbol_type c) const
     {
         if(c < c_min || c_max < c){
-            return default_value;
+            return zeroes;
         }
         else if(c == c_min){
             return PM.front().second;
         }
         else if(c == c_max){
-            return PM.back().second;
+            return PM[alphabet_size - 1].second;
         }
 
-        size_type l = 1, r = data.size() - 1;
+        size_type l = 1, r = alphabet_size - 1;
         while(r - l > 8){
             auto i = (l + r) / 2;
-            if(data[i].first < c){
+            if(PM[i].first < c){
                 l = i + 1;
             }
-            else if(data[i].first > c){
+            else if(PM[i].first > c){
                 r = i;
             }
             else{
-                return data[i].second;
+                return PM[i].second;
             }
         }
 
         for(size_type i = l; i < r; ++i){
-            if(data[i].first == c){
-                return data[i].second;
+            if(PM[i].first == c){
+                return PM[i].second;
             }
         }
 
-        return default_value;
+        return zeroes;
     }
 
     void constructPM()
     {
-        std::map<symbol_type, std::vector<bitvector_type>> PM_work;
-        for(size_type i = 0; i < block_size - 1; ++i){
-            for(size_type j = 0; j < bitWidth<bitvector_type>(); ++j){
-                if(PM_work[pattern[i * bitWidth<bitvector_type>() + j]].empty()){
-                    PM_work[pattern[i * bitWidth<bitvector_type>() + j]].resize(block_size, 0);
+        // sort (symbol, position) pairs instead of building a temporary map
+        positions.resize(pattern_length);
+        for(size_type i = 0; i < pattern_length; ++i){
+            positions[i] = std::make_pair(pattern[i], i);
+        }
+        std::sort(std::begin(positions), std::end(positions));
+
+        alphabet_size = 0;
+        for(size_type i = 0; i < pattern_length; ++i){
+            if(i == 0 || positions[i].first != positions[i - 1].first){
+                if(alphabet_size == PM.size()){
+                    PM.emplace_back();
                 }
-                PM_work[pattern[i * bitWidth<bitvector_type>() + j]][i] |= bitvector_type{1} << j;
+                PM[alphabet_size].first = positions[i].first;
+                PM[alphabet_size].second.assign(block_size, 0);
+                ++alphabet_size;
             }
+            auto j = positions[i].second;
+            PM[alphabet_size - 1].second[j >> bitOffset<bitvector_type>()] |=
+                bitvector_type{1} << (j & (bitWidth<bitvector_type>() - 1));
         }
-        for(size_type i = 0; i < rest_bits; ++i){
-            if(PM_work[pattern[(block_size - 1) * bitWidth<bitvector_type>() + i]].empty()){
-                PM_work[pattern[(block_size - 1) * bitWidth<bitvector_type>() + i]].resize(block_size, 0);
+        c_min = PM.front().first;
+        c_max = PM[alphabet_size - 1].first;
+    }
+
+    void eliminate(std::vector<string_type>& candidates, size_type k, std::vector<distance_type>* distances, bool keep_tie)
+    {
+        // calculate scores
+        scores.resize(candidates.size());
+        for(size_type i = 0; i < scores.size(); ++i){
+            scores[i].first = i;
+            scores[i].second = -distance(candidates[i]);
+        }
+
+        if(k >= scores.size()){
+            if(distances != nullptr){
+                distances->resize(scores.size());
+                for(size_type i = 0; i < scores.size(); ++i){
+                    (*distances)[i] = -scores[i].second;
+                }
             }
-            PM_work[pattern[(block_size - 1) * bitWidth<bitvector_type>() + i]].back() |= bitvector_type{1} << i;
+            return;
         }
 
-        PM.resize(PM_work.size());
-        std::copy(PM_work.begin(), PM_work.end(), PM.begin());
-        c_min = PM.front().first;
-        c_max = PM.back().first;
+        if(keep_tie){
+            // sort partially to obtain top-k elements
+            std::nth_element(std::begin(scores), std::begin(scores) + k, std::end(scores),
+                [](const index_distance& a, const index_distance& b) -> bool{
+                    return a.second > b.second;
+                });
+        }
+        else{
+            std::sort(std::begin(scores), std::end(scores),
+                [](const index_distance& a, const index_distance& b) -> bool{
+                    return a.second > b.second;
+                });
+            // expand k so that scores[l] < scores[k] for all l > k
+            while(k < scores.size() - 1 && scores[k] == scores[k + 1]){
+                ++k;
+            }
+        }
+
+        // ensure that scores[i].first < scores[j].first if i < j < k
+        std::sort(std::begin(scores), std::begin(scores) + k,
+            [](const index_distance& a, const index_distance& b) -> bool{
+                return a.first < b.first;
+            });
+#ifdef DEBUG
+        std::cerr << "narrow " << scores.size() << " strings" << std::endl;
+        for(size_type i = 0; i < k; ++i){
+            std::cerr << cast_string<std::string>(candidates[scores[i].first]) << ": " << scores[i].second << std::endl;
+        }
+#endif
+
+        // sort original list
+        for(size_type i = 0; i < k; ++i){
+            std::swap(candidates[i], candidates[scores[i].first]);
+        }
+        candidates.erase(std::begin(candidates) + k, std::end(candidates));
+
+        if(distances != nullptr){
+            distances->resize(k);
+            for(size_type i = 0; i < k; ++i){
+                (*distances)[i] = -scores[i].second;
+            }
+        }
     }
 
     distance_type distance_sp(string_type const &text)
@@ -222,7 +275,7 @@ protected:
 
         distance_type D = pattern_length;
         for(auto c: text){
-            auto X = findValue(PM, c, zeroes).front() | w.VN;
+            auto X = findValue(c).front() | w.VN;
 
             w.D0 = ((w.VP + (X & w.VP)) ^ w.VP) | X;
             w.HP = w.VN | ~(w.VP | w.D0);
@@ -253,7 +306,7 @@ protected:
 
         distance_type D = pattern_length;
         for(auto c: text){
-            const auto& PMc = findValue(PM, c, zeroes);
+            const auto& PMc = findValue(c);
             for(size_type r = 0; r < block_size; ++r){
                 auto& w = work[r];
                 auto X = PMc[r];
@@ -285,23 +338,6 @@ protected:
         }
         return D;
     }
-
-    distance_type distance(string_type const &text)
-    {
-        if(text.empty()){
-            return pattern_length;
-        }
-        else if(pattern_length == 0){
-            return text.size();
-        }
-
-        if(block_size == 1){
-            return distance_sp(text);
-        }
-        else{
-            return distance_lp(text);
-        }
-    }
 };
 
 }
@@ -22,6 +22,7 @@ limitations under the License.
 #include <string>
 #include <unordered_map>
 #include <set>
+#include <vector>
 #include <memory>
 #include <stdexcept>
 
@@ -31,9 +32,11 @@ limitations under the License.
 #include <json.hpp>
 
 #include "string_normalizer.hpp"
+#include "analysis_context.hpp"
 
 #include "resembla_util.hpp"
 
+#include "measure/mecab_analyzer.hpp"
 #include "measure/asis_sequence_builder.hpp"
 #include "measure/word_sequence_builder.hpp"
 #include "measure/pronunciation_sequence_builder.hpp"
@@ -63,17 +66,18 @@ void create_index(const std::string corpus_path, const std::string db_path, cons
     simstring::ngram_generator gen(n, false);
     simstring::writer_base<string_type> dbw(gen, db_path);
     std::unordered_map<string_type, std::set<string_type>> inserted;
-    std::basic_ifstream<string_type::value_type> ifs(corpus_path);
+    std::ifstream ifs(corpus_path);
     if(ifs.fail()){
         throw std::runtime_error("input file is not available: " + corpus_path);
     }
 
     while(ifs.good()){
-        string_type line;
-        std::getline(ifs, line);
-        if(ifs.eof() || line.length() == 0){
+        std::string raw_line;
+        std::getline(ifs, raw_line);
+        if(ifs.eof() || raw_line.length() == 0){
             break;
         }
+        auto line = cast_string<string_type>(raw_line);
 
         auto columns = split(line, delimiter);
         if(text_col > columns.size()){
@@ -97,7 +101,7 @@ void create_index(const std::string corpus_path, const std::string db_path, cons
         }
     }
     dbw.close();
-    std::basic_ofstream<string_type::value_type> ofs;
+    std::ofstream ofs;
     ofs.open(inverse_path);
     for(auto p: inserted){
         for(auto original: p.second){
@@ -107,12 +111,84 @@ void create_index(const std::string corpus_path, const std::string db_path, cons
                 normalized += delimiter + columns[1];
             }
             nlohmann::json j = preprocess(normalized, true);
-            auto preprocessed = cast_string<string_type>(j.dump());
-            ofs << p.first << delimiter << columns[0] << delimiter << preprocessed << std::endl;
+            ofs << cast_string<std::string>(p.first) << column_delimiter<>() << cast_string<std::string>(columns[0]) << column_delimiter<>() << j.dump() << std::endl;
         }
     }
 }
 
+// parses each text in corpus once for each set of MeCab options and keeps the results in context.
+// results are also saved next to corpus, and reused in later runs with the same options and dictionaries if save_analysis is true
+std::vector<std::shared_ptr<MeCabAnalyzer>> analyze_corpus(const std::string corpus_path,
+        const std::set<std::string>& mecab_options_set, size_t text_col,
+        std::shared_ptr<StringNormalizer> normalize, bool save_analysis, AnalysisContext& context)
+{
+    constexpr auto delimiter = column_delimiter<typename string_type::value_type>();
+    std::vector<string_type> texts;
+    std::ifstream ifs(corpus_path);
+    if(ifs.fail()){
+        throw std::runtime_error("input file is not available: " + corpus_path);
+    }
+    while(ifs.good()){
+        std::string raw_line;
+        std::getline(ifs, raw_line);
+        if(ifs.eof() || raw_line.length() == 0){
+            break;
+        }
+        auto columns = split(cast_string<string_type>(raw_line), delimiter);
+        if(text_col > columns.size()){
+            continue;
+        }
+        const auto& original = columns[text_col - 1];
+        texts.push_back(normalize != nullptr ? (*normalize)(original) : original);
+    }
+
+    std::vector<std::shared_ptr<MeCabAnalyzer>> analyzers;
+    for(const auto& mecab_options: mecab_options_set){
+        auto analyzer = MeCabAnalyzer::get(mecab_options);
+        analyzers.push_back(analyzer);
+        auto analysis_path = analysis_path_from_mecab_options(corpus_path, mecab_options);
+
+        AnalysisContext saved;
+        if(save_analysis){
+            std::ifstream saved_ifs(analysis_path, std::ios::binary);
+            std::string saved_options, saved_dictionary;
+            if(std::getline(saved_ifs, saved_options) && saved_options == mecab_options &&
+                    std::getline(saved_ifs, saved_dictionary)){
+                if(saved_dictionary != analyzer->dictionaryInfo()){
+                    std::cerr << "warning: ignored " << analysis_path << ": dictionary was changed" << std::endl;
+                }
+                else{
+                    try{
+                        saved.load(analyzer.get(), saved_ifs);
+                    }
+                    catch(const std::exception& e){
+                        std::cerr << "warning: ignored " << analysis_path << ": " << e.what() << std::endl;
+                    }
+                }
+            }
+        }
+
+        size_t parsed = 0;
+        for(const auto& text: texts){
+            context.get(analyzer.get(), text, [&](){
+                return *saved.get(analyzer.get(), text, [&](){
+                    ++parsed;
+                    return *(*analyzer)(text);
+                });
+            });
+        }
+        std::cerr << "parsed " << parsed << " of " << texts.size() << " texts: mecab_options=" << mecab_options << std::endl;
+
+        if(save_analysis){
+            std::ofstream ofs(analysis_path, std::ios::binary);
+            ofs << mecab_options << '\n' << analyzer->dictionaryInfo() << '\n';
+            context.save(analyzer.get(), ofs);
+            std::cerr << "analysis saved to " << analysis_path << std::endl;
+        }
+    }
+    return analyzers;
+}
+
 int main(int argc, char* argv[])
 {
     init_locale();
@@ -152,6 +228,7 @@ int main(int argc, char* argv[])
         {"wred_similar_letter_cost", 1L, {"weighted_romaji_edit_distance", "similar_letter_cost"}, "wred-similar-letter-cost", 0, "cost to replace similar letters for weighted romaji edit distance"},
         {"wred_mismatch_cost_path", "", {"weighted_romaji_edit_distance", "mismatch_cost_path"}, "wred-mismatch-cost-path", 0, "costs to replace similar letters for weighted romaji edit distance"},
         {"km_simstring_ngram_unit", -1, {"keyword_match", "simstring_ngram_unit"}, "km-simstring-ngram-unit", 0, "Unit of N-gram for input text"},
+        {"index_save_analysis", true, {"index", "save_analysis"}, "index-save-analysis", 0, "save morphological analyses of corpus and reuse them in later runs"},
         {"svr_simstring_ngram_unit", -1, {"svr", "simstring_ngram_unit"}, "svr-simstring-ngram-unit", 0, "Unit of N-gram for romaji notation of input text"},
         {"svr_features_path", "features.tsv", {"svr", "features_path"}, "svr-features-path", 0, "feature definition file for support vector regression"},
         {"svr_patterns_home", ".", {"svr", "patterns_home"}, "svr-patterns-home", 0, "directory for pattern files for regular expression-based feature extractors"},
@@ -200,6 +277,8 @@ int main(int argc, char* argv[])
             std::cerr << "    corpus_path=" << corpus_path << std::endl;
             std::cerr << "    text_col=" << pm.get<int>("text_col") << std::endl;
             std::cerr << "    features_col=" << pm.get<int>("features_col") << std::endl;
+            std::cerr << "  Index:" << std::endl;
+            std::cerr << "    save_analysis=" << (pm.get<bool>("index_save_analysis") ? "true" : "false") << std::endl;
             std::cerr << "  SimString:" << std::endl;
             std::cerr << "    ngram_unit=" << pm.get<int>("simstring_ngram_unit") << std::endl;
             if(pm.get<bool>("normalize_text")){
@@ -259,6 +338,28 @@ int main(int argc, char* argv[])
                 pm.get<std::string>("icu_transliteration_path"),
                 pm.get<bool>("icu_to_lower"));
         }
+
+        // analyze corpus once for each dictionary, then all measures read the results from the context
+        std::set<std::string> mecab_options_set;
+        for(auto resembla_measure: resembla_measures){
+            if(resembla_measure == weighted_word_edit_distance){
+                mecab_options_set.insert(pm.get<std::string>("wwed_mecab_options"));
+            }
+            else if(resembla_measure == weighted_pronunciation_edit_distance){
+                mecab_options_set.insert(pm.get<std::string>("wped_mecab_options"));
+            }
+            else if(resembla_measure == weighted_romaji_edit_distance){
+                mecab_options_set.insert(pm.get<std::string>("wred_mecab_options"));
+            }
+            else if(resembla_measure == svr){
+                mecab_options_set.insert(pm.get<std::string>("index_romaji_mecab_options"));
+            }
+        }
+        auto context = std::make_shared<AnalysisContext>();
+        auto analyzers = analyze_corpus(corpus_path, mecab_options_set, pm.get<int>("text_col"),
+                normalize, pm.get<bool>("index_save_analysis"), *context);
+        AnalysisContext::Scope scope(context);
+
         for(auto resembla_measure: resembla_measures){
             std::string db_path = db_path_from_resembla_measure(corpus_path, resembla_measure);
             std::string inverse_path = inverse_path_from_resembla_measure(corpus_path, resembla_measure);
@@ -312,7 +413,7 @@ int main(int argc, char* argv[])
                 }
                 const auto& base_feature = features[0][0];
 
-                FeatureExtractor extractor;
+                FeatureExtractor extractor(std::make_shared<const FeatureSchema>(features));
                 for(const auto& feature: features){
                     const auto& name = feature[0];
                     if(name == base_feature){
@@ -0,0 +1,102 @@
+/*
+Resembla: Word-based Japanese similar sentence search library
+https://github.com/tuem/resembla
+
+Copyright 2017 Takashi Uemura
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "executor.hpp"
+
+#include "thread_affinity.hpp"
+
+namespace resembla {
+
+Executor::Executor(size_t num_threads, size_t max_queue_size, const std::vector<size_t>& cpus):
+    max_queue_size(max_queue_size), stopped(false)
+{
+    if(num_threads == 0){
+        num_threads = 1;
+    }
+    for(size_t i = 0; i < num_threads; ++i){
+        workers.emplace_back(&Executor::work, this);
+        if(!cpus.empty()){
+            set_thread_affinity(workers.back(), cpus[i % cpus.size()]);
+        }
+    }
+}
+
+Executor::~Executor()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopped = true;
+    }
+    not_empty.notify_all();
+    for(auto& worker: workers){
+        worker.join();
+    }
+}
+
+size_t Executor::size() const
+{
+    return workers.size();
+}
+
+bool Executor::trySubmit(task_type task)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if(max_queue_size > 0 && tasks.size() >= max_queue_size){
+            return false;
+        }
+        tasks.push_back(std::move(task));
+    }
+    not_empty.notify_one();
+    return true;
+}
+
+void Executor::submit(task_type task)
+{
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        not_full.wait(lock, [this](){
+            return max_queue_size == 0 || tasks.size() < max_queue_size;
+        });
+        tasks.push_back(std::move(task));
+    }
+    not_empty.notify_one();
+}
+
+void Executor::work()
+{
+    while(true){
+        task_type task;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            not_empty.wait(lock, [this](){
+                return stopped || !tasks.empty();
+            });
+            if(tasks.empty()){
+                break;
+            }
+            task = std::move(tasks.front());
+            tasks.pop_front();
+        }
+        not_full.notify_one();
+        task();
+    }
+}
+
+}
@@ -0,0 +1,68 @@
+/*
+Resembla: Word-based Japanese similar sentence search library
+https://github.com/tuem/resembla
+
+Copyright 2017 Takashi Uemura
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef RESEMBLA_EXECUTOR_HPP
+#define RESEMBLA_EXECUTOR_HPP
+
+#include <vector>
+#include <deque>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+namespace resembla {
+
+// fixed number of threads processing tasks in FIFO order from a bounded queue
+class Executor final
+{
+public:
+    using task_type = std::function<void()>;
+
+    // max_queue_size == 0 means unbounded. if cpus is not empty, i-th thread is bound to cpus[i % cpus.size()]
+    Executor(size_t num_threads, size_t max_queue_size = 0, const std::vector<size_t>& cpus = {});
+    // waits for all queued tasks
+    ~Executor();
+
+    Executor(const Executor&) = delete;
+    Executor& operator=(const Executor&) = delete;
+
+    size_t size() const;
+
+    // enqueues a task and returns true, or returns false immediately if the queue is full. tasks must not throw
+    bool trySubmit(task_type task);
+    // enqueues a task, waiting while the queue is full
+    void submit(task_type task);
+
+protected:
+    const size_t max_queue_size;
+
+    std::deque<task_type> tasks;
+    std::vector<std::thread> workers;
+    bool stopped;
+
+    std::mutex mutex;
+    std::condition_variable not_empty;
+    std::condition_variable not_full;
+
+    void work();
+};
+
+}
+#endif
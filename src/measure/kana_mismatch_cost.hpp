@@ -41,23 +41,23 @@ struct KanaMismatchCost
             return;
         }
 
-        std::basic_ifstream<value_type> ifs(letter_similarity_file_path);
+        std::ifstream ifs(letter_similarity_file_path);
         if(ifs.fail()){
             throw std::runtime_error("input file is not available: " + letter_similarity_file_path);
         }
 
         while(ifs.good()){
-            string_type line;
+            std::string line;
             std::getline(ifs, line);
             if(ifs.eof() || line.length() == 0){
                 break;
             }
 
-            auto columns = split(line, column_delimiter<value_type>());
+            auto columns = split(line, column_delimiter<>());
             if(columns.size() < 2){
-                throw std::runtime_error("invalid line in " + letter_similarity_file_path + ": " + cast_string<std::string>(line));
+                throw std::runtime_error("invalid line in " + letter_similarity_file_path + ": " + line);
             }
-            auto letters= columns[0];
+            auto letters = cast_string<string_type>(columns[0]);
             auto cost = std::stod(columns[1]);
 
             std::sort(std::begin(letters), std::end(letters));
@@ -0,0 +1,520 @@
+/*
+Resembla: Word-based Japanese similar sentence search library
+https://github.com/tuem/resembla
+
+Copyright 2017 Takashi Uemura
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <stdexcept>
+
+#include "kana_table.hpp"
+
+namespace resembla {
+
+constexpr char32_t KanaTable::KANA_BEGIN;
+constexpr char32_t KanaTable::KANA_END;
+constexpr char32_t KanaTable::KATAKANA_BEGIN;
+constexpr char32_t KanaTable::KATAKANA_END;
+constexpr size_t KanaTable::KANA_SIZE;
+constexpr size_t KanaTable::KATAKANA_SIZE;
+constexpr size_t KanaTable::MAX_LENGTH;
+
+const KanaTable::Mapping KanaTable::KATAKANA_MAPPINGS[] = {
+    {U"ぁ", U"ァ"},
+    {U"あ", U"ア"},
+    {U"ぃ", U"ィ"},
+    {U"い", U"イ"},
+    {U"ぅ", U"ゥ"},
+    {U"う", U"ウ"},
+    {U"ぇ", U"ェ"},
+    {U"え", U"エ"},
+    {U"ぉ", U"ォ"},
+    {U"お", U"オ"},
+    {U"か", U"カ"},
+    {U"が", U"ガ"},
+    {U"き", U"キ"},
+    {U"ぎ", U"ギ"},
+    {U"く", U"ク"},
+    {U"ぐ", U"グ"},
+    {U"け", U"ケ"},
+    {U"げ", U"ゲ"},
+    {U"こ", U"コ"},
+    {U"ご", U"ゴ"},
+    {U"さ", U"サ"},
+    {U"ざ", U"ザ"},
+    {U"し", U"シ"},
+    {U"じ", U"ジ"},
+    {U"す", U"ス"},
+    {U"ず", U"ズ"},
+    {U"せ", U"セ"},
+    {U"ぜ", U"ゼ"},
+    {U"そ", U"ソ"},
+    {U"ぞ", U"ゾ"},
+    {U"た", U"タ"},
+    {U"だ", U"ダ"},
+    {U"ち", U"チ"},
+    {U"ぢ", U"ヂ"},
+    {U"っ", U"ッ"},
+    {U"つ", U"ツ"},
+    {U"づ", U"ヅ"},
+    {U"て", U"テ"},
+    {U"で", U"デ"},
+    {U"と", U"ト"},
+    {U"ど", U"ド"},
+    {U"な", U"ナ"},
+    {U"に", U"ニ"},
+    {U"ぬ", U"ヌ"},
+    {U"ね", U"ネ"},
+    {U"の", U"ノ"},
+    {U"は", U"ハ"},
+    {U"ば", U"バ"},
+    {U"ぱ", U"パ"},
+    {U"ひ", U"ヒ"},
+    {U"び", U"ビ"},
+    {U"ぴ", U"ピ"},
+    {U"ふ", U"フ"},
+    {U"ぶ", U"ブ"},
+    {U"ぷ", U"プ"},
+    {U"へ", U"ヘ"},
+    {U"べ", U"ベ"},
+    {U"ぺ", U"ペ"},
+    {U"ほ", U"ホ"},
+    {U"ぼ", U"ボ"},
+    {U"ぽ", U"ポ"},
+    {U"ま", U"マ"},
+    {U"み", U"ミ"},
+    {U"む", U"ム"},
+    {U"め", U"メ"},
+    {U"も", U"モ"},
+    {U"ゃ", U"ャ"},
+    {U"や", U"ヤ"},
+    {U"ゅ", U"ュ"},
+    {U"ゆ", U"ユ"},
+    {U"ょ", U"ョ"},
+    {U"よ", U"ヨ"},
+    {U"ら", U"ラ"},
+    {U"り", U"リ"},
+    {U"る", U"ル"},
+    {U"れ", U"レ"},
+    {U"ろ", U"ロ"},
+    {U"ゎ", U"ヮ"},
+    {U"わ", U"ワ"},
+    {U"ゐ", U"イ"},
+    {U"ゑ", U"エ"},
+    {U"を", U"ヲ"},
+    {U"ん", U"ン"},
+    {U"ゔ", U"ヴ"},
+    {U"ゕ", U"ヵ"},
+    {U"ゖ", U"ヶ"},
+    {U"ゟ", U"ヨリ"},
+    {U"ゝ", U"ヽ"},
+    {U"ゞ", U"ヾ"},
+    {U"ァ", U"ァ"},
+    {U"ア", U"ア"},
+    {U"ィ", U"ィ"},
+    {U"イ", U"イ"},
+    {U"ゥ", U"ゥ"},
+    {U"ウ", U"ウ"},
+    {U"ェ", U"ェ"},
+    {U"エ", U"エ"},
+    {U"ォ", U"ォ"},
+    {U"オ", U"オ"},
+    {U"カ", U"カ"},
+    {U"ガ", U"ガ"},
+    {U"キ", U"キ"},
+    {U"ギ", U"ギ"},
+    {U"ク", U"ク"},
+    {U"グ", U"グ"},
+    {U"ケ", U"ケ"},
+    {U"ゲ", U"ゲ"},
+    {U"コ", U"コ"},
+    {U"ゴ", U"ゴ"},
+    {U"サ", U"サ"},
+    {U"ザ", U"ザ"},
+    {U"シ", U"シ"},
+    {U"ジ", U"ジ"},
+    {U"ス", U"ス"},
+    {U"ズ", U"ズ"},
+    {U"セ", U"セ"},
+    {U"ゼ", U"ゼ"},
+    {U"ソ", U"ソ"},
+    {U"ゾ", U"ゾ"},
+    {U"タ", U"タ"},
+    {U"ダ", U"ダ"},
+    {U"チ", U"チ"},
+    {U"ヂ", U"ヂ"},
+    {U"ッ", U"ッ"},
+    {U"ツ", U"ツ"},
+    {U"ヅ", U"ヅ"},
+    {U"テ", U"テ"},
+    {U"デ", U"デ"},
+    {U"ト", U"ト"},
+    {U"ド", U"ド"},
+    {U"ナ", U"ナ"},
+    {U"ニ", U"ニ"},
+    {U"ヌ", U"ヌ"},
+    {U"ネ", U"ネ"},
+    {U"ノ", U"ノ"},
+    {U"ハ", U"ハ"},
+    {U"バ", U"バ"},
+    {U"パ", U"パ"},
+    {U"ヒ", U"ヒ"},
+    {U"ビ", U"ビ"},
+    {U"ピ", U"ピ"},
+    {U"フ", U"フ"},
+    {U"ブ", U"ブ"},
+    {U"プ", U"プ"},
+    {U"ヘ", U"ヘ"},
+    {U"ベ", U"ベ"},
+    {U"ペ", U"ペ"},
+    {U"ホ", U"ホ"},
+    {U"ボ", U"ボ"},
+    {U"ポ", U"ポ"},
+    {U"マ", U"マ"},
+    {U"ミ", U"ミ"},
+    {U"ム", U"ム"},
+    {U"メ", U"メ"},
+    {U"モ", U"モ"},
+    {U"ャ", U"ャ"},
+    {U"ヤ", U"ヤ"},
+    {U"ュ", U"ュ"},
+    {U"ユ", U"ユ"},
+    {U"ョ", U"ョ"},
+    {U"ヨ", U"ヨ"},
+    {U"ラ", U"ラ"},
+    {U"リ", U"リ"},
+    {U"ル", U"ル"},
+    {U"レ", U"レ"},
+    {U"ロ", U"ロ"},
+    {U"ヮ", U"ヮ"},
+    {U"ワ", U"ワ"},
+    {U"ヰ", U"イ"},
+    {U"ヱ", U"エ"},
+    {U"ヲ", U"ヲ"},
+    {U"ン", U"ン"},
+    {U"ヴ", U"ヴ"},
+    {U"ヵ", U"ヵ"},
+    {U"ヶ", U"ヶ"},
+    {U"ヿ", U"コト"},
+};
+const size_t KanaTable::KATAKANA_MAPPINGS_SIZE = sizeof(KATAKANA_MAPPINGS) / sizeof(KATAKANA_MAPPINGS[0]);
+
+const KanaTable::Mapping KanaTable::ROMAJI_MAPPINGS[] = {
+    {U"ァ", U"a"},
+    {U"ア", U"A"},
+    {U"ィ", U"i"},
+    {U"イ", U"I"},
+    {U"ゥ", U"u"},
+    {U"ウ", U"U"},
+    {U"ェ", U"e"},
+    {U"エ", U"E"},
+    {U"ォ", U"o"},
+    {U"オ", U"O"},
+    {U"カ", U"KA"},
+    {U"ガ", U"GA"},
+    {U"キ", U"KI"},
+    {U"ギ", U"GI"},
+    {U"ク", U"KU"},
+    {U"グ", U"GU"},
+    {U"ケ", U"KE"},
+    {U"ゲ", U"GE"},
+    {U"コ", U"KO"},
+    {U"ゴ", U"GO"},
+    {U"サ", U"SA"},
+    {U"ザ", U"ZA"},
+    {U"シ", U"SI"},
+    {U"ジ", U"ZI"},
+    {U"ス", U"SU"},
+    {U"ズ", U"ZU"},
+    {U"セ", U"SE"},
+    {U"ゼ", U"ZE"},
+    {U"ソ", U"SO"},
+    {U"ゾ", U"ZO"},
+    {U"タ", U"TA"},
+    {U"ダ", U"DA"},
+    {U"チ", U"TI"},
+    {U"ヂ", U"DI"},
+    {U"ッ", U"tu"},
+    {U"ツ", U"TU"},
+    {U"ヅ", U"DU"},
+    {U"テ", U"TE"},
+    {U"デ", U"DE"},
+    {U"ト", U"TO"},
+    {U"ド", U"DO"},
+    {U"ナ", U"NA"},
+    {U"ニ", U"NI"},
+    {U"ヌ", U"NU"},
+    {U"ネ", U"NE"},
+    {U"ノ", U"NO"},
+    {U"ハ", U"HA"},
+    {U"バ", U"BA"},
+    {U"パ", U"PA"},
+    {U"ヒ", U"HI"},
+    {U"ビ", U"BI"},
+    {U"ピ", U"PI"},
+    {U"フ", U"HU"},
+    {U"ブ", U"BU"},
+    {U"プ", U"PU"},
+    {U"ヘ", U"HE"},
+    {U"ベ", U"BE"},
+    {U"ペ", U"PE"},
+    {U"ホ", U"HO"},
+    {U"ボ", U"BO"},
+    {U"ポ", U"PO"},
+    {U"マ", U"MA"},
+    {U"ミ", U"MI"},
+    {U"ム", U"MU"},
+    {U"メ", U"ME"},
+    {U"モ", U"MO"},
+    {U"ャ", U"ya"},
+    {U"ヤ", U"YA"},
+    {U"ュ", U"yu"},
+    {U"ユ", U"YU"},
+    {U"ョ", U"yo"},
+    {U"ヨ", U"YO"},
+    {U"ラ", U"RA"},
+    {U"リ", U"RI"},
+    {U"ル", U"RU"},
+    {U"レ", U"RE"},
+    {U"ロ", U"RO"},
+    {U"ヮ", U"wa"},
+    {U"ワ", U"WA"},
+    {U"ヲ", U"WO"},
+    {U"ン", U"n"},
+    {U"ヴァ", U"VA"},
+    {U"ヴィ", U"VI"},
+    {U"ヴ", U"VU"},
+    {U"ヴェ", U"VE"},
+    {U"ヴォ", U"VO"},
+    {U"ヵ", U"ka"},
+    {U"ヶ", U"ke"},
+    {U"ー", U"-"},
+    {U"キャ", U"Kya"},
+    {U"ギャ", U"Gya"},
+    {U"キュ", U"Kyu"},
+    {U"ギュ", U"Gyu"},
+    {U"キョ", U"Kyo"},
+    {U"ギョ", U"Gyo"},
+    {U"シャ", U"Sya"},
+    {U"ジャ", U"Zya"},
+    {U"シュ", U"Syu"},
+    {U"ジュ", U"Zyu"},
+    {U"ショ", U"Syo"},
+    {U"ジョ", U"Zyo"},
+    {U"チャ", U"Tya"},
+    {U"ヂャ", U"Dya"},
+    {U"チュ", U"Tyu"},
+    {U"ヂュ", U"Dyu"},
+    {U"チョ", U"Tyo"},
+    {U"ヂョ", U"Dyo"},
+    {U"ニャ", U"Nya"},
+    {U"ニュ", U"Nyu"},
+    {U"ニョ", U"Nyo"},
+    {U"ヒャ", U"Hya"},
+    {U"ビャ", U"Bya"},
+    {U"ピャ", U"Pya"},
+    {U"ヒュ", U"Hyu"},
+    {U"ビュ", U"Byu"},
+    {U"ピュ", U"Pyu"},
+    {U"ヒョ", U"Hyo"},
+    {U"ビョ", U"Byo"},
+    {U"ピョ", U"Pyo"},
+    {U"ミャ", U"Mya"},
+    {U"ミュ", U"Myu"},
+    {U"ミョ", U"Myo"},
+    {U"リャ", U"Rya"},
+    {U"リュ", U"Ryu"},
+    {U"リョ", U"Ryo"},
+    {U"クヮ", U"Kwa"},
+    {U"グヮ", U"Gwa"},
+    {U"ウィ", U"ui"},
+    {U"ウェ", U"ue"},
+    {U"ウォ", U"uo"},
+    {U"チェ", U"Tie"},
+    {U"ティ", U"Tei"},
+    {U"ファ", U"Hua"},
+    {U"フィ", U"Hui"},
+    {U"フェ", U"Hue"},
+    {U"フォ", U"Huo"},
+    {U"ッカ", U"kKA"},
+    {U"ッガ", U"gGA"},
+    {U"ッキ", U"kKI"},
+    {U"ッギ", U"gGI"},
+    {U"ック", U"kKU"},
+    {U"ッグ", U"gGU"},
+    {U"ッケ", U"kKE"},
+    {U"ッゲ", U"gGE"},
+    {U"ッコ", U"kKO"},
+    {U"ッゴ", U"gGO"},
+    {U"ッサ", U"sSA"},
+    {U"ッザ", U"zZA"},
+    {U"ッシ", U"sSI"},
+    {U"ッジ", U"zZI"},
+    {U"ッス", U"sSU"},
+    {U"ッズ", U"zZU"},
+    {U"ッセ", U"sSE"},
+    {U"ッゼ", U"zZE"},
+    {U"ッソ", U"sSO"},
+    {U"ッゾ", U"zZO"},
+    {U"ッタ", U"tTA"},
+    {U"ッダ", U"dDA"},
+    {U"ッチ", U"tTI"},
+    {U"ッヂ", U"dDI"},
+    {U"ッツ", U"tTU"},
+    {U"ッヅ", U"dDU"},
+    {U"ッテ", U"tTE"},
+    {U"ッデ", U"dDE"},
+    {U"ット", U"tTO"},
+    {U"ッド", U"dDO"},
+    {U"ッナ", U"nNA"},
+    {U"ッニ", U"nNI"},
+    {U"ッヌ", U"nNU"},
+    {U"ッネ", U"nNE"},
+    {U"ッノ", U"nNO"},
+    {U"ッハ", U"hHA"},
+    {U"ッバ", U"bBA"},
+    {U"ッパ", U"pPA"},
+    {U"ッヒ", U"hHI"},
+    {U"ッビ", U"bBI"},
+    {U"ッピ", U"pPI"},
+    {U"ッフ", U"hHU"},
+    {U"ッブ", U"bBU"},
+    {U"ップ", U"pPU"},
+    {U"ッヘ", U"hHE"},
+    {U"ッベ", U"bBE"},
+    {U"ッペ", U"pPE"},
+    {U"ッホ", U"hHO"},
+    {U"ッボ", U"bBO"},
+    {U"ッポ", U"pPO"},
+    {U"ッマ", U"mMA"},
+    {U"ッミ", U"mMI"},
+    {U"ッム", U"mMU"},
+    {U"ッメ", U"mME"},
+    {U"ッモ", U"mMO"},
+    {U"ッヤ", U"yYA"},
+    {U"ッユ", U"yYU"},
+    {U"ッヨ", U"yYO"},
+    {U"ッラ", U"rRA"},
+    {U"ッリ", U"rRI"},
+    {U"ッル", U"rRU"},
+    {U"ッレ", U"rRE"},
+    {U"ッロ", U"rRO"},
+    {U"ッワ", U"wWA"},
+    {U"ッヲ", U"wWO"},
+    {U"ッヴ", U"vVU"},
+};
+const size_t KanaTable::ROMAJI_MAPPINGS_SIZE = sizeof(ROMAJI_MAPPINGS) / sizeof(ROMAJI_MAPPINGS[0]);
+
+// small tsu doubles the consonant of the following letter
+constexpr char32_t SOKUON = 0x30c3;
+
+KanaTable::KanaTable(): katakana(), romaji(), pair_row()
+{
+    for(size_t i = 0; i < KATAKANA_MAPPINGS_SIZE; ++i){
+        const auto& m = KATAKANA_MAPPINGS[i];
+        if(m.from[0] == 0 || m.from[1] != 0 || !inRange(m.from[0], KANA_BEGIN, KANA_END)){
+            throw std::invalid_argument("katakana mapping must start from a kana letter");
+        }
+        setEntry(katakana[m.from[0] - KANA_BEGIN], m.to);
+    }
+
+    for(size_t i = 0; i < ROMAJI_MAPPINGS_SIZE; ++i){
+        const auto& m = ROMAJI_MAPPINGS[i];
+        if(m.from[0] == 0 || !inRange(m.from[0], KATAKANA_BEGIN, KATAKANA_END)){
+            throw std::invalid_argument("romaji mapping must start from a katakana letter");
+        }
+        if(m.from[1] == 0){
+            setEntry(romaji[m.from[0] - KATAKANA_BEGIN], m.to);
+        }
+        else if(m.from[2] == 0 && inRange(m.from[1], KATAKANA_BEGIN, KATAKANA_END)){
+            auto& row = pair_row[m.from[0] - KATAKANA_BEGIN];
+            if(row == 0){
+                pair_romaji.emplace_back();
+                row = static_cast<unsigned char>(pair_romaji.size());
+            }
+            setEntry(pair_romaji[row - 1][m.from[1] - KATAKANA_BEGIN], m.to);
+        }
+        else{
+            throw std::invalid_argument("romaji mapping must be from one or two katakana letters");
+        }
+    }
+}
+
+const KanaTable& KanaTable::get()
+{
+    static const KanaTable table;
+    return table;
+}
+
+void KanaTable::setEntry(Entry& entry, const char32_t* letters)
+{
+    size_t length = 0;
+    for(; letters[length] != 0; ++length){
+        if(length == MAX_LENGTH){
+            throw std::invalid_argument("too long kana mapping");
+        }
+        entry.letters[length] = static_cast<token_type>(letters[length]);
+    }
+    entry.length = static_cast<unsigned char>(length);
+}
+
+void KanaTable::appendKatakana(token_type c, string_type& output) const
+{
+    if(isKana(c)){
+        append(katakana[c - KANA_BEGIN], output);
+    }
+    else{
+        output.push_back(c);
+    }
+}
+
+void KanaTable::appendRomaji(const string_type& pronunciation, string_type& output) const
+{
+    output.reserve(output.size() + pronunciation.size() * MAX_LENGTH);
+    for(size_t i = 0; i < pronunciation.size(); ++i){
+        const auto c = pronunciation[i];
+        if(!inRange(c, KATAKANA_BEGIN, KATAKANA_END)){
+            output.push_back(c);
+            continue;
+        }
+
+        // try to read-ahead next letter
+        const auto row = pair_row[c - KATAKANA_BEGIN];
+        if(row > 0 && i + 1 < pronunciation.size() && inRange(pronunciation[i + 1], KATAKANA_BEGIN, KATAKANA_END)){
+            const auto& pair = pair_romaji[row - 1][pronunciation[i + 1] - KATAKANA_BEGIN];
+            if(pair.length > 0){
+                if(static_cast<char32_t>(c) == SOKUON){
+                    // only process the first letter 'ッ' because next letters may be able to concatenate
+                    output.push_back(pair.letters[0]);
+                }
+                else{
+                    append(pair, output);
+                    ++i;
+                }
+                continue;
+            }
+        }
+
+        const auto& single = romaji[c - KATAKANA_BEGIN];
+        if(single.length > 0){
+            append(single, output);
+        }
+        else{
+            output.push_back(c);
+        }
+    }
+}
+
+}
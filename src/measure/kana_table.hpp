@@ -0,0 +1,101 @@
+/*
+Resembla: Word-based Japanese similar sentence search library
+https://github.com/tuem/resembla
+
+Copyright 2017 Takashi Uemura
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef RESEMBLA_KANA_TABLE_HPP
+#define RESEMBLA_KANA_TABLE_HPP
+
+#include <array>
+#include <string>
+#include <vector>
+
+#include "../string_util.hpp"
+
+namespace resembla {
+
+// lookup tables over the hiragana and katakana blocks, indexed directly by code point
+class KanaTable
+{
+public:
+    using token_type = string_type::value_type;
+
+    struct Mapping
+    {
+        const char32_t* from;
+        const char32_t* to;
+    };
+
+    // kana to katakana used as pronunciation
+    static const Mapping KATAKANA_MAPPINGS[];
+    static const size_t KATAKANA_MAPPINGS_SIZE;
+
+    // katakana and pairs of katakana to romaji
+    static const Mapping ROMAJI_MAPPINGS[];
+    static const size_t ROMAJI_MAPPINGS_SIZE;
+
+    static const KanaTable& get();
+
+    bool isKana(token_type c) const
+    {
+        return inRange(c, KANA_BEGIN, KANA_END) && katakana[c - KANA_BEGIN].length > 0;
+    }
+
+    // append katakana for c, or c itself if it is not kana
+    void appendKatakana(token_type c, string_type& output) const;
+
+    // convert katakana sequence to romaji with one letter lookahead
+    void appendRomaji(const string_type& pronunciation, string_type& output) const;
+
+protected:
+    static constexpr char32_t KANA_BEGIN = 0x3040;
+    static constexpr char32_t KANA_END = 0x3100;
+    static constexpr char32_t KATAKANA_BEGIN = 0x30a0;
+    static constexpr char32_t KATAKANA_END = 0x3100;
+    static constexpr size_t KANA_SIZE = KANA_END - KANA_BEGIN;
+    static constexpr size_t KATAKANA_SIZE = KATAKANA_END - KATAKANA_BEGIN;
+    static constexpr size_t MAX_LENGTH = 3;
+
+    struct Entry
+    {
+        token_type letters[MAX_LENGTH];
+        unsigned char length;
+    };
+
+    Entry katakana[KANA_SIZE];
+    Entry romaji[KATAKANA_SIZE];
+    // row of pair_romaji for each first letter, 0 if no pair starts with it
+    unsigned char pair_row[KATAKANA_SIZE];
+    std::vector<std::array<Entry, KATAKANA_SIZE>> pair_romaji;
+
+    KanaTable();
+
+    static void setEntry(Entry& entry, const char32_t* letters);
+
+    static bool inRange(char32_t c, char32_t begin, char32_t end)
+    {
+        return begin <= static_cast<char32_t>(c) && static_cast<char32_t>(c) < end;
+    }
+
+    static void append(const Entry& entry, string_type& output)
+    {
+        output.append(entry.letters, entry.length);
+    }
+};
+
+}
+#endif
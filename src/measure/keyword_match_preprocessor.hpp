@@ -55,7 +55,7 @@ public:
         if(columns.size() > 1){
             for(auto f: split(columns[1], feature_delimiter<typename string_type::value_type>())){
                 auto kv = split(f, keyvalue_delimiter<typename string_type::value_type>());
-                if(kv.size() == 2 && kv[0] == L"keyword"){
+                if(kv.size() == 2 && kv[0] == RESEMBLA_TEXT("keyword")){
 #ifdef DEBUG
                     for(auto w: split(kv[1], value_delimiter<typename string_type::value_type>())){
                         std::cerr << "load keyword: text=" << cast_string<std::string>(columns[0]) << ", keyword=" << cast_string<std::string>(w) << std::endl;
@@ -42,24 +42,24 @@ struct LetterWeight
             return;
         }
 
-        std::basic_ifstream<value_type> ifs(letter_weight_file_path);
+        std::ifstream ifs(letter_weight_file_path);
         if(ifs.fail()){
             throw std::runtime_error("input file is not available: " + letter_weight_file_path);
         }
 
         while(ifs.good()){
-            string_type line;
+            std::string line;
             std::getline(ifs, line);
             if(ifs.eof() || line.length() == 0){
                 break;
             }
 
-            auto columns = split(line, column_delimiter<value_type>());
+            auto columns = split(line, column_delimiter<>());
             if(columns.size() < 2){
-                throw std::runtime_error("invalid line in " + letter_weight_file_path + ": " + cast_string<std::string>(line));
+                throw std::runtime_error("invalid line in " + letter_weight_file_path + ": " + line);
             }
 
-            auto letters= columns[0];
+            auto letters = cast_string<string_type>(columns[0]);
             auto weight = std::stod(columns[1]);
             for(size_t i = 0; i < letters.size(); ++i){
                 letter_weights[letters[i]] = weight;
@@ -0,0 +1,122 @@
+/*
+Resembla: Word-based Japanese similar sentence search library
+https://github.com/tuem/resembla
+
+Copyright 2017 Takashi Uemura
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "mecab_analyzer.hpp"
+
+#include <map>
+#include <stdexcept>
+
+namespace resembla {
+
+std::shared_ptr<MeCabAnalyzer> MeCabAnalyzer::get(const std::string& mecab_options)
+{
+    static std::mutex mutex_analyzers;
+    static std::map<std::string, std::weak_ptr<MeCabAnalyzer>> analyzers;
+
+    std::lock_guard<std::mutex> lock(mutex_analyzers);
+    auto analyzer = analyzers[mecab_options].lock();
+    if(analyzer == nullptr){
+        analyzer = std::make_shared<MeCabAnalyzer>(mecab_options);
+        analyzers[mecab_options] = analyzer;
+    }
+    return analyzer;
+}
+
+MeCabAnalyzer::MeCabAnalyzer(const std::string& mecab_options): model(MeCab::createModel(mecab_options.c_str()))
+{
+    if(model == nullptr){
+        throw std::runtime_error("failed to create MeCab model: options=" + mecab_options);
+    }
+    tagger.reset(model->createTagger());
+    if(tagger == nullptr){
+        throw std::runtime_error("failed to create MeCab tagger: options=" + mecab_options);
+    }
+}
+
+std::shared_ptr<const MeCabAnalyzer::output_type> MeCabAnalyzer::operator()(const string_type& text) const
+{
+    auto context = AnalysisContext::current();
+    if(context == nullptr){
+        return std::make_shared<const output_type>(parse(text));
+    }
+    return context->get(this, text, [this, &text](){
+        return parse(text);
+    });
+}
+
+std::string MeCabAnalyzer::dictionaryInfo() const
+{
+    std::string info;
+    for(auto d = model->dictionary_info(); d != nullptr; d = d->next){
+        info += std::string(d->filename) + "," + std::to_string(d->version) + "," + std::to_string(d->size) + ";";
+    }
+    return info;
+}
+
+std::unique_ptr<MeCab::Lattice> MeCabAnalyzer::acquireLattice() const
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_lattices);
+        if(!lattices.empty()){
+            auto lattice = std::move(lattices.back());
+            lattices.pop_back();
+            return lattice;
+        }
+    }
+    std::unique_ptr<MeCab::Lattice> lattice(model->createLattice());
+    if(lattice == nullptr){
+        throw std::runtime_error("failed to create MeCab lattice");
+    }
+    return lattice;
+}
+
+void MeCabAnalyzer::releaseLattice(std::unique_ptr<MeCab::Lattice> lattice) const
+{
+    std::lock_guard<std::mutex> lock(mutex_lattices);
+    lattices.push_back(std::move(lattice));
+}
+
+MeCabAnalyzer::output_type MeCabAnalyzer::parse(const string_type& text) const
+{
+    std::string text_string = cast_string<std::string>(text);
+    auto lattice = acquireLattice();
+    lattice->set_sentence(text_string.c_str(), text_string.size());
+    if(!tagger->parse(lattice.get())){
+        std::string message = lattice->what() != nullptr ? lattice->what() : "";
+        lattice->clear();
+        releaseLattice(std::move(lattice));
+        throw std::runtime_error("failed to parse text by MeCab: " + message);
+    }
+
+    output_type morphemes;
+    for(const MeCab::Node* node = lattice->bos_node(); node; node = node->next){
+        // skip BOS/EOS nodes
+        if(node->stat == MECAB_BOS_NODE || node->stat == MECAB_EOS_NODE){
+            continue;
+        }
+
+        // decode surface and keep features as is
+        morphemes.push_back({cast_string<string_type>(std::string(node->surface, node->surface + node->length)), node->feature});
+    }
+    lattice->clear();
+    releaseLattice(std::move(lattice));
+    return morphemes;
+}
+
+}
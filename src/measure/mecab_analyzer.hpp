@@ -0,0 +1,70 @@
+/*
+Resembla: Word-based Japanese similar sentence search library
+https://github.com/tuem/resembla
+
+Copyright 2017 Takashi Uemura
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef RESEMBLA_MECAB_ANALYZER_HPP
+#define RESEMBLA_MECAB_ANALYZER_HPP
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+
+#include <mecab.h>
+
+#include "../string_util.hpp"
+#include "../word.hpp"
+#include "../analysis_context.hpp"
+
+namespace resembla {
+
+// MeCab model shared by sequence builders with the same options.
+// texts are parsed concurrently using a lattice for each running parse
+class MeCabAnalyzer final
+{
+public:
+    using output_type = AnalysisContext::morphemes_type;
+
+    // returns the analyzer for mecab_options. analyzers are shared among callers with the same options
+    static std::shared_ptr<MeCabAnalyzer> get(const std::string& mecab_options);
+
+    MeCabAnalyzer(const std::string& mecab_options);
+
+    // parses text to morphemes without BOS/EOS nodes. features are kept as MeCab output to be read by FeatureView.
+    // if an AnalysisContext is active, results are shared in the context
+    std::shared_ptr<const output_type> operator()(const string_type& text) const;
+
+    // filenames, versions and sizes of dictionaries, which change results even with the same options
+    std::string dictionaryInfo() const;
+
+protected:
+    std::shared_ptr<MeCab::Model> model;
+    std::shared_ptr<MeCab::Tagger> tagger;
+
+    // lattices not used by any thread. the lock is held only to take or return a lattice
+    mutable std::vector<std::unique_ptr<MeCab::Lattice>> lattices;
+    mutable std::mutex mutex_lattices;
+
+    std::unique_ptr<MeCab::Lattice> acquireLattice() const;
+    void releaseLattice(std::unique_ptr<MeCab::Lattice> lattice) const;
+
+    output_type parse(const string_type& text) const;
+};
+
+}
+#endif
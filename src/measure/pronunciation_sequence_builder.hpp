@@ -22,12 +22,10 @@ limitations under the License.
 
 #include <memory>
 #include <string>
-#include <unordered_map>
-#include <mutex>
-
-#include <mecab.h>
 
 #include "../string_util.hpp"
+#include "kana_table.hpp"
+#include "mecab_analyzer.hpp"
 
 namespace resembla {
 
@@ -38,23 +36,19 @@ public:
     using output_type = string_type;
 
     PronunciationSequenceBuilder(const std::string mecab_options = "", const size_t mecab_feature_pos = 7, const std::string mecab_pronunciation_of_marks = "");
-    PronunciationSequenceBuilder(const PronunciationSequenceBuilder& obj);
     virtual ~PronunciationSequenceBuilder();
 
     output_type operator()(const string_type& text, bool is_original = false) const;
     string_type index(const string_type& text) const;
 
 protected:
-    static const std::unordered_map<token_type, string_type> KANA_MAP;
-
-    std::shared_ptr<MeCab::Tagger> tagger;
+    std::shared_ptr<MeCabAnalyzer> analyze;
+    const KanaTable& kana_table;
     const size_t mecab_feature_pos;
     string_type mecab_pronunciation_of_marks;
 
     bool isKanaWord(const string_type& w) const;
     string_type estimatePronunciation(const string_type& w) const;
-
-    mutable std::mutex mutex_tagger;
 };
 
 }
@@ -25,20 +25,20 @@ limitations under the License.
 namespace resembla {
 
 const std::unordered_set<string_type> RomajiMismatchCost::DEFAULT_SIMILAR_LETTER_PAIRS = {
-    L"bv",
-    L"ck",
-    L"cq",
-    L"kq",
-    L"cs",
-    L"fh",
-    L"lr",
-    L"jz",
-    L"xz",
-    L"-a",
-    L"-i",
-    L"-u",
-    L"-e",
-    L"-o",
+    RESEMBLA_TEXT("bv"),
+    RESEMBLA_TEXT("ck"),
+    RESEMBLA_TEXT("cq"),
+    RESEMBLA_TEXT("kq"),
+    RESEMBLA_TEXT("cs"),
+    RESEMBLA_TEXT("fh"),
+    RESEMBLA_TEXT("lr"),
+    RESEMBLA_TEXT("jz"),
+    RESEMBLA_TEXT("xz"),
+    RESEMBLA_TEXT("-a"),
+    RESEMBLA_TEXT("-i"),
+    RESEMBLA_TEXT("-u"),
+    RESEMBLA_TEXT("-e"),
+    RESEMBLA_TEXT("-o"),
 };
 
 RomajiMismatchCost::RomajiMismatchCost(double case_mismatch_cost, double similar_letter_cost): 
@@ -52,22 +52,22 @@ RomajiMismatchCost::RomajiMismatchCost(double case_mismatch_cost, double similar
 RomajiMismatchCost::RomajiMismatchCost(const std::string& letter_similarity_file_path, double case_mismatch_cost):
     case_mismatch_cost(case_mismatch_cost)
 {
-    std::basic_ifstream<string_type::value_type> ifs(letter_similarity_file_path);
+    std::ifstream ifs(letter_similarity_file_path);
     if(ifs.fail()){
         throw std::runtime_error("input file is not available: " + letter_similarity_file_path);
     }
     while(ifs.good()){
-        string_type line;
+        std::string line;
         std::getline(ifs, line);
         if(ifs.eof() || line.length() == 0){
             break;
         }
 
-        auto columns = split(line, column_delimiter<string_type::value_type>());
+        auto columns = split(line, column_delimiter<>());
         if(columns.size() < 2){
-            throw std::runtime_error("invalid line in " + letter_similarity_file_path + ": " + cast_string<std::string>(line));
+            throw std::runtime_error("invalid line in " + letter_similarity_file_path + ": " + line);
         }
-        auto letters= columns[0];
+        auto letters = cast_string<string_type>(columns[0]);
         auto cost = std::stod(columns[1]);
 
         std::sort(std::begin(letters), std::end(letters));
@@ -82,8 +82,8 @@ RomajiMismatchCost::RomajiMismatchCost(const std::string& letter_similarity_file
 
 RomajiMismatchCost::value_type RomajiMismatchCost::toLower(value_type a) const
 {
-    if(L'A' <= a && a <= L'Z'){
-        return a + (L'a' - L'A');
+    if(RESEMBLA_TEXT('A') <= a && a <= RESEMBLA_TEXT('Z')){
+        return a + (RESEMBLA_TEXT('a') - RESEMBLA_TEXT('A'));
     }
     else{
         return a;
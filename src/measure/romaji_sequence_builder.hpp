@@ -21,7 +21,6 @@ limitations under the License.
 #define RESEMBLA_ROMAJI_SEQUENCE_BUILDER_HPP
 
 #include <string>
-#include <unordered_map>
 
 #include "pronunciation_sequence_builder.hpp"
 
@@ -38,8 +37,6 @@ public:
     string_type index(const string_type& text) const;
 
 protected:
-    static const std::unordered_map<string_type, string_type> ROMAJI_MAP;
-
     bool keep_case;
 };
 
@@ -22,62 +22,62 @@ limitations under the License.
 namespace resembla {
 
 const std::unordered_set<RomajiWeight::value_type> RomajiWeight::VOWELS = {
-    L'A',
-    L'E',
-    L'I',
-    L'O',
-    L'U',
-    L'a',
-    L'e',
-    L'i',
-    L'o',
-    L'u',
-    L'-'
+    RESEMBLA_TEXT('A'),
+    RESEMBLA_TEXT('E'),
+    RESEMBLA_TEXT('I'),
+    RESEMBLA_TEXT('O'),
+    RESEMBLA_TEXT('U'),
+    RESEMBLA_TEXT('a'),
+    RESEMBLA_TEXT('e'),
+    RESEMBLA_TEXT('i'),
+    RESEMBLA_TEXT('o'),
+    RESEMBLA_TEXT('u'),
+    RESEMBLA_TEXT('-')
 };
 
 const std::unordered_set<RomajiWeight::value_type> RomajiWeight::CONSONANTS = {
-    L'B',
-    L'C',
-    L'D',
-    L'F',
-    L'G',
-    L'H',
-    L'J',
-    L'K',
-    L'L',
-    L'M',
-    L'N',
-    L'P',
-    L'Q',
-    L'R',
-    L'S',
-    L'T',
-    L'V',
-    L'W',
-    L'X',
-    L'Y',
-    L'Z',
-    L'b',
-    L'c',
-    L'd',
-    L'f',
-    L'g',
-    L'h',
-    L'j',
-    L'k',
-    L'l',
-    L'm',
-    L'n',
-    L'p',
-    L'q',
-    L'r',
-    L's',
-    L't',
-    L'v',
-    L'w',
-    L'x',
-    L'y',
-    L'z'
+    RESEMBLA_TEXT('B'),
+    RESEMBLA_TEXT('C'),
+    RESEMBLA_TEXT('D'),
+    RESEMBLA_TEXT('F'),
+    RESEMBLA_TEXT('G'),
+    RESEMBLA_TEXT('H'),
+    RESEMBLA_TEXT('J'),
+    RESEMBLA_TEXT('K'),
+    RESEMBLA_TEXT('L'),
+    RESEMBLA_TEXT('M'),
+    RESEMBLA_TEXT('N'),
+    RESEMBLA_TEXT('P'),
+    RESEMBLA_TEXT('Q'),
+    RESEMBLA_TEXT('R'),
+    RESEMBLA_TEXT('S'),
+    RESEMBLA_TEXT('T'),
+    RESEMBLA_TEXT('V'),
+    RESEMBLA_TEXT('W'),
+    RESEMBLA_TEXT('X'),
+    RESEMBLA_TEXT('Y'),
+    RESEMBLA_TEXT('Z'),
+    RESEMBLA_TEXT('b'),
+    RESEMBLA_TEXT('c'),
+    RESEMBLA_TEXT('d'),
+    RESEMBLA_TEXT('f'),
+    RESEMBLA_TEXT('g'),
+    RESEMBLA_TEXT('h'),
+    RESEMBLA_TEXT('j'),
+    RESEMBLA_TEXT('k'),
+    RESEMBLA_TEXT('l'),
+    RESEMBLA_TEXT('m'),
+    RESEMBLA_TEXT('n'),
+    RESEMBLA_TEXT('p'),
+    RESEMBLA_TEXT('q'),
+    RESEMBLA_TEXT('r'),
+    RESEMBLA_TEXT('s'),
+    RESEMBLA_TEXT('t'),
+    RESEMBLA_TEXT('v'),
+    RESEMBLA_TEXT('w'),
+    RESEMBLA_TEXT('x'),
+    RESEMBLA_TEXT('y'),
+    RESEMBLA_TEXT('z')
 };
 
 RomajiWeight::RomajiWeight(double base_weight, double delete_insert_ratio, 
@@ -89,12 +89,12 @@ RomajiWeight::RomajiWeight(double base_weight, double delete_insert_ratio,
 
 bool RomajiWeight::isUpper(const value_type c)
 {
-    return L'A' <= c && c <= L'Z';
+    return RESEMBLA_TEXT('A') <= c && c <= RESEMBLA_TEXT('Z');
 }
 
 bool RomajiWeight::isLower(const value_type c)
 {
-    return L'a' <= c && c <= L'z';
+    return RESEMBLA_TEXT('a') <= c && c <= RESEMBLA_TEXT('z');
 }
 
 bool RomajiWeight::isVowel(const value_type c)
@@ -22,11 +22,13 @@ limitations under the License.
 
 #include <unordered_set>
 
+#include "../string_util.hpp"
+
 namespace resembla {
 
 struct RomajiWeight
 {
-    using value_type = wchar_t;
+    using value_type = string_type::value_type;
 
     double base_weight;
     double delete_insert_ratio;
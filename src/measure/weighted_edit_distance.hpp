@@ -22,6 +22,8 @@ limitations under the License.
 
 #include <string>
 #include <vector>
+#include <algorithm>
+#include <limits>
 
 #include "uniform_cost.hpp"
 
@@ -38,28 +40,45 @@ struct WeightedEditDistance
     template<typename sequence_type>
     double operator()(const sequence_type& a, const sequence_type& b) const
     {
-        // prepare work table
-        std::vector<std::vector<double>> D(a.size() + 1, std::vector<double>(b.size() + 1));
-        D[0][0] = 0;
-        for(size_t i = 1; i < a.size() + 1; ++i){
-            D[i][0] = D[i - 1][0] + a[i - 1].weight;
-        }
+        return operator()(a, b, -std::numeric_limits<double>::infinity());
+    }
+
+    // stops computation and returns an upper bound of the similarity if it is lower than floor
+    template<typename sequence_type>
+    double operator()(const sequence_type& a, const sequence_type& b, double floor) const
+    {
+        // prepare work rows
+        std::vector<double> D(b.size() + 1), E(b.size() + 1);
+        D[0] = 0;
         for(size_t j = 1; j < b.size() + 1; ++j){
-            D[0][j] = D[0][j - 1] + b[j - 1].weight;
+            D[j] = D[j - 1] + b[j - 1].weight;
+        }
+        double total_cost = 0;
+        for(const auto& t: a){
+            total_cost += t.weight;
         }
-        double total_cost = D[a.size()][0] + D[0][b.size()];
+        total_cost += D[b.size()];
 
         // compute edit distance
         for(size_t i = 1; i < a.size() + 1; ++i){
+            E[0] = D[0] + a[i - 1].weight;
+            double row_min = E[0];
             for(size_t j = 1; j < b.size() + 1; ++j){
-                double d_delete = D[i - 1][j] + a[i - 1].weight;
-                double d_insert = D[i][j - 1] + b[j - 1].weight;
-                double d_replace = D[i - 1][j - 1] + cost_func(a[i - 1].token, b[j - 1].token) * (a[i - 1].weight + b[j - 1].weight);
-                D[i][j] = std::min({d_delete, d_insert, d_replace});
+                double d_delete = D[j] + a[i - 1].weight;
+                double d_insert = E[j - 1] + b[j - 1].weight;
+                double d_replace = D[j - 1] + cost_func(a[i - 1].token, b[j - 1].token) * (a[i - 1].weight + b[j - 1].weight);
+                E[j] = std::min({d_delete, d_insert, d_replace});
+                row_min = std::min(row_min, E[j]);
+            }
+            std::swap(D, E);
+
+            // distance never decreases in the following rows
+            if(total_cost > 0 && 1.0 - row_min / total_cost < floor){
+                return 1.0 - row_min / total_cost;
             }
         }
-    
-        return 1.0 - D[a.size()][b.size()] / total_cost;
+
+        return 1.0 - D[b.size()] / total_cost;
     }
 };
 
@@ -26,20 +26,33 @@ namespace resembla {
 
 void to_json(nlohmann::json& j, const typename WeightedSequenceBuilder<WordSequenceBuilder, WordWeight>::token_type& o)
 {
-    std::vector<std::string> feature;
-    for(const auto& f: o.token.feature){
-        feature.push_back(cast_string<std::string>(f));
-    }
-    j = nlohmann::json{{"t", {{"s", cast_string<std::string>(o.token.surface)}, {"f", feature}}}, {"w", o.weight}};
+    j = nlohmann::json{{"t", {
+        {"s", cast_string<std::string>(o.token.surface)},
+        {"p", static_cast<int>(o.token.pos)},
+        {"c", static_cast<int>(o.token.subcategory)},
+        {"b", cast_string<std::string>(o.token.base_form)},
+        {"r", cast_string<std::string>(o.token.reading)}
+    }}, {"w", o.weight}};
 }
 
 void from_json(const nlohmann::json& j, typename WeightedSequenceBuilder<WordSequenceBuilder, WordWeight>::token_type& o)
 {
-    o.token.surface = cast_string<string_type>(j.at("t").at("s").get<std::string>());
-    std::vector<std::string> feature = j.at("t").at("f").get<std::vector<std::string>>();
-    o.token.feature.clear();
-    for(const auto& f: feature){
-        o.token.feature.push_back(cast_string<string_type>(f));
+    const auto& t = j.at("t");
+    string_type surface = cast_string<string_type>(t.at("s").get<std::string>());
+    if(t.find("f") != t.end()){
+        // indexes created by older versions keep all features
+        std::vector<string_type> feature;
+        for(const auto& f: t.at("f").get<std::vector<std::string>>()){
+            feature.push_back(cast_string<string_type>(f));
+        }
+        o.token = Word(surface, feature);
+    }
+    else{
+        o.token = Word(surface,
+            static_cast<Word::PartOfSpeech>(t.at("p").get<int>()),
+            static_cast<Word::Subcategory>(t.at("c").get<int>()),
+            cast_string<string_type>(t.at("b").get<std::string>()),
+            cast_string<string_type>(t.at("r").get<std::string>()));
     }
     o.weight = j.at("w").get<double>();
 }
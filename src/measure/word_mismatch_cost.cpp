@@ -29,8 +29,8 @@ double WordMismatchCost::operator()(const Word& reference, const Word& target) c
     if(reference.surface == target.surface){
         return 0.0;
     }
-    else if((!reference.feature[6].empty() && reference.feature[6] != L"*" && reference.feature[6] == target.feature[6]) ||
-            (!reference.feature[7].empty() && reference.feature[7] != L"*" && reference.feature[7] == target.feature[7])){
+    else if((!reference.base_form.empty() && reference.base_form == target.base_form) ||
+            (!reference.reading.empty() && reference.reading == target.reading)){
         return 0.1;
     }
     else{
@@ -22,11 +22,9 @@ limitations under the License.
 
 #include <memory>
 #include <string>
-#include <mutex>
-
-#include <mecab.h>
 
 #include "../word.hpp"
+#include "mecab_analyzer.hpp"
 
 namespace resembla {
 
@@ -37,7 +35,6 @@ public:
     using output_type = std::vector<token_type>;
 
     WordSequenceBuilder(const std::string mecab_options = "");
-    WordSequenceBuilder(const WordSequenceBuilder& obj);
 
     // parses to a sequence of words
     output_type operator()(const string_type& text, bool is_original = false) const;
@@ -46,10 +43,7 @@ public:
     string_type index(const string_type& text) const;
 
 protected:
-    static const int FEATURE_SIZE;
-    std::shared_ptr<MeCab::Tagger> tagger;
-
-    mutable std::mutex mutex_tagger;
+    std::shared_ptr<MeCabAnalyzer> analyze;
 };
 
 }
@@ -28,24 +28,24 @@ double WordWeight::operator()(const Word& word, bool is_original, size_t, size_t
 {
     double weight = base_weight;
 
-    if(word.feature[7].empty() || word.feature[7] == L"*"){
+    if(word.reading.empty()){
         weight *= word.surface.length();
     }
     else{
-        weight *= word.feature[7].length();
+        weight *= word.reading.length();
     }
 
     if(is_original){
         weight *= delete_insert_ratio;
     }
 
-    if(word.feature[0] == L"名詞" && word.feature[1] != L"接尾" && word.feature[1] != L"非自立" && word.feature[1] != L"副詞可能" && word.feature[1] != L"代名詞"){
+    if(word.pos == Word::NOUN && word.subcategory != Word::SUFFIX && word.subcategory != Word::NON_INDEPENDENT && word.subcategory != Word::ADVERBIAL && word.subcategory != Word::PRONOUN){
         weight *= noun_coefficient;
     }
-    else if(word.feature[0] == L"動詞" && word.feature[1] != L"接尾" && word.feature[1] != L"非自立"){
+    else if(word.pos == Word::VERB && word.subcategory != Word::SUFFIX && word.subcategory != Word::NON_INDEPENDENT){
         weight *= verb_coefficient;
     }
-    else if(word.feature[0] == L"形容詞"){
+    else if(word.pos == Word::ADJECTIVE){
         weight *= adj_coefficient;
     }
     return weight;
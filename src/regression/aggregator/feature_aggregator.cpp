@@ -20,47 +20,168 @@ limitations under the License.
 #include "feature_aggregator.hpp"
 
 #include <iostream>
+#include <typeinfo>
+
+#include "flag_feature_aggregator.hpp"
+#include "real_feature_aggregator.hpp"
+#include "interval_feature_aggregator.hpp"
 
 namespace resembla {
 
+FeatureAggregator::FeatureAggregator(std::shared_ptr<const FeatureSchema> schema): schema(schema)
+{}
+
 void FeatureAggregator::append(Feature::key_type key, std::shared_ptr<Function> func)
 {
-    functions[key] = func;
+    auto i = schema->index(key);
+    Op op = {CUSTOM, i, schema->offset(i), func};
+    // exact types only, so that subclasses overriding operator() are called virtually
+    if(func == nullptr){
+        op.operation = COPY;
+    }
+    else if(typeid(*func) == typeid(FlagFeatureAggregator)){
+        op.operation = FLAG;
+    }
+    else if(typeid(*func) == typeid(RealFeatureAggregator)){
+        op.operation = REAL;
+    }
+    else if(typeid(*func) == typeid(IntervalFeatureAggregator)){
+        op.operation = INTERVAL;
+    }
+
+    for(auto& o: ops){
+        if(o.index == i){
+            o = op;
+            return;
+        }
+    }
+    ops.push_back(op);
+}
+
+Feature::real_type FeatureAggregator::apply(const Op& op, const Feature::real_type* target, const Feature::real_type* reference)
+{
+    switch(op.operation){
+    case FLAG:
+        return FlagFeatureAggregatorImpl()(*target, *reference);
+    case REAL:
+        return RealFeatureAggregatorImpl()(*target, *reference);
+    case INTERVAL:
+        return IntervalFeatureAggregator::aggregate(target, reference);
+    case CUSTOM:
+        return (*op.func)(target, reference);
+    case COPY:
+    default:
+        return *target;
+    }
 }
 
 FeatureAggregator::output_type FeatureAggregator::operator()(const input_type& a, const input_type& b) const
 {
-    output_type features;
-    for(const auto& i: functions){
-        auto j = a.find(i.first);
-        auto k = b.find(i.first);
-        if(j != std::end(a)){
-            if(k != std::end(b)){
+    return combine(a, b);
+}
+
+FeatureAggregator::output_type FeatureAggregator::operator()(const FeatureOverlay& a, const FeatureOverlay& b) const
+{
+    return combine(a, b);
+}
+
+template<class Input>
+FeatureAggregator::output_type FeatureAggregator::combine(const Input& a, const Input& b) const
+{
+    output_type features(schema->size(), Feature::missing());
+    for(const auto& op: ops){
+        const auto* j = valuesAt(a, op.offset);
+        const auto* k = valuesAt(b, op.offset);
+        if(!Feature::isMissing(*j)){
+            if(!Feature::isMissing(*k)){
                 // apply function if both a and b have values
-                features[i.first] = (*i.second)(j->second, k->second);
+                features[op.index] = apply(op, j, k);
             }
             else{
-                features[i.first] = Feature::toReal(j->second);
+                features[op.index] = *j;
             }
         }
-        else if(k != std::end(b)){
-            features[i.first] = Feature::toReal(k->second);
+        else if(!Feature::isMissing(*k)){
+            features[op.index] = *k;
         }
     }
 #ifdef DEBUG
     std::cerr << "given feature sets" << std::endl;
-    for(const auto& i: functions){
-        auto j = a.find(i.first);
-        auto k = b.find(i.first);
-        std::cerr << "  key=" << i.first << ", a=" << (j != std::end(a) ? j->second : "(none)") <<
-            ", b=" << (k != std::end(b) ? k->second : "(none)") << std::endl;
+    for(const auto& op: ops){
+        std::cerr << "  key=" << schema->name(op.index) << ", a=" << a[op.offset] << ", b=" << b[op.offset] << std::endl;
     }
     std::cerr << "aggregated features" << std::endl;
-    for(auto f: features){
-        std::cerr << "  key=" << f.first << ", value=" << f.second << std::endl;
+    for(size_t i = 0; i < features.size(); ++i){
+        std::cerr << "  key=" << schema->name(i) << ", value=" << features[i] << std::endl;
     }
 #endif
     return features;
 }
 
+template<class Input, class Aggregate>
+void FeatureAggregator::applyAll(const Op& op, const Input& a, const std::vector<const Input*>& bs,
+        std::vector<output_type>& outputs, Aggregate aggregate)
+{
+    const auto* j = valuesAt(a, op.offset);
+    const bool is_missing_a = Feature::isMissing(*j);
+    for(size_t n = 0; n < bs.size(); ++n){
+        const auto* k = valuesAt(*bs[n], op.offset);
+        if(Feature::isMissing(*k)){
+            outputs[n][op.index] = *j;
+        }
+        else{
+            outputs[n][op.index] = is_missing_a ? *k : aggregate(j, k);
+        }
+    }
+}
+
+std::vector<FeatureAggregator::output_type> FeatureAggregator::operator()(const input_type& a,
+        const std::vector<const input_type*>& bs) const
+{
+    return combineAll(a, bs);
+}
+
+std::vector<FeatureAggregator::output_type> FeatureAggregator::operator()(const FeatureOverlay& a,
+        const std::vector<const FeatureOverlay*>& bs) const
+{
+    return combineAll(a, bs);
+}
+
+template<class Input>
+std::vector<FeatureAggregator::output_type> FeatureAggregator::combineAll(const Input& a,
+        const std::vector<const Input*>& bs) const
+{
+    std::vector<output_type> outputs(bs.size(), output_type(schema->size(), Feature::missing()));
+    // the kind of operation is dispatched once for all references
+    for(const auto& op: ops){
+        switch(op.operation){
+        case FLAG:
+            applyAll(op, a, bs, outputs, [](const Feature::real_type* j, const Feature::real_type* k){
+                return FlagFeatureAggregatorImpl()(*j, *k);
+            });
+            break;
+        case REAL:
+            applyAll(op, a, bs, outputs, [](const Feature::real_type* j, const Feature::real_type* k){
+                return RealFeatureAggregatorImpl()(*j, *k);
+            });
+            break;
+        case INTERVAL:
+            applyAll(op, a, bs, outputs, IntervalFeatureAggregator::aggregate);
+            break;
+        case CUSTOM:
+            applyAll(op, a, bs, outputs, [&op](const Feature::real_type* j, const Feature::real_type* k){
+                return (*op.func)(j, k);
+            });
+            break;
+        case COPY:
+        default:
+            applyAll(op, a, bs, outputs, [](const Feature::real_type* j, const Feature::real_type*){
+                return *j;
+            });
+            break;
+        }
+    }
+    return outputs;
+}
+
 }
@@ -20,48 +20,101 @@ limitations under the License.
 #ifndef RESEMBLA_FEATURE_AGGREGATOR_HPP
 #define RESEMBLA_FEATURE_AGGREGATOR_HPP
 
-#include <unordered_map>
+#include <vector>
 #include <memory>
-#include <initializer_list>
+#include <utility>
 
 #include "../feature.hpp"
 #include "../../string_util.hpp"
 
 namespace resembla {
 
+// combines extracted vectors of two texts into a vector with a value for each feature of FeatureSchema
 class FeatureAggregator
 {
 public:
-    using input_type = StringFeatureMap;
-    using output_type = FeatureMap;
+    using input_type = FeatureVector;
+    using output_type = FeatureVector;
 
     struct Function
     {
         virtual ~Function(){}
-        virtual Feature::real_type operator()(const Feature::text_type& target, const Feature::text_type& reference) const = 0;
+        // target and reference point to the values of the feature in extracted vectors
+        virtual Feature::real_type operator()(const Feature::real_type* target, const Feature::real_type* reference) const = 0;
     };
 
     template<class F>
-    struct StringsToRealFunction: public Function
+    struct RealsToRealFunction: public Function
     {
-        StringsToRealFunction(){}
-        StringsToRealFunction(F f): f(f){}
+        RealsToRealFunction(){}
+        RealsToRealFunction(F f): f(f){}
 
-        Feature::real_type operator()(const Feature::text_type& target, const Feature::text_type& reference) const
+        Feature::real_type operator()(const Feature::real_type* target, const Feature::real_type* reference) const
         {
-            return f(Feature::toReal(target), Feature::toReal(reference));
+            return f(target[0], reference[0]);
         }
 
     private:
         F f;
     };
 
+    FeatureAggregator(std::shared_ptr<const FeatureSchema> schema);
+
+    // func can be nullptr if the feature is given by either of texts
     void append(Feature::key_type key, std::shared_ptr<Function> func);
 
     output_type operator()(const input_type& target, const input_type& reference) const;
+    output_type operator()(const FeatureOverlay& target, const FeatureOverlay& reference) const;
+    // aggregates target with each of references, applying each operation to all references at once
+    std::vector<output_type> operator()(const input_type& target, const std::vector<const input_type*>& references) const;
+    std::vector<output_type> operator()(const FeatureOverlay& target,
+            const std::vector<const FeatureOverlay*>& references) const;
 
 protected:
-    std::unordered_map<Feature::key_type, std::shared_ptr<Function>> functions;
+    // kinds of aggregation. functions defined in this library are called directly without virtual calls
+    enum Operation
+    {
+        COPY,
+        FLAG,
+        REAL,
+        INTERVAL,
+        CUSTOM
+    };
+
+    struct Op
+    {
+        Operation operation;
+        // position of the feature in aggregated vectors
+        size_t index;
+        // position of the feature values in extracted vectors
+        size_t offset;
+        // used only by CUSTOM
+        std::shared_ptr<Function> func;
+    };
+
+    const std::shared_ptr<const FeatureSchema> schema;
+
+    // operations in the order of append
+    std::vector<Op> ops;
+
+    static const Feature::real_type* valuesAt(const input_type& x, size_t offset)
+    {
+        return &x[offset];
+    }
+
+    static const Feature::real_type* valuesAt(const FeatureOverlay& x, size_t offset)
+    {
+        return x.at(offset);
+    }
+
+    static Feature::real_type apply(const Op& op, const Feature::real_type* target, const Feature::real_type* reference);
+    template<class Input>
+    output_type combine(const Input& target, const Input& reference) const;
+    template<class Input>
+    std::vector<output_type> combineAll(const Input& target, const std::vector<const Input*>& references) const;
+    template<class Input, class Aggregate>
+    static void applyAll(const Op& op, const Input& target, const std::vector<const Input*>& references,
+            std::vector<output_type>& outputs, Aggregate aggregate);
 };
 
 }
@@ -28,7 +28,7 @@ struct FlagFeatureAggregatorImpl
 {
     Feature::real_type operator()(Feature::real_type a, Feature::real_type b) const;
 };
-using FlagFeatureAggregator = FeatureAggregator::StringsToRealFunction<FlagFeatureAggregatorImpl>;
+using FlagFeatureAggregator = FeatureAggregator::RealsToRealFunction<FlagFeatureAggregatorImpl>;
 
 }
 #endif
@@ -19,25 +19,25 @@ limitations under the License.
 
 #include "interval_feature_aggregator.hpp"
 
-#include "../../string_util.hpp"
-
 namespace resembla {
 
-Feature::real_type IntervalFeatureAggregator::operator()(const Feature::text_type& a, const Feature::text_type& b) const
+Feature::real_type IntervalFeatureAggregator::operator()(const Feature::real_type* a, const Feature::real_type* b) const
 {
-    if(a.empty() || b.empty()){
-        return 0.0;
-    }
+    return aggregate(a, b);
+}
 
-    auto u = split(a, value_delimiter<Feature::text_type::value_type>());
-    auto v = split(b, value_delimiter<Feature::text_type::value_type>());
-    if(u.size() == 1 && v.size() == 1){
+Feature::real_type IntervalFeatureAggregator::aggregate(const Feature::real_type* a, const Feature::real_type* b)
+{
+    // the second value is missing if a feature is a point
+    bool is_point_a = Feature::isMissing(a[1]);
+    bool is_point_b = Feature::isMissing(b[1]);
+    if(is_point_a && is_point_b){
         return 0.0;
     }
-    else if(u.size() == 1 && v.size() > 1){
-        auto t = Feature::toReal(u[0]);
-        auto s = Feature::toReal(v[0]);
-        auto e = Feature::toReal(v[1]);
+    else if(is_point_a && !is_point_b){
+        auto t = a[0];
+        auto s = b[0];
+        auto e = b[1];
         if(s <= e){
             return (s <= t && t <= e) ? 1.0 : -1.0;
         }
@@ -45,10 +45,10 @@ Feature::real_type IntervalFeatureAggregator::operator()(const Feature::text_typ
             return (s <= t || t <= e) ? 1.0 : -1.0;
         }
     }
-    else if(v.size() == 1 && u.size() > 1){
-        auto t = Feature::toReal(v[0]);
-        auto s = Feature::toReal(u[0]);
-        auto e = Feature::toReal(u[1]);
+    else if(is_point_b && !is_point_a){
+        auto t = b[0];
+        auto s = a[0];
+        auto e = a[1];
         if(s <= e){
             return (s <= t && t <= e) ? 1.0 : -1.0;
         }
@@ -57,10 +57,10 @@ Feature::real_type IntervalFeatureAggregator::operator()(const Feature::text_typ
         }
     }
     else{
-        auto s0 = Feature::toReal(u[0]);
-        auto e0 = Feature::toReal(u[1]);
-        auto s1 = Feature::toReal(v[0]);
-        auto e1 = Feature::toReal(v[1]);
+        auto s0 = a[0];
+        auto e0 = a[1];
+        auto s1 = b[0];
+        auto e1 = b[1];
         if(s0 <= e0){
             if(s1 <= e1){
                 return (s0 <= e1 && s1 <= e0) ? 1.0 : -1.0;
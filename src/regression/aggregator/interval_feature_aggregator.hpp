@@ -26,7 +26,10 @@ namespace resembla {
 
 struct IntervalFeatureAggregator: public FeatureAggregator::Function
 {
-    Feature::real_type operator()(const Feature::text_type& a, const Feature::text_type& b) const;
+    Feature::real_type operator()(const Feature::real_type* a, const Feature::real_type* b) const;
+
+    // same as operator() without virtual call
+    static Feature::real_type aggregate(const Feature::real_type* a, const Feature::real_type* b);
 };
 
 }
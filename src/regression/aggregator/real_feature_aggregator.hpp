@@ -28,7 +28,7 @@ struct RealFeatureAggregatorImpl
 {
     Feature::real_type operator()(Feature::real_type a, Feature::real_type b) const;
 };
-using RealFeatureAggregator = FeatureAggregator::StringsToRealFunction<RealFeatureAggregatorImpl>;
+using RealFeatureAggregator = FeatureAggregator::RealsToRealFunction<RealFeatureAggregatorImpl>;
 
 }
 #endif
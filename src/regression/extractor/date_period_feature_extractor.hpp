@@ -26,7 +26,7 @@ namespace resembla {
 
 struct DatePeriodFeatureExtractor: public FeatureExtractor::Function
 {
-    Feature::text_type operator()(const string_type& text) const;
+    Feature::real_type operator()(const string_type& text) const;
 };
 
 }
@@ -20,50 +20,55 @@ limitations under the License.
 #include "feature_extractor.hpp"
 
 #include <iostream>
+#include <stdexcept>
 
 #include "../../string_util.hpp"
 
 namespace resembla {
 
-FeatureExtractor::FeatureExtractor(const std::string base_similarity_key): 
-    base_similarity_key(base_similarity_key)
+FeatureExtractor::FeatureExtractor(std::shared_ptr<const FeatureSchema> schema, const std::string base_similarity_key):
+    feature_schema(schema), base_similarity_index(schema->find(base_similarity_key))
 {}
 
 void FeatureExtractor::append(Feature::key_type key, std::shared_ptr<Function> func)
 {
-    functions[key] = func;
+    auto i = feature_schema->index(key);
+    for(auto& f: functions){
+        if(f.first == i){
+            f.second = func;
+            return;
+        }
+    }
+    functions.push_back(std::make_pair(i, func));
 }
 
-FeatureExtractor::output_type FeatureExtractor::operator()(const std::string& raw_text, const std::string& raw_features) const
+FeatureExtractor::output_type FeatureExtractor::parse(const std::string& raw_features) const
 {
-#ifdef DEBUG
-    std::cerr << "load features from saved data: text=" << raw_text << ", features=" << raw_features << std::endl;
-#else
-    (void)raw_text;
-#endif
-    output_type features;
+    auto features = feature_schema->extracted();
     for(const auto& f: split(raw_features, feature_delimiter<>())){
         auto kv = split(f, keyvalue_delimiter<>());
         if(kv.size() == 2){
-            auto i = functions.find(kv[0]);
-            if(i != std::end(functions)){
-                features[kv[0]] = kv[1];
+            auto i = feature_schema->find(kv[0]);
+            for(const auto& g: functions){
+                if(g.first == i){
+                    feature_schema->parse(i, kv[1], features);
 #ifdef DEBUG
-                std::cerr << "load feature: key=" << kv[0] << ", value=" << kv[1] << std::endl;
+                    std::cerr << "load feature: key=" << kv[0] << ", value=" << kv[1] << std::endl;
 #endif
+                    break;
+                }
             }
         }
     }
-    for(const auto& i: functions){
-        auto k = features.find(i.first);
-        if(k == std::end(features)){
-            features[i.first] = (*i.second)(cast_string<string_type>(raw_text));
+    return features;
+}
+
+FeatureExtractor::output_type FeatureExtractor::operator()(const std::string& raw_text, const std::string& raw_features) const
+{
 #ifdef DEBUG
-            std::cerr << "extract feature: key=" << i.first << ", value=" << (*i.second)(cast_string<string_type>(raw_text)) << std::endl;
+    std::cerr << "load features from saved data: text=" << raw_text << ", features=" << raw_features << std::endl;
 #endif
-        }
-    }
-    return features;
+    return (*this)(cast_string<string_type>(raw_text), parse(raw_features));
 }
 
 FeatureExtractor::output_type FeatureExtractor::operator()(
@@ -71,69 +76,45 @@ FeatureExtractor::output_type FeatureExtractor::operator()(
 {
     output_type features(given_features);
     // TODO: remove this code. FeatureExtractor should accept multiple base similarities
-    features[base_similarity_key] = Feature::toText(data.score);
-    for(const auto& i: functions){
-        auto k = features.find(i.first);
-#ifdef DEBUG
-        if(k == std::end(features)){
-            std::cerr << "extract feature: key=" << i.first << ", value=" << (*i.second)(data.text) << std::endl;
-        }
-        else{
-            std::cerr << "skip already computed feature: key=" << i.first << ", value=" << k->second << std::endl;
-        }
-#endif
-        if(k == std::end(features)){
-            features[i.first] = (*i.second)(data.text);
-        }
+    if(base_similarity_index != FeatureSchema::npos){
+        features[feature_schema->offset(base_similarity_index)] = data.score;
     }
-    return features;
+    return (*this)(data.text, std::move(features));
 }
 
 FeatureExtractor::output_type FeatureExtractor::operator()(const string_type& text) const
 {
-    output_type features;
-    for(const auto& i: functions){
-#ifdef DEBUG
-        std::cerr << "extract feature: " << i.first << std::endl;
-#endif
-        features[i.first] = (*i.second)(text);
-    }
-    return features;
+    return (*this)(text, feature_schema->extracted());
 }
 
-FeatureExtractor::output_type FeatureExtractor::operator()(const string_type& text, bool is_original) const
+FeatureExtractor::output_type FeatureExtractor::operator()(const string_type& text, output_type given_features) const
 {
-    output_type features;
-
-    auto raw_text = cast_string<std::string>(text);
-    if(is_original){
-        auto columns = split(raw_text, column_delimiter<>());
-        if(columns.size() > 1){
-            raw_text = columns[0];
-            for(const auto& f: split(columns[1], feature_delimiter<>())){
-                auto kv = split(f, keyvalue_delimiter<>());
-                if(kv.size() == 2){
-                    auto i = functions.find(kv[0]);
-                    if(i != std::end(functions)){
+    for(const auto& f: functions){
+        auto& value = given_features[feature_schema->offset(f.first)];
+        if(Feature::isMissing(value)){
+            value = (*f.second)(text);
 #ifdef DEBUG
-                        std::cerr << "load feature: key=" << kv[0] << ", value=" << kv[1] << std::endl;
+            std::cerr << "extract feature: key=" << feature_schema->name(f.first) << ", value=" << value << std::endl;
 #endif
-                        features[kv[0]] = kv[1];
-                    }
-                }
-            }
         }
-    }
-    for(const auto& i: functions){
-        auto k = features.find(i.first);
-        if(k == std::end(features)){
-            features[i.first] = (*i.second)(cast_string<string_type>(raw_text));
 #ifdef DEBUG
-            std::cerr << "extract feature: key=" << i.first << ", value=" << (*i.second)(cast_string<string_type>(raw_text)) << std::endl;
+        else{
+            std::cerr << "skip already computed feature: key=" << feature_schema->name(f.first) << ", value=" << value << std::endl;
+        }
 #endif
+    }
+    return given_features;
+}
+
+StringFeatureMap FeatureExtractor::operator()(const string_type& text, bool is_original) const
+{
+    if(is_original){
+        auto columns = split(text, column_delimiter<string_type::value_type>());
+        if(columns.size() > 1){
+            return feature_schema->format((*this)(columns[0], parse(cast_string<std::string>(columns[1]))));
         }
     }
-    return features;
+    return feature_schema->format((*this)(text));
 }
 
 string_type FeatureExtractor::index(const string_type& text) const
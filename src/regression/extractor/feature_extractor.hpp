@@ -20,9 +20,9 @@ limitations under the License.
 #ifndef RESEMBLA_FEATURE_EXTRACTOR_HPP
 #define RESEMBLA_FEATURE_EXTRACTOR_HPP
 
-#include <unordered_map>
+#include <vector>
 #include <memory>
-#include <initializer_list>
+#include <utility>
 
 #include "../../resembla_interface.hpp"
 #include "../../string_util.hpp"
@@ -30,51 +30,65 @@ limitations under the License.
 
 namespace resembla {
 
+// extracts features of texts into vectors of FeatureSchema
 class FeatureExtractor
 {
 public:
     using string_type = resembla::string_type;
-    using output_type = StringFeatureMap;
+    using output_type = FeatureVector;
 
     struct Function
     {
         virtual ~Function(){}
-        virtual Feature::text_type operator()(const string_type& text) const = 0;
+        virtual Feature::real_type operator()(const string_type& text) const = 0;
     };
 
     template<class F>
-    struct StringToStringFunction: public Function
+    struct StringToRealFunction: public Function
     {
-        StringToStringFunction(){}
-        StringToStringFunction(F f): f(f){}
+        StringToRealFunction(): f(){}
+        StringToRealFunction(F f): f(f){}
 
-        Feature::text_type operator()(const string_type& text) const
+        Feature::real_type operator()(const string_type& text) const
         {
-            return Feature::toText(f(text));
+            return f(text);
         }
 
     private:
         const F f;
     };
 
-    FeatureExtractor(const std::string base_similarity_key = "base_similarity");
+    FeatureExtractor(std::shared_ptr<const FeatureSchema> schema, const std::string base_similarity_key = "base_similarity");
 
+    // func must extract a feature defined in the schema
     void append(Feature::key_type key, std::shared_ptr<Function> func);
 
+    const FeatureSchema& schema() const
+    {
+        return *feature_schema;
+    }
+
     // load features of corpus texts
     output_type operator()(const std::string& raw_text, const std::string& raw_features) const;
     // extract features from corpus text using already loaded features
     output_type operator()(const ResemblaInterface::output_type& data, const output_type& given_features) const;
     // extract features from unknown text
     output_type operator()(const string_type& text) const;
+    // extract features not in given_features from text
+    output_type operator()(const string_type& text, output_type given_features) const;
 
-    // extract features when indexing
-    output_type operator()(const string_type& text, bool is_original) const;
+    // extract features when indexing. results are saved as texts
+    StringFeatureMap operator()(const string_type& text, bool is_original) const;
     string_type index(const string_type& text) const;
 protected:
-    const std::string base_similarity_key;
+    const std::shared_ptr<const FeatureSchema> feature_schema;
+    const size_t base_similarity_index;
+
+    // pairs of feature position and function, in the order of append
+    std::vector<std::pair<size_t, std::shared_ptr<Function>>> functions;
 
-    std::unordered_map<Feature::key_type, std::shared_ptr<Function>> functions;
+    // parses serialized features such as "key1=value1&key2=value2". features without function are ignored
+    output_type parse(const std::string& raw_features) const;
 };
 
 }
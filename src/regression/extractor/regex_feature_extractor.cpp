@@ -36,12 +36,28 @@ RegexFeatureExtractor::RegexFeatureExtractor(const std::string file_path)
 
 Feature::real_type RegexFeatureExtractor::match(const string_type& text) const
 {
-    for(const auto& i: re_all){
-        if(std::regex_match(text, i.second)){
+    if(re_set != nullptr){
+        auto i = re_set->match(text);
+        if(i == RegexSet::npos){
+            return 0.0;
+        }
+#ifdef DEBUG
+        std::cerr << "regex detector: evidence found, text=" << cast_string<std::string>(text) << ", score=" << scores[i] << std::endl;
+#endif
+        return scores[i];
+    }
+
+#ifdef RESEMBLA_UTF32_STRING
+    const auto target = cast_string<std::wstring>(text);
+#else
+    const auto& target = text;
+#endif
+    for(size_t i = 0; i < re_all.size(); ++i){
+        if(std::regex_match(target, re_all[i])){
 #ifdef DEBUG
-            std::cerr << "regex detector: evidence found, text=" << cast_string<std::string>(text) << ", score=" << i.first << std::endl;
+            std::cerr << "regex detector: evidence found, text=" << cast_string<std::string>(text) << ", score=" << scores[i] << std::endl;
 #endif
-            return i.first;
+            return scores[i];
         }
     }
     return 0.0;
@@ -69,9 +85,9 @@ std::vector<std::pair<double, std::string>> RegexFeatureExtractor::load(const st
     return patterns;
 }
 
-Feature::text_type RegexFeatureExtractor::operator()(const string_type& text) const
+Feature::real_type RegexFeatureExtractor::operator()(const string_type& text) const
 {
-    return Feature::toText(match(text));
+    return match(text);
 }
 
 }
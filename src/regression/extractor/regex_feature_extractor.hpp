@@ -23,9 +23,11 @@ limitations under the License.
 #include <regex>
 #include <string>
 #include <vector>
+#include <memory>
 #include <initializer_list>
 
 #include "feature_extractor.hpp"
+#include "regex_set.hpp"
 
 namespace resembla {
 
@@ -40,18 +42,35 @@ struct RegexFeatureExtractor: public FeatureExtractor::Function
     RegexFeatureExtractor(const std::string file_path);
     RegexFeatureExtractor(const std::initializer_list<std::pair<Feature::real_type, std::string>>& patterns);
 
-    Feature::text_type operator()(const string_type& text) const;
+    Feature::real_type operator()(const string_type& text) const;
 
 protected:
-    using regex = std::basic_regex<string_type::value_type>;
+    // std::regex supports only char and wchar_t
+    using regex = std::wregex;
 
-    std::vector<std::pair<Feature::real_type, regex>> re_all;
+    // score of each pattern
+    std::vector<Feature::real_type> scores;
+
+    // all patterns compiled into one automaton, or nullptr if some pattern is not supported by RegexSet
+    std::unique_ptr<RegexSet> re_set;
+    // patterns matched one by one if re_set is not available
+    std::vector<regex> re_all;
 
     template<class ScorePatternPairs>
     void construct(const ScorePatternPairs& patterns)
     {
+        std::vector<string_type> texts;
         for(const auto& i: patterns){
-            re_all.push_back(std::make_pair(i.first, regex(cast_string<string_type>(i.second))));
+            scores.push_back(i.first);
+            texts.push_back(cast_string<string_type>(i.second));
+        }
+        try{
+            re_set.reset(new RegexSet(texts));
+        }
+        catch(const std::invalid_argument&){
+            for(const auto& i: patterns){
+                re_all.push_back(regex(cast_string<std::wstring>(i.second)));
+            }
         }
     }
 
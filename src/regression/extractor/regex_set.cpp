@@ -0,0 +1,410 @@
+/*
+Resembla: Word-based Japanese similar sentence search library
+https://github.com/tuem/resembla
+
+Copyright 2017 Takashi Uemura
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "regex_set.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace resembla {
+
+const size_t RegexSet::npos = static_cast<size_t>(-1);
+
+// max number of copies of an expression expanded for a bounded quantifier
+static const size_t MAX_REPEAT = 1000;
+// max number of states of all patterns. nested quantifiers can multiply copies beyond memory
+static const size_t MAX_STATES = 1 << 20;
+
+bool RegexSet::CharSet::contains(char_type c) const
+{
+    for(const auto& r: ranges){
+        if(r.first <= c && c <= r.second){
+            return !negated;
+        }
+    }
+    return negated;
+}
+
+// recursive descent parser for the supported subset of ECMAScript regular expressions
+class RegexSet::Parser
+{
+public:
+    Parser(const std::u32string& pattern): pattern(pattern), i(0) {}
+
+    Node parse()
+    {
+        Node node = parseAlternative();
+        if(i != pattern.size()){
+            error("unexpected character");
+        }
+        return node;
+    }
+
+private:
+    const std::u32string& pattern;
+    size_t i;
+
+    void error(const std::string& message) const
+    {
+        throw std::invalid_argument("unsupported regular expression: " + message + ": " + cast_string<std::string>(pattern));
+    }
+
+    bool end() const
+    {
+        return i == pattern.size();
+    }
+
+    Node parseAlternative()
+    {
+        Node node(Node::ALTERNATIVE);
+        node.children.push_back(parseConcatenation());
+        while(!end() && pattern[i] == U'|'){
+            ++i;
+            node.children.push_back(parseConcatenation());
+        }
+        return node.children.size() == 1 ? node.children[0] : node;
+    }
+
+    Node parseConcatenation()
+    {
+        Node node(Node::CONCAT);
+        while(!end() && pattern[i] != U'|' && pattern[i] != U')'){
+            Node atom = parseAtom();
+            if(!end() && (pattern[i] == U'*' || pattern[i] == U'+' || pattern[i] == U'?' || pattern[i] == U'{')){
+                atom = parseQuantifier(atom);
+            }
+            node.children.push_back(atom);
+        }
+        return node.children.size() == 1 ? node.children[0] : node;
+    }
+
+    Node parseQuantifier(const Node& atom)
+    {
+        Node node(Node::REPEAT);
+        node.children.push_back(atom);
+        switch(pattern[i++]){
+        case U'*':
+            node.min = 0;
+            node.max = npos;
+            break;
+        case U'+':
+            node.min = 1;
+            node.max = npos;
+            break;
+        case U'?':
+            node.min = 0;
+            node.max = 1;
+            break;
+        default:
+            node.min = parseNumber();
+            node.max = node.min;
+            if(!end() && pattern[i] == U','){
+                ++i;
+                node.max = !end() && pattern[i] == U'}' ? npos : parseNumber();
+            }
+            if(end() || pattern[i] != U'}' || node.min > node.max){
+                error("invalid quantifier");
+            }
+            ++i;
+            if(node.min > MAX_REPEAT || (node.max != npos && node.max > MAX_REPEAT)){
+                error("too many repetitions");
+            }
+            break;
+        }
+        // lazy quantifiers match the same whole texts as greedy ones
+        if(!end() && pattern[i] == U'?'){
+            ++i;
+        }
+        if(!end() && (pattern[i] == U'*' || pattern[i] == U'+' || pattern[i] == U'?' || pattern[i] == U'{')){
+            error("nothing to repeat");
+        }
+        return node;
+    }
+
+    size_t parseNumber()
+    {
+        size_t n = 0, digits = 0;
+        for(; !end() && U'0' <= pattern[i] && pattern[i] <= U'9'; ++i, ++digits){
+            n = std::min<size_t>(n * 10 + (pattern[i] - U'0'), MAX_REPEAT + 1);
+        }
+        if(digits == 0){
+            error("invalid quantifier");
+        }
+        return n;
+    }
+
+    Node parseAtom()
+    {
+        Node node(Node::SET);
+        auto c = pattern[i++];
+        switch(c){
+        case U'(':
+            if(!end() && pattern[i] == U'?'){
+                if(i + 1 < pattern.size() && pattern[i + 1] == U':'){
+                    i += 2;
+                }
+                else{
+                    error("assertion");
+                }
+            }
+            node = parseAlternative();
+            if(end() || pattern[i] != U')'){
+                error("unbalanced parenthesis");
+            }
+            ++i;
+            return node;
+        case U'[':
+            parseBracket(node.set);
+            return node;
+        case U'.':
+            // any character except line terminators
+            node.set.negated = true;
+            node.set.ranges = {{U'\n', U'\n'}, {U'\r', U'\r'}, {0x2028, 0x2029}};
+            return node;
+        case U'\\':
+            c = parseEscape();
+            break;
+        case U'^':
+            if(i != 1){
+                error("assertion");
+            }
+            return Node(Node::CONCAT);
+        case U'$':
+            if(i != pattern.size()){
+                error("assertion");
+            }
+            return Node(Node::CONCAT);
+        case U'*':
+        case U'+':
+        case U'?':
+        case U'{':
+        case U'}':
+        case U']':
+            error("unexpected character");
+            break;
+        default:
+            break;
+        }
+        node.set.ranges.push_back(std::make_pair(c, c));
+        return node;
+    }
+
+    // parses escape sequences of single characters after a backslash
+    char_type parseEscape()
+    {
+        if(end()){
+            error("trailing backslash");
+        }
+        auto c = pattern[i++];
+        switch(c){
+        case U't':
+            return U'\t';
+        case U'n':
+            return U'\n';
+        case U'v':
+            return U'\v';
+        case U'f':
+            return U'\f';
+        case U'r':
+            return U'\r';
+        default:
+            break;
+        }
+        // identity escapes only for symbols. character classes and backreferences are not supported
+        if((U'0' <= c && c <= U'9') || (U'A' <= c && c <= U'Z') || (U'a' <= c && c <= U'z') || c == U'_'){
+            error("escape sequence");
+        }
+        return c;
+    }
+
+    void parseBracket(CharSet& set)
+    {
+        if(!end() && pattern[i] == U'^'){
+            set.negated = true;
+            ++i;
+        }
+        if(!end() && pattern[i] == U']'){
+            error("empty bracket");
+        }
+        while(!end() && pattern[i] != U']'){
+            auto first = parseBracketCharacter();
+            auto last = first;
+            if(i + 1 < pattern.size() && pattern[i] == U'-' && pattern[i + 1] != U']'){
+                ++i;
+                last = parseBracketCharacter();
+                if(last < first){
+                    error("invalid range");
+                }
+            }
+            set.ranges.push_back(std::make_pair(first, last));
+        }
+        if(end()){
+            error("unbalanced bracket");
+        }
+        ++i;
+    }
+
+    char_type parseBracketCharacter()
+    {
+        auto c = pattern[i++];
+        if(c == U'\\'){
+            return parseEscape();
+        }
+        else if(c == U'[' && !end() && (pattern[i] == U':' || pattern[i] == U'=' || pattern[i] == U'.')){
+            error("character class");
+        }
+        return c;
+    }
+};
+
+RegexSet::RegexSet(const std::vector<string_type>& patterns)
+{
+    std::vector<uint32_t> starts;
+    for(size_t p = 0; p < patterns.size(); ++p){
+        auto node = Parser(cast_string<std::u32string>(patterns[p])).parse();
+        starts.push_back(compile(node, addState(State::MATCH, p)));
+    }
+
+    // alternative of all patterns. without patterns, the automaton starts with a state matching no character
+    if(starts.empty()){
+        sets.push_back(CharSet());
+        start = addState(State::SET, sets.size() - 1);
+    }
+    else{
+        start = starts.back();
+        for(size_t p = starts.size() - 1; p > 0; --p){
+            start = addState(State::SPLIT, 0, starts[p - 1], start);
+        }
+    }
+}
+
+uint32_t RegexSet::addState(State::Type type, uint32_t value, uint32_t out0, uint32_t out1)
+{
+    if(states.size() >= MAX_STATES){
+        throw std::invalid_argument("too many states in regular expressions");
+    }
+    states.push_back({type, value, out0, out1});
+    return states.size() - 1;
+}
+
+uint32_t RegexSet::compile(const Node& node, uint32_t out)
+{
+    switch(node.type){
+    case Node::EMPTY:
+        return out;
+    case Node::SET:
+        sets.push_back(node.set);
+        return addState(State::SET, sets.size() - 1, out);
+    case Node::CONCAT:
+        for(auto c = node.children.rbegin(); c != node.children.rend(); ++c){
+            out = compile(*c, out);
+        }
+        return out;
+    case Node::ALTERNATIVE:
+        {
+            uint32_t s = compile(node.children.back(), out);
+            for(size_t c = node.children.size() - 1; c > 0; --c){
+                s = addState(State::SPLIT, 0, compile(node.children[c - 1], out), s);
+            }
+            return s;
+        }
+    case Node::REPEAT:
+    default:
+        {
+            const auto& child = node.children[0];
+            uint32_t tail = out;
+            if(node.max == npos){
+                // loop back to a split state after each repetition
+                uint32_t loop = addState(State::SPLIT, 0, 0, out);
+                // compile may reallocate states, so the reference is taken after it
+                uint32_t body = compile(child, loop);
+                states[loop].out0 = body;
+                tail = loop;
+            }
+            else{
+                for(size_t k = node.min; k < node.max; ++k){
+                    tail = addState(State::SPLIT, 0, compile(child, tail), out);
+                }
+            }
+            for(size_t k = 0; k < node.min; ++k){
+                tail = compile(child, tail);
+            }
+            return tail;
+        }
+    }
+}
+
+void RegexSet::addClosure(uint32_t s, std::vector<uint32_t>& list, std::vector<uint32_t>& stack,
+        std::vector<uint64_t>& marks, uint64_t generation) const
+{
+    stack.push_back(s);
+    while(!stack.empty()){
+        s = stack.back();
+        stack.pop_back();
+        if(marks[s] == generation){
+            continue;
+        }
+        marks[s] = generation;
+        if(states[s].type == State::SPLIT){
+            stack.push_back(states[s].out1);
+            stack.push_back(states[s].out0);
+        }
+        else{
+            list.push_back(s);
+        }
+    }
+}
+
+size_t RegexSet::match(const string_type& text) const
+{
+    // buffers are reused in each thread. generations are unique in the thread, so marks are shared among RegexSets
+    thread_local std::vector<uint32_t> current, next, stack;
+    thread_local std::vector<uint64_t> marks;
+    thread_local uint64_t generation = 0;
+    if(marks.size() < states.size()){
+        marks.resize(states.size(), 0);
+    }
+
+    current.clear();
+    addClosure(start, current, stack, marks, ++generation);
+    for(auto c: text){
+        next.clear();
+        ++generation;
+        for(auto s: current){
+            const auto& state = states[s];
+            if(state.type == State::SET && sets[state.value].contains(static_cast<char_type>(c))){
+                addClosure(state.out0, next, stack, marks, generation);
+            }
+        }
+        current.swap(next);
+        if(current.empty()){
+            return npos;
+        }
+    }
+
+    size_t result = npos;
+    for(auto s: current){
+        if(states[s].type == State::MATCH){
+            result = std::min<size_t>(result, states[s].value);
+        }
+    }
+    return result;
+}
+
+}
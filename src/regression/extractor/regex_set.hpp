@@ -0,0 +1,116 @@
+/*
+Resembla: Word-based Japanese similar sentence search library
+https://github.com/tuem/resembla
+
+Copyright 2017 Takashi Uemura
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef RESEMBLA_REGEX_SET_HPP
+#define RESEMBLA_REGEX_SET_HPP
+
+#include <string>
+#include <vector>
+#include <utility>
+#include <cstdint>
+
+#include "../../string_util.hpp"
+
+namespace resembla {
+
+// regular expressions compiled into one Thompson NFA, which finds the first pattern matching a whole text
+// in a single pass, with the same results as std::regex_match in ECMAScript syntax.
+// supports literals, ., bracket expressions, groups, alternatives and quantifiers (*, +, ?, {m,n})
+class RegexSet
+{
+public:
+    static const size_t npos;
+
+    // throws std::invalid_argument if a pattern has syntax not supported or patterns need too many states
+    RegexSet(const std::vector<string_type>& patterns);
+
+    // returns the index of the first pattern matching whole text, or npos if no pattern matches
+    size_t match(const string_type& text) const;
+
+    // number of states in the automaton
+    size_t size() const
+    {
+        return states.size();
+    }
+
+protected:
+    using char_type = char32_t;
+
+    struct CharSet
+    {
+        // inclusive ranges of characters
+        std::vector<std::pair<char_type, char_type>> ranges;
+        bool negated = false;
+
+        bool contains(char_type c) const;
+    };
+
+    // abstract syntax tree of a pattern
+    struct Node
+    {
+        enum Type
+        {
+            EMPTY,
+            SET,
+            CONCAT,
+            ALTERNATIVE,
+            REPEAT
+        };
+
+        Type type;
+        CharSet set;
+        std::vector<Node> children;
+        size_t min;
+        size_t max;
+
+        Node(Type type = EMPTY): type(type), min(0), max(0) {}
+    };
+
+    struct State
+    {
+        enum Type
+        {
+            SET,
+            SPLIT,
+            MATCH
+        };
+
+        Type type;
+        // index of CharSet for SET, or pattern index for MATCH
+        uint32_t value;
+        uint32_t out0;
+        uint32_t out1;
+    };
+
+    class Parser;
+
+    std::vector<CharSet> sets;
+    std::vector<State> states;
+    uint32_t start;
+
+    uint32_t addState(State::Type type, uint32_t value, uint32_t out0 = 0, uint32_t out1 = 0);
+    // compiles node into states followed by out, and returns the first state
+    uint32_t compile(const Node& node, uint32_t out);
+    // adds s and states reachable from s without characters to list
+    void addClosure(uint32_t s, std::vector<uint32_t>& list, std::vector<uint32_t>& stack,
+            std::vector<uint64_t>& marks, uint64_t generation) const;
+};
+
+}
+#endif
@@ -19,20 +19,15 @@ limitations under the License.
 
 #include "time_period_feature_extractor.hpp"
 
-#include <ctime>
-#include <sstream>
-#include <iomanip>
+#include "../../analysis_context.hpp"
 
 namespace resembla {
 
-Feature::text_type TimePeriodFeatureExtractor::operator()(const string_type&) const
+// hhmm of the request time, which is the same for all texts in a request
+Feature::real_type TimePeriodFeatureExtractor::operator()(const string_type&) const
 {
-   time_t t = std::time(nullptr);
-   struct tm* stm = std::localtime(&t); 
-   std::stringstream ss;
-   ss.imbue(std::locale("C"));
-   ss << std::setw(4) << std::setfill('0') << (stm->tm_hour * 100 + stm->tm_min);
-   return ss.str();
+    const auto local = AnalysisContext::currentLocalTime();
+    return local.tm_hour * 100 + local.tm_min;
 }
 
 }
@@ -20,6 +20,9 @@ limitations under the License.
 #include "feature.hpp"
 
 #include <sstream>
+#include <stdexcept>
+
+#include "../string_util.hpp"
 
 namespace resembla {
 
@@ -35,4 +38,79 @@ Feature::real_type Feature::toReal(const text_type& a)
     return std::stod(a);
 }
 
+const size_t FeatureSchema::npos = static_cast<size_t>(-1);
+
+FeatureSchema::FeatureSchema(const std::vector<std::vector<std::string>>& definitions): total_width(0)
+{
+    offsets.push_back(0);
+    for(const auto& definition: definitions){
+        if(definition.empty()){
+            throw std::invalid_argument("empty feature definition");
+        }
+        const auto& name = definition[0];
+        if(indices.count(name) > 0){
+            throw std::invalid_argument("duplicated feature: " + name);
+        }
+        indices[name] = names.size();
+        names.push_back(name);
+        total_width += definition.size() > 2 && definition[2] == "interval" ? 2 : 1;
+        offsets.push_back(total_width);
+    }
+}
+
+size_t FeatureSchema::find(const Feature::key_type& key) const
+{
+    auto i = indices.find(key);
+    return i != std::end(indices) ? i->second : npos;
+}
+
+size_t FeatureSchema::index(const Feature::key_type& key) const
+{
+    auto i = find(key);
+    if(i == npos){
+        throw std::invalid_argument("unknown feature: " + key);
+    }
+    return i;
+}
+
+void FeatureSchema::parse(size_t i, const Feature::text_type& text, FeatureVector& x) const
+{
+    if(text.empty()){
+        return;
+    }
+    auto values = split(text, value_delimiter<Feature::text_type::value_type>());
+    for(size_t j = 0; j < width(i) && j < values.size(); ++j){
+        x[offsets[i] + j] = Feature::toReal(values[j]);
+    }
+}
+
+FeatureVector FeatureSchema::parse(const StringFeatureMap& features) const
+{
+    auto x = extracted();
+    for(const auto& f: features){
+        auto i = find(f.first);
+        if(i != npos){
+            parse(i, f.second, x);
+        }
+    }
+    return x;
+}
+
+StringFeatureMap FeatureSchema::format(const FeatureVector& x) const
+{
+    StringFeatureMap features;
+    for(size_t i = 0; i < names.size(); ++i){
+        if(Feature::isMissing(x[offsets[i]])){
+            continue;
+        }
+        auto text = Feature::toText(x[offsets[i]]);
+        for(size_t j = 1; j < width(i) && !Feature::isMissing(x[offsets[i] + j]); ++j){
+            text += value_delimiter<Feature::text_type::value_type>();
+            text += Feature::toText(x[offsets[i] + j]);
+        }
+        features[names[i]] = text;
+    }
+    return features;
+}
+
 }
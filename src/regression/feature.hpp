@@ -21,7 +21,10 @@ limitations under the License.
 #define RESEMBLA_FEATURE_HPP
 
 #include <string>
+#include <vector>
 #include <unordered_map>
+#include <limits>
+#include <cmath>
 
 namespace resembla {
 
@@ -36,10 +39,124 @@ struct Feature
 
     static text_type toText(const real_type& a);
     static real_type toReal(const text_type& a);
+
+    // value of features not given in dense vectors
+    static real_type missing()
+    {
+        return std::numeric_limits<real_type>::quiet_NaN();
+    }
+
+    static bool isMissing(real_type a)
+    {
+        return std::isnan(a);
+    }
 };
 
+// text representation of features, used for input and output
 using StringFeatureMap = std::unordered_map<Feature::key_type, Feature::text_type>;
 using FeatureMap = std::unordered_map<Feature::key_type, Feature::real_type>;
 
+// values of features at the positions given by FeatureSchema
+using FeatureVector = std::vector<Feature::real_type>;
+
+// extracted vector with values of some features replaced, referring to the vector without copying it.
+// values[i] replaces the value at offsets[i] unless it is missing. replaced features must have width 1
+class FeatureOverlay
+{
+public:
+    FeatureOverlay(const FeatureVector& base, const std::vector<size_t>& offsets, const Feature::real_type* values):
+        base(&base), offsets(&offsets), values(values)
+    {}
+
+    // returns the values of the feature at offset
+    const Feature::real_type* at(size_t offset) const
+    {
+        for(size_t i = 0; i < offsets->size(); ++i){
+            if((*offsets)[i] == offset && !Feature::isMissing(values[i])){
+                return &values[i];
+            }
+        }
+        return &(*base)[offset];
+    }
+
+    Feature::real_type operator[](size_t offset) const
+    {
+        return *at(offset);
+    }
+
+    size_t size() const
+    {
+        return base->size();
+    }
+
+protected:
+    const FeatureVector* base;
+    const std::vector<size_t>* offsets;
+    const Feature::real_type* values;
+};
+
+// positions of features in dense vectors, compiled from rows of feature definitions (name, extractor, aggregator).
+// aggregated vectors have a value for each feature. extracted vectors have two values for interval features
+// (the second one is missing for a point) and one for the others
+class FeatureSchema
+{
+public:
+    static const size_t npos;
+
+    FeatureSchema(const std::vector<std::vector<std::string>>& definitions);
+
+    // number of features, i.e. size of aggregated vectors
+    size_t size() const
+    {
+        return names.size();
+    }
+
+    // size of extracted vectors
+    size_t width() const
+    {
+        return total_width;
+    }
+
+    const Feature::key_type& name(size_t i) const
+    {
+        return names[i];
+    }
+
+    // position of feature in aggregated vectors, or npos if not defined
+    size_t find(const Feature::key_type& key) const;
+    // same as find but throws if key is not defined
+    size_t index(const Feature::key_type& key) const;
+
+    // position of the first value of the i-th feature in extracted vectors
+    size_t offset(size_t i) const
+    {
+        return offsets[i];
+    }
+
+    size_t width(size_t i) const
+    {
+        return offsets[i + 1] - offsets[i];
+    }
+
+    // extracted vector without any feature
+    FeatureVector extracted() const
+    {
+        return FeatureVector(total_width, Feature::missing());
+    }
+
+    // stores text value of the i-th feature in extracted vector x. empty text is regarded as missing
+    void parse(size_t i, const Feature::text_type& text, FeatureVector& x) const;
+    // converts text values to an extracted vector. undefined features are ignored
+    FeatureVector parse(const StringFeatureMap& features) const;
+    // converts an extracted vector to text values of given features
+    StringFeatureMap format(const FeatureVector& x) const;
+
+protected:
+    std::vector<Feature::key_type> names;
+    std::unordered_map<Feature::key_type, size_t> indices;
+    std::vector<size_t> offsets;
+    size_t total_width;
+};
+
 }
 #endif
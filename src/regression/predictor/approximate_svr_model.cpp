@@ -0,0 +1,120 @@
+/*
+Resembla: Word-based Japanese similar sentence search library
+https://github.com/tuem/resembla
+
+Copyright 2017 Takashi Uemura
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "approximate_svr_model.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+
+namespace resembla {
+
+static const double PI = 3.14159265358979323846;
+
+ApproximateSVRModel::ApproximateSVRModel(const SVRModel& model, size_t num_features, unsigned int seed):
+    gamma(model.gamma), rho(model.rho), dim(model.dim)
+{
+    if(model.kernel_type != SVRModel::RBF){
+        throw std::invalid_argument("only SVR with RBF kernel can be approximated");
+    }
+    if(num_features == 0){
+        throw std::invalid_argument("number of random features must be positive");
+    }
+
+    // exp(-gamma * |x - y|^2) = E[2 cos(w x + b) cos(w y + b)] for w ~ N(0, 2 gamma I) and b ~ U[0, 2 pi)
+    std::mt19937 gen(seed);
+    std::normal_distribution<double> sample_frequency(0.0, std::sqrt(2.0 * gamma));
+    std::uniform_real_distribution<double> sample_phase(0.0, 2.0 * PI);
+    frequencies.resize(dim * num_features);
+    phases.resize(num_features);
+    for(size_t k = 0; k < num_features; ++k){
+        for(size_t j = 0; j < dim; ++j){
+            frequencies[j * num_features + k] = sample_frequency(gen);
+        }
+        phases[k] = sample_phase(gen);
+    }
+
+    // support vectors are summed up into a weight for each random feature
+    weights.assign(num_features, 0.0);
+    const double scale = 2.0 / num_features;
+    for(size_t i = 0; i < model.size(); ++i){
+        const double* sv = model.support_vectors.data() + i * dim;
+        for(size_t k = 0; k < num_features; ++k){
+            double p = phases[k];
+            for(size_t j = 0; j < dim; ++j){
+                p += frequencies[j * num_features + k] * sv[j];
+            }
+            weights[k] += scale * model.coefficients[i] * std::cos(p);
+        }
+    }
+}
+
+double ApproximateSVRModel::predict(const double* x, size_t n) const
+{
+    double s;
+    predict(x, n, 1, &s);
+    return s;
+}
+
+void ApproximateSVRModel::predict(const double* xs, size_t n, size_t num_inputs, double* outputs) const
+{
+    const size_t num_features = weights.size();
+    const size_t m = std::min(n, dim);
+    std::vector<double> projections(num_features);
+    for(size_t i = 0; i < num_inputs; ++i){
+        const double* x = xs + i * n;
+        std::copy(std::begin(phases), std::end(phases), std::begin(projections));
+        for(size_t j = 0; j < m; ++j){
+            const double* f = frequencies.data() + j * num_features;
+            for(size_t k = 0; k < num_features; ++k){
+                projections[k] += x[j] * f[k];
+            }
+        }
+
+        double s = 0.0;
+        for(size_t k = 0; k < num_features; ++k){
+            s += weights[k] * std::cos(projections[k]);
+        }
+
+        // features not in any support vector multiply all kernel values by the same factor
+        double x_tail = 0.0;
+        for(size_t j = m; j < n; ++j){
+            x_tail += x[j] * x[j];
+        }
+        if(x_tail > 0.0){
+            s *= std::exp(-gamma * x_tail);
+        }
+        outputs[i] = s - rho;
+    }
+}
+
+double ApproximateSVRModel::maxError(const SVRModel& model, const double* xs, size_t n, size_t num_inputs) const
+{
+    std::vector<double> expected(num_inputs), actual(num_inputs);
+    model.predict(xs, n, num_inputs, expected.data());
+    predict(xs, n, num_inputs, actual.data());
+    double e = 0.0;
+    for(size_t i = 0; i < num_inputs; ++i){
+        e = std::max(e, std::abs(actual[i] - expected[i]));
+    }
+    return e;
+}
+
+}
@@ -0,0 +1,66 @@
+/*
+Resembla: Word-based Japanese similar sentence search library
+https://github.com/tuem/resembla
+
+Copyright 2017 Takashi Uemura
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef RESEMBLA_APPROXIMATE_SVR_MODEL_HPP
+#define RESEMBLA_APPROXIMATE_SVR_MODEL_HPP
+
+#include <vector>
+
+#include "svr_model.hpp"
+
+namespace resembla {
+
+// linear model over random Fourier features approximating SVR with RBF kernel (Rahimi and Recht, 2007).
+// prediction costs O(D * dimension) for D random features regardless of the number of support vectors
+class ApproximateSVRModel
+{
+public:
+    ApproximateSVRModel(const SVRModel& model, size_t num_features, unsigned int seed = 0);
+
+    double predict(const double* x, size_t n) const;
+
+    double predict(const std::vector<double>& x) const
+    {
+        return predict(x.data(), x.size());
+    }
+
+    void predict(const double* xs, size_t n, size_t num_inputs, double* outputs) const;
+
+    // number of random features
+    size_t size() const
+    {
+        return weights.size();
+    }
+
+    // max absolute difference from predictions of model for num_inputs inputs in xs
+    double maxError(const SVRModel& model, const double* xs, size_t n, size_t num_inputs) const;
+
+protected:
+    double gamma;
+    double rho;
+    size_t dim;
+
+    // D values for each dimension of inputs, so that projections of an input are computed in contiguous loops
+    std::vector<double> frequencies;
+    std::vector<double> phases;
+    std::vector<double> weights;
+};
+
+}
+#endif
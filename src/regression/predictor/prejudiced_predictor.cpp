@@ -19,21 +19,26 @@ limitations under the License.
 
 #include "prejudiced_predictor.hpp"
 
+#include <stdexcept>
+
 namespace resembla {
 
 const std::string PrejudicedPredictor::DEFAULT_KEY = "base_similarity";
 
-PrejudicedPredictor::PrejudicedPredictor(std::string name, std::string key):
-    name(name), key(key)
+PrejudicedPredictor::PrejudicedPredictor(std::string name, const FeatureSchema& schema, std::string key):
+    name(name), index(schema.index(key))
 {}
 
-PrejudicedPredictor::PrejudicedPredictor(std::string key):
-    name(key), key(key)
+PrejudicedPredictor::PrejudicedPredictor(const FeatureSchema& schema, std::string key):
+    name(key), index(schema.index(key))
 {}
 
 PrejudicedPredictor::output_type PrejudicedPredictor::operator()(const input_type& x) const
 {
-    return x.at(key);
+    if(Feature::isMissing(x[index])){
+        throw std::out_of_range("feature is not given");
+    }
+    return x[index];
 }
 
 }
@@ -29,20 +29,20 @@ namespace resembla {
 class PrejudicedPredictor
 {
 public:
-    using input_type = FeatureMap;
+    using input_type = FeatureVector;
     using output_type = Feature::real_type;
 
     static const std::string DEFAULT_KEY;
 
     const std::string name;
 
-    PrejudicedPredictor(std::string key = DEFAULT_KEY);
-    PrejudicedPredictor(std::string name, std::string key);
+    PrejudicedPredictor(const FeatureSchema& schema, std::string key = DEFAULT_KEY);
+    PrejudicedPredictor(std::string name, const FeatureSchema& schema, std::string key);
 
     output_type operator()(const input_type& x) const;
 
 protected:
-    const std::string key;
+    const size_t index;
 };
 
 }
@@ -0,0 +1,259 @@
+/*
+Resembla: Word-based Japanese similar sentence search library
+https://github.com/tuem/resembla
+
+Copyright 2017 Takashi Uemura
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "svr_model.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <locale>
+#include <stdexcept>
+#include <utility>
+
+namespace resembla {
+
+constexpr size_t SVRModel::INPUT_BLOCK_SIZE;
+constexpr size_t SVRModel::SV_BLOCK_SIZE;
+
+SVRModel::SVRModel(const std::string& model_file_path):
+    kernel_type(RBF), degree(3), gamma(0.0), coef0(0.0), rho(0.0), dim(0)
+{
+    load(model_file_path);
+}
+
+// same as powi in LIBSVM
+static double powInt(double base, int times)
+{
+    double tmp = base, ret = 1.0;
+    for(int t = times; t > 0; t /= 2){
+        if(t % 2 == 1){
+            ret *= tmp;
+        }
+        tmp = tmp * tmp;
+    }
+    return ret;
+}
+
+// partial sums in independent lanes, so that compilers can vectorize loops without reordering floating point operations
+static double dot(const double* x, const double* y, size_t n)
+{
+    double s0 = 0.0, s1 = 0.0, s2 = 0.0, s3 = 0.0;
+    size_t j = 0;
+    for(; j + 4 <= n; j += 4){
+        s0 += x[j] * y[j];
+        s1 += x[j + 1] * y[j + 1];
+        s2 += x[j + 2] * y[j + 2];
+        s3 += x[j + 3] * y[j + 3];
+    }
+    for(; j < n; ++j){
+        s0 += x[j] * y[j];
+    }
+    return (s0 + s1) + (s2 + s3);
+}
+
+static double squaredDistance(const double* x, const double* y, size_t n)
+{
+    double s0 = 0.0, s1 = 0.0, s2 = 0.0, s3 = 0.0;
+    size_t j = 0;
+    for(; j + 4 <= n; j += 4){
+        double d0 = x[j] - y[j];
+        double d1 = x[j + 1] - y[j + 1];
+        double d2 = x[j + 2] - y[j + 2];
+        double d3 = x[j + 3] - y[j + 3];
+        s0 += d0 * d0;
+        s1 += d1 * d1;
+        s2 += d2 * d2;
+        s3 += d3 * d3;
+    }
+    for(; j < n; ++j){
+        double d = x[j] - y[j];
+        s0 += d * d;
+    }
+    return (s0 + s1) + (s2 + s3);
+}
+
+double SVRModel::predict(const double* x, size_t n) const
+{
+    double s;
+    predict(x, n, 1, &s);
+    return s;
+}
+
+void SVRModel::predict(const double* xs, size_t n, size_t num_inputs, double* outputs) const
+{
+    size_t m = std::min(n, dim);
+
+    // features not in any support vector only change distances for RBF kernel
+    std::vector<double> x_tails(num_inputs, 0.0);
+    if(kernel_type == RBF){
+        for(size_t k = 0; k < num_inputs; ++k){
+            const double* x = xs + k * n;
+            for(size_t j = m; j < n; ++j){
+                x_tails[k] += x[j] * x[j];
+            }
+        }
+    }
+
+    // kernel values are computed for a block of inputs and a block of support vectors at a time,
+    // so that support vectors in the block stay in cache while they are used for all the inputs.
+    // support vectors are summed up in the same order for any block size
+    std::fill(outputs, outputs + num_inputs, 0.0);
+    for(size_t k0 = 0; k0 < num_inputs; k0 += INPUT_BLOCK_SIZE){
+        size_t k1 = std::min(num_inputs, k0 + INPUT_BLOCK_SIZE);
+        for(size_t i0 = 0; i0 < coefficients.size(); i0 += SV_BLOCK_SIZE){
+            size_t i1 = std::min(coefficients.size(), i0 + SV_BLOCK_SIZE);
+            for(size_t k = k0; k < k1; ++k){
+                const double* x = xs + k * n;
+                double sum = outputs[k];
+                for(size_t i = i0; i < i1; ++i){
+                    sum += coefficients[i] * kernel(x, m, x_tails[k], support_vectors.data() + i * dim);
+                }
+                outputs[k] = sum;
+            }
+        }
+    }
+    for(size_t k = 0; k < num_inputs; ++k){
+        outputs[k] -= rho;
+    }
+}
+
+double SVRModel::kernel(const double* x, size_t m, double x_tail, const double* sv) const
+{
+    switch(kernel_type){
+    case LINEAR:
+        return dot(x, sv, m);
+    case POLY:
+        return powInt(gamma * dot(x, sv, m) + coef0, degree);
+    case RBF:
+        {
+            double d = squaredDistance(x, sv, m) + x_tail;
+            for(size_t j = m; j < dim; ++j){
+                d += sv[j] * sv[j];
+            }
+            return std::exp(-gamma * d);
+        }
+    case SIGMOID:
+    default:
+        return std::tanh(gamma * dot(x, sv, m) + coef0);
+    }
+}
+
+void SVRModel::load(const std::string& model_file_path)
+{
+    std::ifstream ifs(model_file_path);
+    if(ifs.fail()){
+        throw std::runtime_error("input file is not available: " + model_file_path);
+    }
+
+    // header
+    size_t total_sv = 0;
+    std::string line;
+    while(std::getline(ifs, line)){
+        std::istringstream is(line);
+        is.imbue(std::locale::classic());
+        std::string key;
+        is >> key;
+        if(key == "SV"){
+            break;
+        }
+        else if(key == "svm_type"){
+            std::string value;
+            is >> value;
+            if(value != "epsilon_svr" && value != "nu_svr"){
+                throw std::runtime_error("unsupported svm_type: " + value);
+            }
+        }
+        else if(key == "kernel_type"){
+            std::string value;
+            is >> value;
+            if(value == "linear"){
+                kernel_type = LINEAR;
+            }
+            else if(value == "polynomial"){
+                kernel_type = POLY;
+            }
+            else if(value == "rbf"){
+                kernel_type = RBF;
+            }
+            else if(value == "sigmoid"){
+                kernel_type = SIGMOID;
+            }
+            else{
+                throw std::runtime_error("unsupported kernel_type: " + value);
+            }
+        }
+        else if(key == "degree"){
+            is >> degree;
+        }
+        else if(key == "gamma"){
+            is >> gamma;
+        }
+        else if(key == "coef0"){
+            is >> coef0;
+        }
+        else if(key == "total_sv"){
+            is >> total_sv;
+        }
+        else if(key == "rho"){
+            is >> rho;
+        }
+        if(is.fail()){
+            throw std::runtime_error("invalid model file: " + model_file_path + ": " + line);
+        }
+    }
+
+    // support vectors as pairs of index and value
+    std::vector<std::vector<std::pair<size_t, double>>> nodes;
+    coefficients.reserve(total_sv);
+    nodes.reserve(total_sv);
+    while(std::getline(ifs, line)){
+        std::istringstream is(line);
+        is.imbue(std::locale::classic());
+        double coef;
+        if(!(is >> coef)){
+            continue;
+        }
+        coefficients.push_back(coef);
+        nodes.emplace_back();
+
+        size_t index;
+        char colon;
+        double value;
+        while(is >> index >> colon >> value){
+            if(colon != ':'){
+                throw std::runtime_error("invalid model file: " + model_file_path + ": " + line);
+            }
+            nodes.back().push_back(std::make_pair(index, value));
+            dim = std::max(dim, index + 1);
+        }
+    }
+    if(coefficients.size() != total_sv){
+        throw std::runtime_error("invalid model file: " + model_file_path + ": wrong number of support vectors");
+    }
+
+    support_vectors.assign(coefficients.size() * dim, 0.0);
+    for(size_t i = 0; i < nodes.size(); ++i){
+        for(const auto& p: nodes[i]){
+            support_vectors[i * dim + p.first] = p.second;
+        }
+    }
+}
+
+}
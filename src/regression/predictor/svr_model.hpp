@@ -0,0 +1,95 @@
+/*
+Resembla: Word-based Japanese similar sentence search library
+https://github.com/tuem/resembla
+
+Copyright 2017 Takashi Uemura
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef RESEMBLA_SVR_MODEL_HPP
+#define RESEMBLA_SVR_MODEL_HPP
+
+#include <string>
+#include <vector>
+
+namespace resembla {
+
+// read-only support vector regression model loaded from a LIBSVM model file.
+// support vectors are stored densely in a contiguous array, so prediction needs no lock
+class SVRModel
+{
+public:
+    enum KernelType
+    {
+        LINEAR,
+        POLY,
+        RBF,
+        SIGMOID
+    };
+
+    SVRModel(const std::string& model_file_path);
+
+    // x has values of features at indices of LIBSVM. absent features must be 0
+    double predict(const double* x, size_t n) const;
+
+    double predict(const std::vector<double>& x) const
+    {
+        return predict(x.data(), x.size());
+    }
+
+    // predicts num_inputs inputs stored in xs, n values for each, at once. results are same as predict(x, n)
+    void predict(const double* xs, size_t n, size_t num_inputs, double* outputs) const;
+
+    KernelType kernelType() const
+    {
+        return kernel_type;
+    }
+
+    // number of support vectors
+    size_t size() const
+    {
+        return coefficients.size();
+    }
+
+    // number of values in each support vector, i.e. maximum index + 1
+    size_t dimension() const
+    {
+        return dim;
+    }
+
+    friend class ApproximateSVRModel;
+
+protected:
+    static constexpr size_t INPUT_BLOCK_SIZE = 8;
+    static constexpr size_t SV_BLOCK_SIZE = 64;
+
+    KernelType kernel_type;
+    int degree;
+    double gamma;
+    double coef0;
+    double rho;
+
+    size_t dim;
+    // dim values for each support vector
+    std::vector<double> support_vectors;
+    std::vector<double> coefficients;
+
+    void load(const std::string& model_file_path);
+
+    // m is the number of values used in x, and x_tail is the sum of squares of the rest
+    double kernel(const double* x, size_t m, double x_tail, const double* sv) const;
+};
+
+}
+#endif
@@ -21,6 +21,7 @@ limitations under the License.
 
 #include <algorithm>
 #include <iostream>
+#include <stdexcept>
 
 namespace resembla {
 
@@ -28,58 +29,88 @@ const std::string SVRPredictor::DEFAULT_NAME = "svr";
 
 SVRPredictor::SVRPredictor(const std::vector<Feature::key_type>& feature_definitions,
         const std::string model_file_path, const std::string name):
-    name(name), feature_definitions(feature_definitions), model(svm_load_model(model_file_path.c_str()))
+    name(name), feature_definitions(feature_definitions), model(std::make_shared<SVRModel>(model_file_path))
 {}
 
-SVRPredictor::SVRPredictor(const SVRPredictor& obj):
-    name(obj.name), feature_definitions(obj.feature_definitions), model(obj.model), mutex_model()
-{}
+SVRPredictor::output_type SVRPredictor::operator()(const input_type& x) const
+{
+    auto dense = toDense(x);
+    auto s = approximation != nullptr ? approximation->predict(dense) : model->predict(dense);
+#ifdef DEBUG
+    std::cerr << "svm output=" << s << std::endl;
+#endif
+    return s;
+}
 
-SVRPredictor::~SVRPredictor()
+std::vector<SVRPredictor::output_type> SVRPredictor::operator()(const std::vector<input_type>& xs) const
 {
-    svm_free_and_destroy_model(&model);
+    const size_t n = feature_definitions.size();
+    std::vector<double> dense(xs.size() * n);
+    for(size_t k = 0; k < xs.size(); ++k){
+        toDense(xs[k], dense.data() + k * n);
+    }
+    std::vector<output_type> s(xs.size());
+    if(approximation != nullptr){
+        approximation->predict(dense.data(), n, xs.size(), s.data());
+    }
+    else{
+        model->predict(dense.data(), n, xs.size(), s.data());
+    }
+    return s;
 }
 
-SVRPredictor::output_type SVRPredictor::operator()(const input_type& x) const
+double SVRPredictor::approximate(size_t num_features, double max_error,
+        const std::vector<input_type>& validation, unsigned int seed)
 {
-    auto nodes = toNodes(x);
-    double s;
-    {
-        std::lock_guard<std::mutex> lock(mutex_model);
-        s = svm_predict(model, &nodes[0]);
+    if(validation.empty()){
+        throw std::invalid_argument("no validation inputs for approximated SVR");
+    }
+    auto approximated = std::make_shared<ApproximateSVRModel>(*model, num_features, seed);
+
+    const size_t n = feature_definitions.size();
+    std::vector<double> dense(validation.size() * n);
+    for(size_t k = 0; k < validation.size(); ++k){
+        toDense(validation[k], dense.data() + k * n);
     }
+    auto e = approximated->maxError(*model, dense.data(), n, validation.size());
 #ifdef DEBUG
-    std::cerr << "svm output=" << s << std::endl;
+    std::cerr << "SVR approximated by " << num_features << " random features: max error=" << e << std::endl;
 #endif
-    return s;
+    if(e > max_error){
+        throw std::runtime_error("error of approximated SVR exceeds max error: " + std::to_string(e));
+    }
+
+    approximation = approximated;
+    return e;
 }
 
-std::vector<svm_node> SVRPredictor::toNodes(const input_type& x) const
+std::vector<double> SVRPredictor::toDense(const input_type& x) const
 {
-    std::vector<svm_node> nodes(feature_definitions.size() + 1);
-    size_t i = 0;
-    for(size_t j = 0; j < feature_definitions.size(); ++j){
-        auto k = x.find(feature_definitions[j]);
-        if(k != std::end(x)){
-            nodes[i].index = j;
-            nodes[i].value = k->second;
-            ++i;
+    std::vector<double> dense(feature_definitions.size());
+    toDense(x, dense.data());
+    return dense;
+}
+
+// missing features are 0 as absent nodes in LIBSVM
+void SVRPredictor::toDense(const input_type& x, double* dense) const
+{
+    std::fill(dense, dense + feature_definitions.size(), 0.0);
+    for(size_t j = 0; j < feature_definitions.size() && j < x.size(); ++j){
+        if(!Feature::isMissing(x[j])){
+            dense[j] = x[j];
         }
     }
-    nodes[i].index = -1; // end of features
 #ifdef DEBUG
     std::cerr << "svm inputs:" << std::endl;
     for(size_t j = 0; j < feature_definitions.size(); ++j){
-        auto k = x.find(feature_definitions[j]);
-        if(k != std::end(x)){
-            std::cerr << "  feature: key=" << feature_definitions[j] << ", index=" << j << ", value=" << k->second << std::endl;
+        if(j < x.size() && !Feature::isMissing(x[j])){
+            std::cerr << "  feature: key=" << feature_definitions[j] << ", index=" << j << ", value=" << x[j] << std::endl;
         }
         else{
             std::cerr << "  feature: key=" << feature_definitions[j] << ", index=" << j << ", value not found" << std::endl;
         }
     }
 #endif
-    return nodes;
 }
 
 }
@@ -22,19 +22,20 @@ limitations under the License.
 
 #include <string>
 #include <vector>
-#include <mutex>
-
-#include <libsvm/svm.h>
+#include <memory>
 
 #include "../feature.hpp"
+#include "svr_model.hpp"
+#include "approximate_svr_model.hpp"
 
 namespace resembla {
 
-// LibSVM wrapper for Resembla
+// SVR with models trained by LIBSVM. predictions run concurrently without lock
 class SVRPredictor
 {
 public:
-    using input_type = FeatureMap;
+    // aggregated features in the order of feature_definitions
+    using input_type = FeatureVector;
     using output_type = Feature::real_type;
 
     static const std::string DEFAULT_NAME;
@@ -43,18 +44,25 @@ public:
 
     SVRPredictor(const std::vector<Feature::key_type>& feature_definitions,
             const std::string model_file_path, const std::string name = DEFAULT_NAME);
-    SVRPredictor(const SVRPredictor& obj);
-    virtual ~SVRPredictor();
 
     output_type operator()(const input_type& x) const;
 
+    // predicts all inputs at once
+    std::vector<output_type> operator()(const std::vector<input_type>& xs) const;
+
+    // replaces predictions by ApproximateSVRModel with num_features random features and returns its max error
+    // on validation inputs. throws if validation is empty or the error exceeds max_error
+    double approximate(size_t num_features, double max_error,
+            const std::vector<input_type>& validation, unsigned int seed = 0);
+
 protected:
     const std::vector<Feature::key_type> feature_definitions;
-    svm_model *model;
-
-    mutable std::mutex mutex_model;
+    std::shared_ptr<const SVRModel> model;
+    // nullptr unless approximated
+    std::shared_ptr<const ApproximateSVRModel> approximation;
 
-    std::vector<svm_node> toNodes(const input_type& x) const;
+    std::vector<double> toDense(const input_type& x) const;
+    void toDense(const input_type& x, double* dense) const;
 };
 
 }
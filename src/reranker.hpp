@@ -24,6 +24,14 @@ limitations under the License.
 #include <vector>
 #include <algorithm>
 #include <string>
+#include <limits>
+#include <utility>
+#include <type_traits>
+#include <iterator>
+#include <memory>
+#include <atomic>
+
+#include "thread_pool.hpp"
 
 namespace resembla {
 
@@ -33,6 +41,11 @@ class Reranker
 public:
     using output_type = std::pair<Original, double>;
 
+    // candidates are scored in parallel on pool if there are at least parallel_threshold candidates
+    Reranker(std::shared_ptr<ThreadPool> pool = nullptr, size_t parallel_threshold = 0, size_t chunk_size = 0):
+        pool(pool), parallel_threshold(parallel_threshold), chunk_size(chunk_size)
+    {}
+
     template<
         typename Iterator,
         typename ScoreFunction
@@ -54,16 +67,20 @@ public:
         }
         std::cerr << "DEBUG: " << "start reranking: threshold==" << threshold << ", max_output=" << max_output << std::endl;
 #endif
-        std::vector<output_type> result;
-        for(auto i = begin; i != end; ++i){
-            auto score = score_func(target.second, i->second);
-            if(threshold == 0.0 || score >= threshold){
-                result.push_back(std::make_pair(i->first, score));
-            }
+        using input_type = typename std::iterator_traits<Iterator>::value_type::second_type;
+        using accepts_batch = std::integral_constant<bool, AcceptsBatch<ScoreFunction, input_type>::value>;
+        auto ranked = collectAll(target, begin, end, score_func, threshold, max_output, accepts_batch());
+
+        // sort by score. candidates with the same score are kept in the original order
+        std::sort(std::begin(ranked), std::end(ranked), Precedes());
+        if(max_output != 0 && ranked.size() > max_output){
+            ranked.erase(std::begin(ranked) + max_output, std::end(ranked));
         }
-        std::sort(std::begin(result), std::end(result), Sorter());
-        if(max_output != 0 && result.size() > max_output){
-            result.erase(std::begin(result) + max_output, std::end(result));
+
+        std::vector<output_type> result;
+        result.reserve(ranked.size());
+        for(const auto& r: ranked){
+            result.push_back(std::make_pair(r.candidate->first, r.score));
         }
 #ifdef DEBUG
         std::cerr << "DEBUG: " << "===========after reranking=============" << std::endl;
@@ -74,14 +91,327 @@ public:
         return result;
     }
 
+    // thread pool used for parallel reranking, or nullptr
+    const std::shared_ptr<ThreadPool>& threadPool() const
+    {
+        return pool;
+    }
+
+    // calculates scores of all candidates without sorting. the result is aligned with candidates
+    template<
+        typename Iterator,
+        typename ScoreFunction
+    >
+    std::vector<double> score(
+        const typename std::iterator_traits<Iterator>::value_type& target,
+        const Iterator begin,
+        const Iterator end,
+        const ScoreFunction& score_func
+    ) const
+    {
+        using input_type = typename std::iterator_traits<Iterator>::value_type::second_type;
+        using accepts_batch = std::integral_constant<bool, AcceptsBatch<ScoreFunction, input_type>::value>;
+        return scoreAll(target, begin, end, score_func, accepts_batch());
+    }
+
 protected:
-    struct Sorter
+    const std::shared_ptr<ThreadPool> pool;
+    const size_t parallel_threshold;
+    const size_t chunk_size;
+
+    // number of candidates processed by a task in parallel mode
+    size_t chunkSize(size_t n) const
+    {
+        if(chunk_size > 0){
+            return chunk_size;
+        }
+        size_t num_chunks = 4 * (pool->size() + 1);
+        return std::max<size_t>(1, (n + num_chunks - 1) / num_chunks);
+    }
+
+    // runs f(first, last) for ranges of candidates, in parallel if there are enough candidates
+    template<typename F>
+    void forChunks(size_t n, F f) const
     {
-        bool operator()(const output_type& a, const output_type& b) const
+        if(pool != nullptr && parallel_threshold > 0 && n >= parallel_threshold){
+            size_t m = chunkSize(n);
+            pool->parallel_for((n + m - 1) / m, [&](size_t c){
+                f(c * m, std::min(n, (c + 1) * m));
+            });
+        }
+        else{
+            f(0, n);
+        }
+    }
+
+    template<
+        typename Iterator,
+        typename ScoreFunction
+    >
+    std::vector<double> scoreAll(
+        const typename std::iterator_traits<Iterator>::value_type& target,
+        const Iterator begin,
+        const Iterator end,
+        const ScoreFunction& score_func,
+        std::false_type
+    ) const
+    {
+        size_t n = std::distance(begin, end);
+        std::vector<double> scores(n);
+        forChunks(n, [&](size_t first, size_t last){
+            auto i = std::next(begin, first);
+            for(size_t j = first; j < last; ++j, ++i){
+                scores[j] = score_func(target.second, i->second);
+            }
+        });
+        return scores;
+    }
+
+    // passes each chunk of candidates to score_func at once
+    template<
+        typename Iterator,
+        typename ScoreFunction
+    >
+    std::vector<double> scoreAll(
+        const typename std::iterator_traits<Iterator>::value_type& target,
+        const Iterator begin,
+        const Iterator end,
+        const ScoreFunction& score_func,
+        std::true_type
+    ) const
+    {
+        using input_type = typename std::iterator_traits<Iterator>::value_type::second_type;
+
+        size_t n = std::distance(begin, end);
+        std::vector<double> scores(n);
+        forChunks(n, [&](size_t first, size_t last){
+            std::vector<const input_type*> inputs;
+            inputs.reserve(last - first);
+            auto i = std::next(begin, first);
+            for(size_t j = first; j < last; ++j, ++i){
+                inputs.push_back(&i->second);
+            }
+            auto s = score_func(target.second, inputs);
+            std::copy(std::begin(s), std::end(s), std::begin(scores) + first);
+        });
+        return scores;
+    }
+
+    template<typename Iterator>
+    struct Ranked
+    {
+        double score;
+        size_t position;
+        Iterator candidate;
+    };
+
+    // true if a precedes b in the output. ties are broken by the original order of candidates
+    struct Precedes
+    {
+        template<typename Iterator>
+        bool operator()(const Ranked<Iterator>& a, const Ranked<Iterator>& b) const
         {
-            return a.second > b.second;
+            return a.score > b.score || (a.score == b.score && a.position < b.position);
         }
     };
+
+    // detects score functions which accept a lower bound of scores to stop computation early
+    template<typename ScoreFunction, typename Input>
+    struct AcceptsFloor
+    {
+        template<typename F>
+        static auto check(int) -> decltype(
+                std::declval<const F&>()(std::declval<const Input&>(), std::declval<const Input&>(), 0.0),
+                std::true_type());
+        template<typename F>
+        static std::false_type check(...);
+
+        static constexpr bool value = decltype(check<ScoreFunction>(0))::value;
+    };
+
+    template<typename ScoreFunction, typename Input>
+    static double scoreWithFloor(const ScoreFunction& score_func, const Input& a, const Input& b, double floor, std::true_type)
+    {
+        return score_func(a, b, floor);
+    }
+
+    template<typename ScoreFunction, typename Input>
+    static double scoreWithFloor(const ScoreFunction& score_func, const Input& a, const Input& b, double, std::false_type)
+    {
+        return score_func(a, b);
+    }
+
+    // detects score functions which score a vector of candidates at once
+    template<typename ScoreFunction, typename Input>
+    struct AcceptsBatch
+    {
+        template<typename F>
+        static auto check(int) -> decltype(
+                std::declval<const F&>()(std::declval<const Input&>(), std::declval<const std::vector<const Input*>&>()),
+                std::true_type());
+        template<typename F>
+        static std::false_type check(...);
+
+        static constexpr bool value = decltype(check<ScoreFunction>(0))::value;
+    };
+
+    static double initialFloor(double threshold)
+    {
+        return threshold == 0.0 ? -std::numeric_limits<double>::infinity() : threshold;
+    }
+
+    static void raiseFloor(std::atomic<double>& floor, double s)
+    {
+        double current = floor.load();
+        while(current < s && !floor.compare_exchange_weak(current, s));
+    }
+
+    template<
+        typename Iterator,
+        typename ScoreFunction
+    >
+    std::vector<Ranked<Iterator>> collectAll(
+        const typename std::iterator_traits<Iterator>::value_type& target,
+        const Iterator begin,
+        const Iterator end,
+        const ScoreFunction& score_func,
+        double threshold,
+        size_t max_output,
+        std::false_type
+    ) const
+    {
+        std::vector<Ranked<Iterator>> ranked;
+        size_t n = std::distance(begin, end);
+        if(pool != nullptr && parallel_threshold > 0 && n >= parallel_threshold){
+            ranked = collectParallel(target, begin, n, score_func, threshold, max_output);
+        }
+        else{
+            std::atomic<double> floor(initialFloor(threshold));
+            collect(target, begin, end, 0, score_func, threshold, max_output, ranked, floor);
+        }
+        return ranked;
+    }
+
+    // scores all candidates in batches, then selects at most max_output best ones
+    template<
+        typename Iterator,
+        typename ScoreFunction
+    >
+    std::vector<Ranked<Iterator>> collectAll(
+        const typename std::iterator_traits<Iterator>::value_type& target,
+        const Iterator begin,
+        const Iterator end,
+        const ScoreFunction& score_func,
+        double threshold,
+        size_t max_output,
+        std::true_type
+    ) const
+    {
+        auto scores = scoreAll(target, begin, end, score_func, std::true_type());
+
+        std::vector<Ranked<Iterator>> ranked;
+        size_t position = 0;
+        for(auto i = begin; i != end; ++i, ++position){
+            if(threshold == 0.0 || scores[position] >= threshold){
+                ranked.push_back({scores[position], position, i});
+            }
+        }
+        if(max_output != 0 && ranked.size() > max_output){
+            std::nth_element(std::begin(ranked), std::begin(ranked) + max_output, std::end(ranked), Precedes());
+            ranked.erase(std::begin(ranked) + max_output, std::end(ranked));
+        }
+        return ranked;
+    }
+
+    // scores candidates in [begin, end) and stores at most max_output best ones (all if max_output == 0).
+    // if max_output > 0, the k-th best score is shared through floor and passed to score functions:
+    // scores below it cannot change the result, so they may be approximated by any smaller value
+    template<
+        typename Iterator,
+        typename ScoreFunction
+    >
+    void collect(
+        const typename std::iterator_traits<Iterator>::value_type& target,
+        const Iterator begin,
+        const Iterator end,
+        size_t position,
+        const ScoreFunction& score_func,
+        double threshold,
+        size_t max_output,
+        std::vector<Ranked<Iterator>>& ranked,
+        std::atomic<double>& floor
+    ) const
+    {
+        using input_type = typename std::iterator_traits<Iterator>::value_type::second_type;
+        using accepts_floor = std::integral_constant<bool, AcceptsFloor<ScoreFunction, input_type>::value>;
+
+        if(max_output == 0){
+            for(auto i = begin; i != end; ++i, ++position){
+                auto s = scoreWithFloor(score_func, target.second, i->second, initialFloor(threshold), accepts_floor());
+                if(threshold == 0.0 || s >= threshold){
+                    ranked.push_back({s, position, i});
+                }
+            }
+            return;
+        }
+
+        // bounded min-heap of the best candidates
+        ranked.reserve(max_output);
+        for(auto i = begin; i != end; ++i, ++position){
+            auto s = scoreWithFloor(score_func, target.second, i->second, floor.load(), accepts_floor());
+            if(threshold != 0.0 && s < threshold){
+                continue;
+            }
+
+            if(ranked.size() < max_output){
+                ranked.push_back({s, position, i});
+                std::push_heap(std::begin(ranked), std::end(ranked), Precedes());
+            }
+            else if(s > ranked.front().score){
+                std::pop_heap(std::begin(ranked), std::end(ranked), Precedes());
+                ranked.back() = {s, position, i};
+                std::push_heap(std::begin(ranked), std::end(ranked), Precedes());
+            }
+            else{
+                continue;
+            }
+            if(ranked.size() == max_output){
+                raiseFloor(floor, ranked.front().score);
+            }
+        }
+    }
+
+    // splits candidates into chunks and scores them on the thread pool, then merges the results of chunks
+    template<
+        typename Iterator,
+        typename ScoreFunction
+    >
+    std::vector<Ranked<Iterator>> collectParallel(
+        const typename std::iterator_traits<Iterator>::value_type& target,
+        const Iterator begin,
+        size_t n,
+        const ScoreFunction& score_func,
+        double threshold,
+        size_t max_output
+    ) const
+    {
+        size_t m = chunkSize(n);
+        size_t num_chunks = (n + m - 1) / m;
+
+        std::vector<std::vector<Ranked<Iterator>>> chunks(num_chunks);
+        std::atomic<double> floor(initialFloor(threshold));
+        pool->parallel_for(num_chunks, [&](size_t c){
+            auto first = std::next(begin, c * m);
+            auto last = std::next(first, std::min(m, n - c * m));
+            collect(target, first, last, c * m, score_func, threshold, max_output, chunks[c], floor);
+        });
+
+        std::vector<Ranked<Iterator>> ranked;
+        for(const auto& chunk: chunks){
+            std::copy(std::begin(chunk), std::end(chunk), std::back_inserter(ranked));
+        }
+        return ranked;
+    }
 };
 
 }
@@ -18,68 +18,275 @@ limitations under the License.
 */
 
 #include "resembla_ensemble.hpp"
+#include "analysis_context.hpp"
 
 #include <math.h>
 #include <algorithm>
+#include <unordered_set>
+#include <chrono>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <stdexcept>
+
+#ifdef DEBUG
+#include <iostream>
+#endif
 
 namespace resembla {
 
-ResemblaEnsemble::ResemblaEnsemble(const std::string& measure_name, const size_t max_reranking_num):
-    measure_name(measure_name), max_reranking_num(max_reranking_num), total_weight(0.0) {}
+template<typename Result>
+struct ResemblaEnsemble::Fanout
+{
+    std::function<Result(const ResemblaInterface&, size_t)> run;
+    std::vector<std::pair<std::shared_ptr<ResemblaInterface>, double>> resemblas;
+    // children other than the first are not started after deadline if has_deadline is true
+    const std::chrono::steady_clock::time_point deadline;
+    const bool has_deadline;
+
+    std::mutex mutex;
+    std::condition_variable finished;
+    std::vector<bool> started;
+    std::vector<bool> done;
+    std::vector<bool> expired;
+    size_t num_done;
+    std::vector<Result> results;
+    std::vector<std::exception_ptr> errors;
+
+    Fanout(std::function<Result(const ResemblaInterface&, size_t)> run,
+            const std::vector<std::pair<std::shared_ptr<ResemblaInterface>, double>>& resemblas,
+            std::chrono::steady_clock::time_point deadline, bool has_deadline):
+        run(run), resemblas(resemblas), deadline(deadline), has_deadline(has_deadline),
+        started(resemblas.size(), false), done(resemblas.size(), false), expired(resemblas.size(), false),
+        num_done(0), results(resemblas.size()), errors(resemblas.size())
+    {}
+
+    // runs i-th child unless another thread has already started it.
+    // a child not started by the deadline is skipped, since the caller has already dropped its result
+    void process(size_t i)
+    {
+        bool skip;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if(started[i]){
+                return;
+            }
+            started[i] = true;
+            skip = i > 0 && has_deadline && std::chrono::steady_clock::now() >= deadline;
+            if(skip){
+                expired[i] = true;
+                done[i] = true;
+                ++num_done;
+            }
+        }
+        if(skip){
+#ifdef DEBUG
+            std::cerr << "DEBUG: " << "timeout: measure " << i << " was skipped" << std::endl;
+#endif
+            finished.notify_all();
+            return;
+        }
+
+        Result result;
+        std::exception_ptr error;
+        try{
+            result = run(*resemblas[i].first, i);
+        }
+        catch(...){
+            error = std::current_exception();
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            results[i] = std::move(result);
+            errors[i] = error;
+            done[i] = true;
+            ++num_done;
+        }
+        finished.notify_all();
+    }
+};
+
+ResemblaEnsemble::ResemblaEnsemble(const std::string& measure_name, const size_t max_reranking_num,
+        std::shared_ptr<ThreadPool> pool, const size_t timeout, const bool share_candidates,
+        std::shared_ptr<ThreadPool> batch_pool):
+    measure_name(measure_name), max_reranking_num(max_reranking_num), pool(pool), timeout(timeout),
+    batch_pool(batch_pool), share_candidates(share_candidates)
+{
+    if(batch_pool != nullptr && batch_pool == pool){
+        throw std::invalid_argument("batch_pool must be different from pool");
+    }
+}
 
-void ResemblaEnsemble::append(const std::shared_ptr<ResemblaInterface> resembla, const double weight)
+void ResemblaEnsemble::append(const std::shared_ptr<ResemblaInterface> resembla, const double weight,
+        const bool candidate_source)
 {
     resemblas.push_back(std::make_pair(resembla, weight));
-    total_weight += weight;
+    candidate_sources.push_back(candidate_source);
 }
 
 std::vector<ResemblaEnsemble::output_type> ResemblaEnsemble::find(const string_type& query,
         double threshold, size_t max_response) const
 {
+    AnalysisContext::Scope scope(query);
+    if(share_candidates){
+        auto targets = candidates(query);
+        return eval(targets, score(query, targets), threshold, max_response);
+    }
+
     double t = max_reranking_num > 0 ? 0.0 : threshold;
     size_t n = max_reranking_num > 0 ? max_reranking_num : max_response;
 
     // find similar texts using all measures
-    std::unordered_map<string_type, double> aggregated;
-    for(auto p: resemblas){
-        for(auto r: p.first->find(query, t, n)){
-            if(aggregated.find(r.text) == std::end(aggregated)){
-                aggregated[r.text] = 0.0;
-            }
-            aggregated.at(r.text) += p.second * r.score * r.score;
-        }
-    }
-
-    return eval(aggregated, threshold, max_response);
+    return aggregate(fanout<std::vector<output_type>>([query, t, n](const ResemblaInterface& resembla, size_t){
+                return resembla.find(query, t, n);
+            }), threshold, max_response);
 }
 
 std::vector<ResemblaInterface::output_type> ResemblaEnsemble::eval(const string_type& query,
         const std::vector<string_type>& targets, double threshold, size_t max_response) const
 {
+    AnalysisContext::Scope scope(query);
+    if(share_candidates){
+        return eval(targets, score(query, targets), threshold, max_response);
+    }
+
     double t = max_reranking_num > 0 ? 0.0 : threshold;
     size_t n = max_reranking_num > 0 ? max_reranking_num : max_response;
 
     // calculate similarity using all measures
-    std::unordered_map<string_type, double> aggregated;
-    for(auto p: resemblas){
-        for(auto r: p.first->eval(query, targets, t, n)){
-            if(aggregated.find(r.text) == std::end(aggregated)){
-                aggregated[r.text] = 0.0;
+    return aggregate(fanout<std::vector<output_type>>([query, targets, t, n](const ResemblaInterface& resembla, size_t){
+                return resembla.eval(query, targets, t, n);
+            }), threshold, max_response);
+}
+
+std::vector<string_type> ResemblaEnsemble::candidates(const string_type& query) const
+{
+    AnalysisContext::Scope scope(query);
+    auto sources = candidate_sources;
+    std::vector<string_type> targets;
+    std::unordered_set<string_type> retrieved;
+    for(const auto& r: fanout<std::vector<string_type>>([query, sources](const ResemblaInterface& resembla, size_t i){
+                return sources[i] ? resembla.candidates(query) : std::vector<string_type>();
+            })){
+        for(const auto& c: r.second){
+            if(retrieved.insert(c).second){
+                targets.push_back(c);
             }
-            aggregated.at(r.text) += p.second * r.score * r.score;
         }
     }
+    return targets;
+}
 
-    return eval(aggregated, threshold, max_response);
+std::vector<double> ResemblaEnsemble::score(const string_type& query, const std::vector<string_type>& targets) const
+{
+    AnalysisContext::Scope scope(query);
+    // scores are aligned with targets, so they are aggregated by index
+    std::vector<double> aggregated(targets.size(), 0.0);
+    double weight = 0.0;
+    for(const auto& r: fanout<std::vector<double>>([query, targets](const ResemblaInterface& resembla, size_t){
+                return resembla.score(query, targets);
+            })){
+        double w = resemblas[r.first].second;
+        for(size_t i = 0; i < r.second.size(); ++i){
+            aggregated[i] += w * r.second[i] * r.second[i];
+        }
+        weight += w;
+    }
+
+    if(weight > 0.0){
+        for(auto& s: aggregated){
+            s = sqrt(s / weight);
+        }
+    }
+    return aggregated;
 }
 
-std::vector<ResemblaInterface::output_type> ResemblaEnsemble::eval(
-        const std::unordered_map<string_type, double>& aggregated, double threshold, size_t max_response) const
+std::shared_ptr<ThreadPool> ResemblaEnsemble::batchPool() const
 {
+    return batch_pool;
+}
+
+template<typename Result>
+std::vector<std::pair<size_t, Result>> ResemblaEnsemble::fanout(
+        std::function<Result(const ResemblaInterface&, size_t)> run) const
+{
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout);
+    auto state = std::make_shared<Fanout<Result>>(run, resemblas, deadline, timeout > 0);
+    if(pool == nullptr){
+        for(size_t i = 0; i < resemblas.size(); ++i){
+            state->process(i);
+        }
+    }
+    else if(!resemblas.empty()){
+        // children running on workers share the analysis context of the calling thread
+        auto context = AnalysisContext::current();
+        for(size_t i = 1; i < resemblas.size(); ++i){
+            pool->submit([state, i, context](){
+                AnalysisContext::Scope scope(context);
+                state->process(i);
+            });
+        }
+        // the calling thread runs the first child, so at least one child always responds
+        state->process(0);
+        // without timeout, also run children which no worker has started yet to avoid waiting for busy workers.
+        // on a worker of pool, e.g. in a nested ensemble, other workers may be waiting for this one, so do the same.
+        // otherwise, children not started by the deadline are dropped as well as slow ones
+        if(timeout == 0 || pool->is_worker()){
+            for(size_t i = 1; i < resemblas.size(); ++i){
+                state->process(i);
+            }
+        }
+    }
+
+    // collect results of children finished in time. weights of the others are excluded by callers
+    std::vector<std::pair<size_t, Result>> results;
+    std::unique_lock<std::mutex> lock(state->mutex);
+    auto all_done = [&state](){
+        return state->num_done == state->resemblas.size();
+    };
+    if(timeout > 0){
+        state->finished.wait_until(lock, deadline, all_done);
+    }
+    else{
+        state->finished.wait(lock, all_done);
+    }
+    for(size_t i = 0; i < resemblas.size(); ++i){
+        if(!state->done[i] || state->expired[i]){
+#ifdef DEBUG
+            std::cerr << "DEBUG: " << "timeout: measure " << i << " in " << measure_name << " was dropped" << std::endl;
+#endif
+            continue;
+        }
+        if(state->errors[i]){
+            std::rethrow_exception(state->errors[i]);
+        }
+        results.push_back(std::make_pair(i, std::move(state->results[i])));
+    }
+    return results;
+}
+
+std::vector<ResemblaInterface::output_type> ResemblaEnsemble::aggregate(
+        const std::vector<std::pair<size_t, std::vector<output_type>>>& results,
+        double threshold, size_t max_response) const
+{
+    // weighted root mean square of scores. texts not returned by a measure have score 0 in it
+    std::unordered_map<string_type, double> aggregated;
+    double weight = 0.0;
+    for(const auto& r: results){
+        for(const auto& o: r.second){
+            aggregated[o.text] += resemblas[r.first].second * o.score * o.score;
+        }
+        weight += resemblas[r.first].second;
+    }
+
     // sort combined result
     std::vector<output_type> response;
+    if(weight <= 0.0){
+        return response;
+    }
     for(auto r: aggregated){
-        double score = sqrt(r.second / total_weight);
+        double score = sqrt(r.second / weight);
         if(score >= threshold){
             response.push_back({r.first, measure_name, score});
         }
@@ -93,4 +300,24 @@ std::vector<ResemblaInterface::output_type> ResemblaEnsemble::eval(
     return response;
 }
 
+std::vector<ResemblaInterface::output_type> ResemblaEnsemble::eval(const std::vector<string_type>& targets,
+        const std::vector<double>& scores, double threshold, size_t max_response) const
+{
+    std::vector<output_type> response;
+    for(size_t i = 0; i < targets.size(); ++i){
+        if(scores[i] >= threshold){
+            auto tabpos = targets[i].find(column_delimiter<string_type::value_type>());
+            response.push_back({tabpos != string_type::npos ? targets[i].substr(0, tabpos) : targets[i],
+                    measure_name, scores[i]});
+        }
+    }
+    std::stable_sort(std::begin(response), std::end(response));
+
+    // return at most max_response responses
+    if(max_response != 0 && response.size() > max_response){
+        response.erase(std::begin(response) + max_response, std::end(response));
+    }
+    return response;
+}
+
 }
@@ -24,34 +24,68 @@ limitations under the License.
 #include <vector>
 #include <memory>
 #include <unordered_map>
+#include <functional>
 
 #include "resembla_interface.hpp"
+#include "thread_pool.hpp"
 
 namespace resembla {
 
 class ResemblaEnsemble: public ResemblaInterface
 {
 public:
-    ResemblaEnsemble(const std::string& measure_name, const size_t max_reranking_num = 0);
-
-    void append(const std::shared_ptr<ResemblaInterface> resembla, const double weight = 1.0);
+    // if pool is given, child measures run concurrently and those not finished within timeout milliseconds
+    // are dropped from the response with their weights (no timeout if timeout == 0).
+    // children which no worker has started by then are not run at all.
+    // the first child always runs on the calling thread and is never dropped.
+    // if share_candidates is true, candidates are retrieved once by candidate sources and scored by all measures.
+    // queries in batch run concurrently on batch_pool if given, otherwise one by one. batch_pool must not be pool,
+    // since children submitted to pool would wait for workers busy with other queries
+    ResemblaEnsemble(const std::string& measure_name, const size_t max_reranking_num = 0,
+            std::shared_ptr<ThreadPool> pool = nullptr, const size_t timeout = 0, const bool share_candidates = false,
+            std::shared_ptr<ThreadPool> batch_pool = nullptr);
+
+    void append(const std::shared_ptr<ResemblaInterface> resembla, const double weight = 1.0,
+            const bool candidate_source = true);
 
     std::vector<output_type> find(const string_type& input, double threshold = 0.0, size_t max_response = 0) const;
     std::vector<output_type> eval(const string_type& query, const std::vector<string_type>& targets,
             double threshold = 0.0, size_t max_response = 0) const;
 
+    // union of candidates retrieved by candidate sources
+    std::vector<string_type> candidates(const string_type& input) const;
+    std::vector<double> score(const string_type& input, const std::vector<string_type>& targets) const;
+
 protected:
     // name to be used in response
     const std::string measure_name;
 
     const size_t max_reranking_num;
 
-    double total_weight;
+    const std::shared_ptr<ThreadPool> pool;
+    const size_t timeout;
+
+    const std::shared_ptr<ThreadPool> batch_pool;
+
+    const bool share_candidates;
 
     // pairs of Resembla and its weight
     std::vector<std::pair<std::shared_ptr<ResemblaInterface>, double>> resemblas;
+    std::vector<bool> candidate_sources;
 
-    std::vector<output_type> eval(const std::unordered_map<string_type, double>& aggregated,
+    std::shared_ptr<ThreadPool> batchPool() const;
+
+    // state of a request shared with child tasks, which may outlive the request if they time out
+    template<typename Result> struct Fanout;
+
+    // runs run(resemblas[i].first, i) for all children and returns the results of those finished in time
+    template<typename Result>
+    std::vector<std::pair<size_t, Result>> fanout(std::function<Result(const ResemblaInterface&, size_t)> run) const;
+
+    // combines responses of children returned by fanout
+    std::vector<output_type> aggregate(const std::vector<std::pair<size_t, std::vector<output_type>>>& results,
+            double threshold, size_t max_response) const;
+    std::vector<output_type> eval(const std::vector<string_type>& targets, const std::vector<double>& scores,
             double threshold, size_t max_response) const;
 };
 
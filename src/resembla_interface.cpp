@@ -19,8 +19,92 @@ limitations under the License.
 
 #include "resembla_interface.hpp"
 
+#include <unordered_map>
+#include <algorithm>
+#include <stdexcept>
+
 namespace resembla {
 
 ResemblaInterface::~ResemblaInterface(){}
 
+std::vector<string_type> ResemblaInterface::candidates(const string_type& input) const
+{
+    std::vector<string_type> texts;
+    for(const auto& r: find(input)){
+        texts.push_back(r.text);
+    }
+    return texts;
+}
+
+std::vector<double> ResemblaInterface::score(const string_type& input, const std::vector<string_type>& candidates) const
+{
+    std::unordered_map<string_type, double> scores;
+    for(const auto& r: eval(input, candidates)){
+        scores[r.text] = r.score;
+    }
+
+    std::vector<double> result;
+    result.reserve(candidates.size());
+    for(const auto& c: candidates){
+        auto tabpos = c.find(column_delimiter<string_type::value_type>());
+        const auto i = scores.find(tabpos != string_type::npos ? c.substr(0, tabpos) : c);
+        result.push_back(i != std::end(scores) ? i->second : 0.0);
+    }
+    return result;
+}
+
+std::vector<std::vector<ResemblaInterface::output_type>> ResemblaInterface::find_batch(
+        const std::vector<string_type>& inputs, double threshold, size_t max_response) const
+{
+    std::vector<std::vector<output_type>> results(inputs.size());
+    forEachQuery(inputs, batchPool(), [&](size_t i){
+        results[i] = find(inputs[i], threshold, max_response);
+    });
+    return results;
+}
+
+std::vector<std::vector<ResemblaInterface::output_type>> ResemblaInterface::eval_batch(
+        const std::vector<string_type>& inputs, const std::vector<std::vector<string_type>>& candidates,
+        double threshold, size_t max_response) const
+{
+    if(inputs.size() != candidates.size()){
+        throw std::invalid_argument("sizes of inputs and candidates must be the same");
+    }
+
+    std::vector<std::vector<output_type>> results(inputs.size());
+    forEachQuery(inputs, batchPool(), [&](size_t i){
+        results[i] = eval(inputs[i], candidates[i], threshold, max_response);
+    });
+    return results;
+}
+
+std::shared_ptr<ThreadPool> ResemblaInterface::batchPool() const
+{
+    return nullptr;
+}
+
+void ResemblaInterface::forEachQuery(const std::vector<string_type>& inputs, const std::shared_ptr<ThreadPool>& pool,
+        const std::function<void(size_t)>& process)
+{
+    // similar queries are processed close together
+    std::vector<size_t> order(inputs.size());
+    for(size_t i = 0; i < order.size(); ++i){
+        order[i] = i;
+    }
+    std::stable_sort(std::begin(order), std::end(order), [&inputs](size_t a, size_t b){
+        return inputs[a].size() < inputs[b].size();
+    });
+
+    if(pool == nullptr){
+        for(auto i: order){
+            process(i);
+        }
+    }
+    else{
+        pool->parallel_for(order.size(), [&](size_t i){
+            process(order[i]);
+        });
+    }
+}
+
 }
@@ -21,8 +21,11 @@ limitations under the License.
 #define RESEMBLA_RESEMBLA_INTERFACE_HPP
 
 #include <vector>
+#include <memory>
+#include <functional>
 
 #include "resembla_response.hpp"
+#include "thread_pool.hpp"
 
 namespace resembla {
 
@@ -35,6 +38,25 @@ public:
     virtual std::vector<output_type> find(const string_type& input, double threshold = 0.0, size_t max_response = 0) const = 0;
     virtual std::vector<output_type> eval(const string_type& input, const std::vector<string_type>& candidates,
             double threshold = 0.0, size_t max_response = 0) const = 0;
+
+    // retrieves candidate texts for input without scoring them
+    virtual std::vector<string_type> candidates(const string_type& input) const;
+    // calculates similarity of each candidate. the result is aligned with candidates
+    virtual std::vector<double> score(const string_type& input, const std::vector<string_type>& candidates) const;
+
+    // process multiple queries at once. results are aligned with inputs
+    virtual std::vector<std::vector<output_type>> find_batch(const std::vector<string_type>& inputs,
+            double threshold = 0.0, size_t max_response = 0) const;
+    virtual std::vector<std::vector<output_type>> eval_batch(const std::vector<string_type>& inputs,
+            const std::vector<std::vector<string_type>>& candidates, double threshold = 0.0, size_t max_response = 0) const;
+
+protected:
+    // thread pool to process queries in batch. queries are processed on the calling thread if nullptr
+    virtual std::shared_ptr<ThreadPool> batchPool() const;
+
+    // calls process(i) for each input in ascending order of length, on pool if given
+    static void forEachQuery(const std::vector<string_type>& inputs, const std::shared_ptr<ThreadPool>& pool,
+            const std::function<void(size_t)>& process);
 };
 
 }
@@ -25,13 +25,20 @@ limitations under the License.
 #include <memory>
 #include <unordered_map>
 #include <fstream>
+#include <array>
+#include <functional>
+#include <stdexcept>
+#include <algorithm>
+#include <limits>
 
 #include <simstring/simstring.h>
 #include <json.hpp>
 
 #include "resembla_interface.hpp"
+#include "analysis_context.hpp"
 #include "eliminator.hpp"
 #include "reranker.hpp"
+#include "cascade.hpp"
 #include "regression/feature.hpp"
 #include "regression/extractor/feature_extractor.hpp"
 
@@ -45,9 +52,10 @@ public:
             const std::string& db_path, const std::string& inverse_path,
             const int simstring_measure, const double simstring_threshold, const size_t max_candidate,
             std::shared_ptr<Indexer> indexer, std::shared_ptr<FeatureExtractor> feature_extractor,
-            std::shared_ptr<ScoreFunction> score_func):
+            std::shared_ptr<ScoreFunction> score_func, const Reranker<string_type>& reranker = Reranker<string_type>()):
         simstring_measure(simstring_measure), simstring_threshold(simstring_threshold), max_candidate(max_candidate),
-        indexer(indexer), preprocess(feature_extractor), score_func(score_func), reranker()
+        indexer(indexer), preprocess(feature_extractor), score_func(score_func), reranker(reranker),
+        primary_child(FeatureSchema::npos)
     {
         db.open(db_path);
         load(inverse_path);
@@ -55,14 +63,58 @@ public:
 
     void append(const std::string name, const std::shared_ptr<ResemblaInterface> resembla, bool is_primary = true)
     {
-        resemblas[name] = resembla;
+        // scores of child Resemblas are given as the feature with the same name
+        auto child = FeatureSchema::npos;
+        auto r = resemblas.find(name);
+        if(r != std::end(resemblas)){
+            child = r->second.first;
+        }
+        else{
+            auto i = preprocess->schema().find(name);
+            if(i != FeatureSchema::npos){
+                if(child_offsets.size() == MAX_CHILD_SCORES){
+                    throw std::invalid_argument("too many child Resemblas with features");
+                }
+                child = child_offsets.size();
+                child_offsets.push_back(preprocess->schema().offset(i));
+            }
+        }
+        resemblas[name] = std::make_pair(child, resembla);
         if(is_primary && primary_resembla_name.empty()){
             primary_resembla_name = name;
+            primary_child = child;
         }
     }
 
+    // candidates are passed to the score function only if they are in top cascade_size by the score of primary Resembla
+    // (all if 0) and the score is at least cascade_min_score. every cascade_check_interval-th query dropping candidates
+    // is also processed without cascade to count changes of results (never if 0)
+    void setCascade(size_t cascade_size, double cascade_min_score = 0.0, size_t cascade_check_interval = 0)
+    {
+        cascade.configure(cascade_size, cascade_min_score, cascade_check_interval);
+    }
+
+    // number of queries in which cascade dropped candidates
+    size_t cascadedQueries() const
+    {
+        return cascade.cascadedQueries();
+    }
+
+    // number of cascaded queries also processed without cascade
+    size_t checkedQueries() const
+    {
+        return cascade.checkedQueries();
+    }
+
+    // number of checked queries in which cascade changed results
+    size_t changedQueries() const
+    {
+        return cascade.changedQueries();
+    }
+
     std::vector<output_type> find(const string_type& query, double threshold = 0.0, size_t max_response = 0) const
     {
+        AnalysisContext::Scope scope(query);
         string_type search_query = indexer->index(query);
 
         // search from N-gram index
@@ -75,7 +127,9 @@ public:
             return {};
         }
         else if(simstring_result.size() > max_candidate){
-            Eliminator<string_type> eliminate(search_query);
+            // reuse buffers of eliminator in each thread
+            thread_local Eliminator<string_type> eliminate;
+            eliminate.init(search_query);
             eliminate(simstring_result, max_candidate, true);
         }
 
@@ -89,46 +143,109 @@ public:
             std::copy(std::begin(j), std::end(j), std::back_inserter(candidate_texts));
         }
 
-        // load pre-computed features
-        std::unordered_map<string_type, StringFeatureMap> candidate_features;
+        // refer to pre-computed features
+        std::vector<WorkData> candidates;
+        CandidateIndex index;
         for(const auto& c: candidate_texts){
-            candidate_features[c] = corpus_features.at(c);
+            addCandidate(c, corpus_features.at(c), candidates, index);
         }
 
         // compute similarity using child Resembla
-        for(const auto& p: resemblas){
-            for(auto r: p.second->eval(query, candidate_texts, 0.0, 0)){
-                candidate_features[r.text][p.first] = Feature::toText(r.score);
-            }
-        }
+        setChildScores(query, candidate_texts, candidates, index);
 
-        return eval(query, candidate_features, threshold, max_response);
+        return eval(query, candidates, threshold, max_response);
     }
 
     std::vector<output_type> eval(const string_type& query, const std::vector<string_type>& candidates,
             double threshold = 0.0, size_t max_response = 0) const
     {
-        std::unordered_map<string_type, StringFeatureMap> candidate_features;
+        AnalysisContext::Scope scope(query);
+        std::vector<WorkData> candidate_features;
+        CandidateIndex index;
+        // features of texts not in corpus. reserved not to move vectors referred by candidate_features
+        std::vector<FeatureVector> extracted;
+        extracted.reserve(candidates.size());
         for(const auto& c: candidates){
             auto i = corpus_features.find(c);
             if(i != std::end(corpus_features)){
-                candidate_features[c] = i->second;
-                continue;
+                addCandidate(c, i->second, candidate_features, index);
             }
-            candidate_features[c] = (*preprocess)(c);
-        }
-
-        for(const auto& p: resemblas){
-            for(const auto& r: p.second->eval(query, candidates, 0.0, 0)){
-                candidate_features[r.text][p.first] = Feature::toText(r.score);
+            else if(index.find(c) == std::end(index)){
+                extracted.push_back((*preprocess)(c));
+                addCandidate(c, extracted.back(), candidate_features, index);
             }
         }
 
+        setChildScores(query, candidates, candidate_features, index);
+
         return eval(query, candidate_features, threshold, max_response);
     }
 
 protected:
-    using WorkData = std::pair<string_type, typename FeatureExtractor::output_type>;
+    // max number of child Resemblas whose scores are used as features
+    static constexpr size_t MAX_CHILD_SCORES = 4;
+
+    // features of a text for a query. extracted features are shared with corpus_features,
+    // and scores of child Resemblas are kept for each candidate in the order of child_offsets
+    struct CandidateFeatures
+    {
+        const FeatureVector* extracted;
+        std::array<Feature::real_type, MAX_CHILD_SCORES> child_scores;
+
+        CandidateFeatures(const FeatureVector& extracted): extracted(&extracted)
+        {
+            child_scores.fill(Feature::missing());
+        }
+    };
+
+    using WorkData = std::pair<string_type, CandidateFeatures>;
+
+    // positions of candidates in work data
+    using CandidateIndex = std::unordered_map<std::reference_wrapper<const string_type>, size_t,
+            std::hash<string_type>, std::equal_to<string_type>>;
+
+    // passes extracted vectors with scores of child Resemblas to score_func.
+    // scores are overlaid on the vectors in corpus_features without copying them
+    class CandidateScoreFunction
+    {
+    public:
+        CandidateScoreFunction(const ScoreFunction& score_func, const std::vector<size_t>& child_offsets):
+            score_func(score_func), child_offsets(child_offsets)
+        {}
+
+        double operator()(const CandidateFeatures& a, const CandidateFeatures& b) const
+        {
+            return score_func(merge(a), merge(b));
+        }
+
+        // available if score_func accepts a vector of candidates
+        template<typename F = ScoreFunction>
+        auto operator()(const CandidateFeatures& a, const std::vector<const CandidateFeatures*>& bs) const
+            -> decltype(std::declval<const F&>()(std::declval<const FeatureOverlay&>(),
+                    std::declval<const std::vector<const FeatureOverlay*>&>()))
+        {
+            std::vector<FeatureOverlay> overlays;
+            overlays.reserve(bs.size());
+            for(const auto b: bs){
+                overlays.push_back(merge(*b));
+            }
+            std::vector<const FeatureOverlay*> merged;
+            merged.reserve(overlays.size());
+            for(const auto& o: overlays){
+                merged.push_back(&o);
+            }
+            return score_func(merge(a), merged);
+        }
+
+        FeatureOverlay merge(const CandidateFeatures& c) const
+        {
+            return FeatureOverlay(*c.extracted, child_offsets, c.child_scores.data());
+        }
+
+    private:
+        const ScoreFunction& score_func;
+        const std::vector<size_t>& child_offsets;
+    };
 
     mutable simstring::reader db;
     std::unordered_map<string_type, std::vector<string_type>> inverse;
@@ -137,8 +254,11 @@ protected:
     const double simstring_threshold;
     const size_t max_candidate;
 
-    std::unordered_map<std::string, std::shared_ptr<ResemblaInterface>> resemblas;
+    // child Resemblas with the indices of their scores in child_scores, or FeatureSchema::npos if not used as features
+    std::unordered_map<std::string, std::pair<size_t, std::shared_ptr<ResemblaInterface>>> resemblas;
     std::string primary_resembla_name;
+    // positions of the features given by child Resemblas in extracted vectors
+    std::vector<size_t> child_offsets;
 
     const std::shared_ptr<Indexer> indexer;
     const std::shared_ptr<FeatureExtractor> preprocess;
@@ -147,8 +267,18 @@ protected:
 
     std::unordered_map<string_type, typename FeatureExtractor::output_type> corpus_features;
 
+    // index of the score of primary Resembla in child_scores
+    size_t primary_child;
+
+    Cascade cascade;
+
     mutable std::mutex mutex_simstring;
 
+    std::shared_ptr<ThreadPool> batchPool() const
+    {
+        return reranker.threadPool();
+    }
+
     void load(const std::string& inverse_path)
     {
         std::ifstream ifs(inverse_path);
@@ -188,40 +318,106 @@ protected:
                 std::cerr << "load from JSON: " << features << std::endl;
 #endif
                 nlohmann::json j = nlohmann::json::parse(features);
-                typename FeatureExtractor::output_type preprocessed;
+                StringFeatureMap preprocessed;
                 for(nlohmann::json::iterator i = std::begin(j); i != std::end(j); ++i){
                     preprocessed[i.key()] = i.value();
                 }
-                corpus_features[original] = preprocessed;
+                corpus_features[original] = preprocess->schema().parse(preprocessed);
             }
             else{
 #ifdef DEBUG
                 std::cerr << "preprocess: " << cast_string<std::string>(original) << std::endl;
 #endif
-                corpus_features[original] = (*preprocess)(original, "");
+                corpus_features[original] = (*preprocess)(original);
             }
         }
     }
 
-    std::vector<output_type> eval(const string_type& query,
-            const std::unordered_map<string_type, StringFeatureMap>& candidate_features,
+    // appends a candidate unless it is already in candidates. text is referred by index, so it must outlive index
+    static void addCandidate(const string_type& text, const FeatureVector& extracted,
+            std::vector<WorkData>& candidates, CandidateIndex& index)
+    {
+        if(index.find(text) != std::end(index)){
+            return;
+        }
+        candidates.push_back(std::make_pair(text, CandidateFeatures(extracted)));
+        index.emplace(std::cref(text), candidates.size() - 1);
+    }
+
+    void setChildScores(const string_type& query, const std::vector<string_type>& texts,
+            std::vector<WorkData>& candidates, const CandidateIndex& index) const
+    {
+        for(const auto& p: resemblas){
+            const auto child = p.second.first;
+            if(child == FeatureSchema::npos){
+                continue;
+            }
+            for(const auto& r: p.second.second->eval(query, texts, 0.0, 0)){
+                auto i = index.find(r.text);
+                if(i != std::end(index)){
+                    candidates[i->second].second.child_scores[child] = r.score;
+                }
+            }
+        }
+    }
+
+    std::vector<output_type> eval(const string_type& query, std::vector<WorkData>& candidates,
             double threshold, size_t max_response) const
     {
-        // prepare data for reranking
-        std::vector<WorkData> candidates;
-        for(const auto& c: candidate_features){
-            candidates.push_back(std::make_pair(c.first, c.second));
+        const auto query_features = (*preprocess)(query);
+        WorkData input_data = std::make_pair(query, CandidateFeatures(query_features));
+
+        if(primary_child == FeatureSchema::npos || !cascade.enabled()){
+            return rerank(input_data, std::begin(candidates), std::end(candidates), threshold, max_response);
+        }
+
+        std::vector<double> primary_scores;
+        for(const auto& c: candidates){
+            auto s = c.second.child_scores[primary_child];
+            primary_scores.push_back(Feature::isMissing(s) ? -std::numeric_limits<double>::infinity() : s);
+        }
+        auto selected = cascade.select(primary_scores);
+        if(selected.size() == candidates.size()){
+            return rerank(input_data, std::begin(candidates), std::end(candidates), threshold, max_response);
+        }
+
+        std::vector<output_type> all_results;
+        bool check = cascade.countCascaded();
+        if(check){
+            all_results = rerank(input_data, std::begin(candidates), std::end(candidates), threshold, max_response);
         }
-        WorkData input_data = std::make_pair(query, (*preprocess)(query));
 
+        // selected candidates are passed in the original order, so ties are ranked as without cascade
+        std::vector<WorkData> passed;
+        passed.reserve(selected.size());
+        for(auto i: selected){
+            passed.push_back(std::move(candidates[i]));
+        }
+        auto results = rerank(input_data, std::begin(passed), std::end(passed), threshold, max_response);
+        if(check && !sameTexts(all_results, results)){
+            cascade.countChanged();
+        }
+        return results;
+    }
+
+    template<typename Iterator>
+    std::vector<output_type> rerank(const WorkData& input_data, Iterator begin, Iterator end,
+            double threshold, size_t max_response) const
+    {
         // rerank by regression
         std::vector<ResemblaInterface::output_type> results;
-        for(const auto& r: reranker.rerank(input_data, std::begin(candidates), std::end(candidates),
-                *score_func, threshold, max_response)){
+        CandidateScoreFunction candidate_score_func(*score_func, child_offsets);
+        for(const auto& r: reranker.rerank(input_data, begin, end, candidate_score_func, threshold, max_response)){
             results.push_back({r.first, score_func->name, std::max(std::min(r.second, 1.0), 0.0)});
         }
         return results;
     }
+
+    static bool sameTexts(const std::vector<output_type>& a, const std::vector<output_type>& b)
+    {
+        return a.size() == b.size() && std::equal(std::begin(a), std::end(a), std::begin(b),
+                [](const output_type& x, const output_type& y){ return x.text == y.text; });
+    }
 };
 
 }
@@ -19,8 +19,18 @@ limitations under the License.
 
 #include "resembla_util.hpp"
 
+#include <cstdint>
+#include <cstdio>
+#include <tuple>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <locale>
+
 #include <simstring/simstring.h>
 
+#include "cached_resembla.hpp"
+
 #include "measure/edit_distance.hpp"
 #include "measure/weighted_edit_distance.hpp"
 
@@ -58,6 +68,7 @@ namespace resembla {
 const std::string SIMSTRING_DB_FILE_SUFFIX = ".simstring.cdb";
 const std::string SIMSTRING_DB_FILE_COMMON_SUFFIX = ".simstring_db.";
 const std::string SIMSTRING_INVERSE_FILE_COMMON_SUFFIX = ".inverse.";
+const std::string ANALYSIS_FILE_COMMON_SUFFIX = ".analysis.";
 
 // utility function for converting string that represents a simstring measure to int
 int simstring_measure_from_string(const std::string& simstring_measure_str)
@@ -137,6 +148,18 @@ std::string inverse_path_from_resembla_measure(const std::string& corpus_path, c
     }
 }
 
+std::string analysis_path_from_mecab_options(const std::string& corpus_path, const std::string& mecab_options)
+{
+    // FNV-1a, so that the file name does not depend on the standard library
+    uint64_t h = 14695981039346656037ULL;
+    for(auto c: mecab_options){
+        h = (h ^ static_cast<unsigned char>(c)) * 1099511628211ULL;
+    }
+    char hex[17];
+    std::snprintf(hex, sizeof(hex), "%016llx", static_cast<unsigned long long>(h));
+    return corpus_path + ANALYSIS_FILE_COMMON_SUFFIX + hex;
+}
+
 std::vector<measure> split_to_resembla_measures(std::string text, char delimiter, bool ignore_unknown_measure)
 {
     std::vector<measure> result;
@@ -170,7 +193,7 @@ std::vector<measure> split_to_resembla_measures(std::string text, char delimiter
 
 std::shared_ptr<ResemblaRegression<RomajiSequenceBuilder, Composition<FeatureAggregator, SVRPredictor>>>
 construct_resembla_regression(std::string db_path, std::string inverse_path, paramset::manager& pm,
-        const std::shared_ptr<ResemblaInterface> resembla)
+        const std::shared_ptr<ResemblaInterface> resembla, std::shared_ptr<ThreadPool> pool)
 {
     auto indexer = std::make_shared<RomajiSequenceBuilder>((pm.get<std::string>("index_romaji_mecab_options"),
             pm.get<int>("index_romaji_mecab_feature_pos"), pm.get<std::string>("index_romaji_mecab_pronunciation_of_marks")));
@@ -182,8 +205,9 @@ construct_resembla_regression(std::string db_path, std::string inverse_path, par
     const auto& base_feature = features[0][0];
 
     std::vector<std::string> feature_names;
-    auto extractor = std::make_shared<FeatureExtractor>();
-    auto aggregator= std::make_shared<FeatureAggregator>();
+    auto schema = std::make_shared<const FeatureSchema>(features);
+    auto extractor = std::make_shared<FeatureExtractor>(schema);
+    auto aggregator= std::make_shared<FeatureAggregator>(schema);
     for(const auto& feature: features){
         const auto& name = feature[0];
         feature_names.push_back(name);
@@ -227,6 +251,14 @@ construct_resembla_regression(std::string db_path, std::string inverse_path, par
 
     // aggregated features => score
     auto original_predictor = std::make_shared<SVRPredictor>(feature_names, pm.get<std::string>("svr_model_path"));
+    if(pm.get<int>("svr_approximation_dimension") > 0){
+        const auto validation_path = pm.get<std::string>("svr_approximation_validation_path");
+        if(validation_path.empty()){
+            throw std::runtime_error("svr_approximation_validation_path is required to approximate SVR");
+        }
+        original_predictor->approximate(pm.get<int>("svr_approximation_dimension"), pm.get<double>("svr_approximation_max_error"),
+                load_svr_inputs(validation_path, feature_names.size()), pm.get<int>("svr_approximation_seed"));
+    }
     // pair of features => score
     auto predictor = std::make_shared<Composition<FeatureAggregator, SVRPredictor>>(aggregator, original_predictor);
 
@@ -234,8 +266,12 @@ construct_resembla_regression(std::string db_path, std::string inverse_path, par
             ResemblaRegression<RomajiSequenceBuilder, Composition<FeatureAggregator, SVRPredictor>>>(
                 db_path, inverse_path,
                 pm.get<int>("simstring_measure"), pm.get<double>("svr_simstring_threshold"),
-                pm.get<int>("svr_max_candidate"), indexer, extractor, predictor);
+                pm.get<int>("svr_max_candidate"), indexer, extractor, predictor,
+                Reranker<string_type>(pool, pm.get<int>("resembla_parallel_reranking_threshold"),
+                    pm.get<int>("resembla_reranking_chunk_size")));
     resembla_regression->append("base_similarity", resembla, true);
+    resembla_regression->setCascade(pm.get<int>("svr_cascade_size"), pm.get<double>("svr_cascade_min_base_score"),
+            pm.get<int>("svr_cascade_check_interval"));
     return resembla_regression;
 }
 
@@ -243,7 +279,15 @@ std::shared_ptr<ResemblaInterface> construct_resembla(std::string corpus_path, p
 {
     std::string resembla_measure_all = pm["resembla_measure"];
 
-    std::vector<std::pair<std::shared_ptr<ResemblaInterface>, double>> basic_resemblas;
+    // candidates are reranked in parallel only if worker threads are given
+    std::shared_ptr<ThreadPool> pool = nullptr;
+    if(pm.get<int>("resembla_num_threads") > 0){
+        pool = std::make_shared<ThreadPool>(pm.get<int>("resembla_num_threads"));
+    }
+    Reranker<string_type> reranker(pool, pm.get<int>("resembla_parallel_reranking_threshold"),
+            pm.get<int>("resembla_reranking_chunk_size"));
+
+    std::vector<std::tuple<std::shared_ptr<ResemblaInterface>, double, measure>> basic_resemblas;
     std::shared_ptr<ResemblaInterface> keyword_resembla = nullptr;
     bool use_regression = false;
     for(auto resembla_measure: split_to_resembla_measures(resembla_measure_all)){
@@ -256,16 +300,16 @@ std::shared_ptr<ResemblaInterface> construct_resembla(std::string corpus_path, p
                 use_regression = true;
                 break;
             case edit_distance:
-                basic_resemblas.push_back(std::make_pair(
+                basic_resemblas.push_back(std::make_tuple(
                     construct_basic_resembla(
                         db_path, inverse_path, pm.get<int>("simstring_measure"),
                         pm.get<double>("ed_simstring_threshold"), pm.get<int>("ed_max_reranking_num"),
                         std::make_shared<AsIsSequenceBuilder<string_type>>(),
-                        std::make_shared<EditDistance<>>(STR(edit_distance)), true),
-                    pm.get<double>("ed_ensemble_weight")));
+                        std::make_shared<EditDistance<>>(STR(edit_distance)), true, reranker),
+                    pm.get<double>("ed_ensemble_weight"), resembla_measure));
                 break;
             case weighted_word_edit_distance:
-                basic_resemblas.push_back(std::make_pair(
+                basic_resemblas.push_back(std::make_tuple(
                     construct_basic_resembla(
                         db_path, inverse_path, pm.get<int>("simstring_measure"),
                         pm.get<double>("wwed_simstring_threshold"), pm.get<int>("wwed_max_reranking_num"),
@@ -274,11 +318,11 @@ std::shared_ptr<ResemblaInterface> construct_resembla(std::string corpus_path, p
                             WordWeight(pm.get<double>("wwed_base_weight"),
                                 pm.get<double>("wwed_delete_insert_ratio"), pm.get<double>("wwed_noun_coefficient"),
                                 pm.get<double>("wwed_verb_coefficient"), pm.get<double>("wwed_adj_coefficient"))),
-                        std::make_shared<WeightedEditDistance<WordMismatchCost>>(STR(weighted_word_edit_distance)), true),
-                    pm.get<double>("wwed_ensemble_weight")));
+                        std::make_shared<WeightedEditDistance<WordMismatchCost>>(STR(weighted_word_edit_distance)), true, reranker),
+                    pm.get<double>("wwed_ensemble_weight"), resembla_measure));
                 break;
             case weighted_pronunciation_edit_distance:
-                basic_resemblas.push_back(std::make_pair(
+                basic_resemblas.push_back(std::make_tuple(
                     construct_basic_resembla(
                         db_path, inverse_path, pm.get<int>("simstring_measure"),
                         pm.get<double>("wped_simstring_threshold"), pm.get<int>("wped_max_reranking_num"),
@@ -289,11 +333,11 @@ std::shared_ptr<ResemblaInterface> construct_resembla(std::string corpus_path, p
                                 pm.get<std::string>("wped_letter_weight_path"))),
                         std::make_shared<WeightedEditDistance<KanaMismatchCost<string_type>>>(
                             STR(weighted_pronunciation_edit_distance), pm.get<std::string>("wped_mismatch_cost_path")),
-                        true),
-                    pm.get<double>("wped_ensemble_weight")));
+                        true, reranker),
+                    pm.get<double>("wped_ensemble_weight"), resembla_measure));
                 break;
             case weighted_romaji_edit_distance:
-                basic_resemblas.push_back(std::make_pair(
+                basic_resemblas.push_back(std::make_tuple(
                     construct_basic_resembla(
                         db_path, inverse_path, pm.get<int>("simstring_measure"),
                         pm.get<double>("wred_simstring_threshold"), pm.get<int>("wred_max_reranking_num"),
@@ -310,15 +354,15 @@ std::shared_ptr<ResemblaInterface> construct_resembla(std::string corpus_path, p
                             std::make_shared<WeightedEditDistance<RomajiMismatchCost>>(STR(weighted_romaji_edit_distance),
                                 RomajiMismatchCost(pm.get<std::string>("wred_mismatch_cost_path"),
                                     pm.get<double>("wred_case_mismatch_cost"))),
-                        true),
-                    pm.get<double>("wred_ensemble_weight")));
+                        true, reranker),
+                    pm.get<double>("wred_ensemble_weight"), resembla_measure));
                 break;
             case keyword_match:
                 keyword_resembla = construct_basic_resembla(
                     db_path, inverse_path, pm.get<int>("simstring_measure"),
                     pm.get<double>("km_simstring_threshold"), pm.get<int>("km_max_reranking_num"),
                     std::make_shared<KeywordMatchPreprocessor<string_type>>(),
-                    std::make_shared<KeywordMatcher<string_type>>(STR(keyword_match)), true);
+                    std::make_shared<KeywordMatcher<string_type>>(STR(keyword_match)), true, reranker);
                 break;
         }
     }
@@ -327,21 +371,33 @@ std::shared_ptr<ResemblaInterface> construct_resembla(std::string corpus_path, p
     }
 
     if(!use_regression && keyword_resembla != nullptr){
-        basic_resemblas.push_back(std::make_pair(keyword_resembla, pm.get<double>("km_ensemble_weight")));
+        basic_resemblas.push_back(std::make_tuple(keyword_resembla, pm.get<double>("km_ensemble_weight"), keyword_match));
         keyword_resembla = nullptr;
     }
 
     std::shared_ptr<ResemblaInterface> base_resembla;
     if(basic_resemblas.size() > 0){
         if(basic_resemblas.size() == 1){
-            base_resembla = basic_resemblas[0].first;
+            base_resembla = std::get<0>(basic_resemblas[0]);
         }
         else{
+            // measures whose indexes generate candidates shared by all measures. empty if not shared
+            std::vector<measure> candidate_measures;
+            if(!pm.get<std::string>("resembla_ensemble_candidates").empty()){
+                candidate_measures = split_to_resembla_measures(pm.get<std::string>("resembla_ensemble_candidates"));
+            }
+            // queries in batch run on their own workers, so children submitted to pool never wait for other queries
+            std::shared_ptr<ThreadPool> batch_pool = nullptr;
+            if(pm.get<int>("resembla_batch_num_threads") > 0){
+                batch_pool = std::make_shared<ThreadPool>(pm.get<int>("resembla_batch_num_threads"));
+            }
             std::shared_ptr<ResemblaEnsemble> resembla_ensemble =
-                std::make_shared<ResemblaEnsemble>(resembla_measure_all, pm.get<double>("resembla_max_reranking_num"));
+                std::make_shared<ResemblaEnsemble>(resembla_measure_all, pm.get<double>("resembla_max_reranking_num"),
+                        pool, pm.get<int>("resembla_ensemble_timeout"), !candidate_measures.empty(), batch_pool);
             for(auto p: basic_resemblas){
-                if(p.second > 0){
-                    resembla_ensemble->append(p.first, p.second);
+                if(std::get<1>(p) > 0){
+                    resembla_ensemble->append(std::get<0>(p), std::get<1>(p), std::find(std::begin(candidate_measures),
+                                std::end(candidate_measures), std::get<2>(p)) != std::end(candidate_measures));
                 }
             }
             base_resembla = resembla_ensemble;
@@ -357,7 +413,7 @@ std::shared_ptr<ResemblaInterface> construct_resembla(std::string corpus_path, p
             resembla_regression = construct_resembla_regression(
                 db_path_from_resembla_measure(corpus_path, svr),
                 inverse_path_from_resembla_measure(corpus_path, svr),
-                pm, base_resembla);
+                pm, base_resembla, pool);
         if(keyword_resembla != nullptr && base_resembla != keyword_resembla){
             resembla_regression->append(STR(keyword_match), keyword_resembla, false);
         }
@@ -367,6 +423,22 @@ std::shared_ptr<ResemblaInterface> construct_resembla(std::string corpus_path, p
         resembla = base_resembla;
     }
 
+    if(pm.get<int>("cache_max_memory") > 0){
+        // responses cached without expiration would keep scores of the day or time when they were cached
+        if(use_regression && pm.get<double>("cache_ttl") == 0.0 &&
+                depends_on_request_time(load_features(pm.get<std::string>("svr_features_path")))){
+            throw std::runtime_error("cache_ttl must be positive if date_period or time_period features are used");
+        }
+        if(pm.get<int>("cache_shards") <= 0){
+            throw std::runtime_error("cache_shards must be positive: " + std::to_string(pm.get<int>("cache_shards")));
+        }
+        if(pm.get<double>("cache_ttl") < 0.0){
+            throw std::runtime_error("cache_ttl must not be negative: " + std::to_string(pm.get<double>("cache_ttl")));
+        }
+        resembla = std::make_shared<CachedResembla>(resembla, static_cast<size_t>(pm.get<int>("cache_max_memory")) << 20,
+                static_cast<size_t>(pm.get<int>("cache_shards")), pm.get<double>("cache_ttl"));
+    }
+
     return resembla;
 }
 
@@ -396,4 +468,45 @@ std::vector<std::vector<std::string>> load_features(const std::string file_path)
     return features;
 }
 
+bool depends_on_request_time(const std::vector<std::vector<std::string>>& features)
+{
+    for(const auto& feature: features){
+        if(feature[1] == "date_period" || feature[1] == "time_period"){
+            return true;
+        }
+    }
+    return false;
+}
+
+std::vector<FeatureVector> load_svr_inputs(const std::string file_path, size_t num_features)
+{
+    std::ifstream ifs(file_path);
+    if(ifs.fail()){
+        throw std::runtime_error("input file is not available: " + file_path);
+    }
+
+    std::vector<FeatureVector> inputs;
+    std::string line;
+    while(std::getline(ifs, line)){
+        std::istringstream is(line);
+        is.imbue(std::locale::classic());
+        std::string label;
+        if(!(is >> label)){
+            continue;
+        }
+
+        FeatureVector x(num_features, Feature::missing());
+        size_t index;
+        char colon;
+        double value;
+        while(is >> index >> colon >> value){
+            if(index < num_features){
+                x[index] = value;
+            }
+        }
+        inputs.push_back(x);
+    }
+    return inputs;
+}
+
 }
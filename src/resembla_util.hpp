@@ -42,6 +42,7 @@ namespace resembla {
 extern const std::string SIMSTRING_DB_FILE_SUFFIX;
 extern const std::string SIMSTRING_DB_FILE_COMMON_SUFFIX;
 extern const std::string SIMSTRING_INVERSE_FILE_COMMON_SUFFIX;
+extern const std::string ANALYSIS_FILE_COMMON_SUFFIX;
 
 enum measure: int
 {
@@ -78,6 +79,9 @@ std::string db_path_from_resembla_measure(const std::string& corpus_path, const
 // utility function for generating file path of inverted index for original and parsed texts from Resembla measure
 std::string inverse_path_from_resembla_measure(const std::string& corpus_path, const measure resembla_measure);
 
+// utility function for generating file path of morphological analyses of corpus from MeCab options
+std::string analysis_path_from_mecab_options(const std::string& corpus_path, const std::string& mecab_options);
+
 // split text by delimiter and parse to resembla measures
 std::vector<measure> split_to_resembla_measures(std::string text, char delimiter = ',', bool ignore_unknown_measure = false);
 
@@ -89,21 +93,27 @@ template<
 std::shared_ptr<ResemblaInterface> construct_basic_resembla(const std::string& db_path, const std::string& inverse_path,
         int simstring_measure, double simstring_threshold, int max_reranking_num,
         std::shared_ptr<Preprocessor> preprocess, std::shared_ptr<ScoreFunction> score_func,
-        bool preprocess_corpus = true)
+        bool preprocess_corpus = true, const Reranker<string_type>& reranker = Reranker<string_type>())
 {
     return std::make_shared<BasicResembla<Preprocessor, ScoreFunction>>(
             db_path, inverse_path, simstring_measure, simstring_threshold, max_reranking_num,
-            preprocess, score_func, preprocess_corpus);
+            preprocess, score_func, preprocess_corpus, 3, reranker);
 }
 
 std::shared_ptr<ResemblaRegression<RomajiSequenceBuilder, Composition<FeatureAggregator, SVRPredictor>>>
 construct_resembla_regression(std::string db_path, std::string inverse_path, paramset::manager& pm,
-        const std::shared_ptr<ResemblaInterface> resembla);
+        const std::shared_ptr<ResemblaInterface> resembla, std::shared_ptr<ThreadPool> pool = nullptr);
 
 // utility function to construct Resembla instance
 std::shared_ptr<ResemblaInterface> construct_resembla(std::string corpus_path, paramset::manager& pm);
 
 std::vector<std::vector<std::string>> load_features(const std::string file_path);
 
+// true if scores of features change with the time of requests
+bool depends_on_request_time(const std::vector<std::vector<std::string>>& features);
+
+// loads inputs of SVR from a data file in LIBSVM format. labels are ignored and absent features are missing
+std::vector<FeatureVector> load_svr_inputs(const std::string file_path, size_t num_features);
+
 }
 #endif
@@ -34,19 +34,31 @@ ResemblaWithId::ResemblaWithId(const std::shared_ptr<ResemblaInterface> resembla
 std::vector<ResemblaWithId::output_type> ResemblaWithId::find(const string_type& query,
         double threshold, size_t max_response) const
 {
-    std::vector<output_type> results;
-    for(auto raw_result: resembla->find(query, threshold, max_response)){
-        results.push_back({raw_result, ids.at(raw_result.text)});
-    }
-    return results;
+    return withId(resembla->find(query, threshold, max_response));
 }
 
 std::vector<ResemblaWithId::output_type> ResemblaWithId::eval(const string_type& query,
         const std::vector<string_type>& targets, double threshold, size_t max_response) const
 {
-    std::vector<output_type> results;
-    for(auto raw_result: resembla->eval(query, targets, threshold, max_response)){
-        results.push_back({raw_result, ids.at(raw_result.text)});
+    return withId(resembla->eval(query, targets, threshold, max_response));
+}
+
+std::vector<std::vector<ResemblaWithId::output_type>> ResemblaWithId::find_batch(const std::vector<string_type>& queries,
+        double threshold, size_t max_response) const
+{
+    std::vector<std::vector<output_type>> results;
+    for(const auto& raw_results: resembla->find_batch(queries, threshold, max_response)){
+        results.push_back(withId(raw_results));
+    }
+    return results;
+}
+
+std::vector<std::vector<ResemblaWithId::output_type>> ResemblaWithId::eval_batch(const std::vector<string_type>& queries,
+        const std::vector<std::vector<string_type>>& targets, double threshold, size_t max_response) const
+{
+    std::vector<std::vector<output_type>> results;
+    for(const auto& raw_results: resembla->eval_batch(queries, targets, threshold, max_response)){
+        results.push_back(withId(raw_results));
     }
     return results;
 }
@@ -85,4 +97,14 @@ void ResemblaWithId::loadCorpus(const std::string& corpus_path, size_t id_col, s
     }
 }
 
+std::vector<ResemblaWithId::output_type> ResemblaWithId::withId(
+        const std::vector<ResemblaInterface::output_type>& raw_results) const
+{
+    std::vector<output_type> results;
+    for(const auto& raw_result: raw_results){
+        results.push_back({raw_result, ids.at(raw_result.text)});
+    }
+    return results;
+}
+
 }
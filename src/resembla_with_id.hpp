@@ -52,11 +52,18 @@ public:
     std::vector<output_type> eval(const string_type& query, const std::vector<string_type>& targets,
             double threshold = 0.0, size_t max_response = 0) const;
 
+    std::vector<std::vector<output_type>> find_batch(const std::vector<string_type>& queries,
+            double threshold = 0.0, size_t max_response = 0) const;
+    std::vector<std::vector<output_type>> eval_batch(const std::vector<string_type>& queries,
+            const std::vector<std::vector<string_type>>& targets, double threshold = 0.0, size_t max_response = 0) const;
+
 protected:
     std::shared_ptr<ResemblaInterface> resembla;
     std::unordered_map<string_type, id_type> ids;
 
     void loadCorpus(const std::string& corpus_path, size_t id_col, size_t text_col);
+
+    std::vector<output_type> withId(const std::vector<ResemblaInterface::output_type>& raw_results) const;
 };
 
 }
@@ -19,7 +19,8 @@ limitations under the License.
 
 #include "string_util.hpp"
 
-#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
 
 #include <locale>
 #include <codecvt>
@@ -42,22 +43,211 @@ void init_locale()
     setlocale(LC_ALL, "");
 }
 
+static const char32_t REPLACEMENT_CHARACTER = 0xFFFD;
+
+// true if none of 8 bytes from p is larger than 0x7F
+static inline bool isAsciiBlock(const void* p)
+{
+    uint64_t block;
+    memcpy(&block, p, sizeof(block));
+    return (block & 0x8080808080808080ULL) == 0;
+}
+
+// writes a code point as one character, or as a surrogate pair if char_type has 16 bits
+template<typename char_type>
+static inline char_type* putCodePoint(char_type* out, char32_t c)
+{
+    if(sizeof(char_type) == 2 && c >= 0x10000){
+        c -= 0x10000;
+        *out++ = static_cast<char_type>(0xD800 + (c >> 10));
+        *out++ = static_cast<char_type>(0xDC00 + (c & 0x3FF));
+    }
+    else{
+        *out++ = static_cast<char_type>(c);
+    }
+    return out;
+}
+
+template<typename char_type>
+static size_t decodeUtf8(const char* src, size_t length, char_type* dest)
+{
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(src);
+    const unsigned char* end = p + length;
+    char_type* out = dest;
+    while(p < end){
+        // ASCII characters are copied without checking each byte
+        while(end - p >= 8 && isAsciiBlock(p)){
+            for(int i = 0; i < 8; ++i){
+                out[i] = p[i];
+            }
+            p += 8;
+            out += 8;
+        }
+        if(p == end){
+            break;
+        }
+
+        unsigned char c = *p;
+        if(c < 0x80){
+            *out++ = c;
+            ++p;
+            continue;
+        }
+
+        size_t n;
+        char32_t code_point, min;
+        if((c & 0xE0) == 0xC0){
+            n = 2;
+            code_point = c & 0x1F;
+            min = 0x80;
+        }
+        else if((c & 0xF0) == 0xE0){
+            n = 3;
+            code_point = c & 0x0F;
+            min = 0x800;
+        }
+        else if((c & 0xF8) == 0xF0){
+            n = 4;
+            code_point = c & 0x07;
+            min = 0x10000;
+        }
+        else{
+            n = 0;
+            code_point = min = 0;
+        }
+
+        size_t i = 1;
+        if(n > 0 && static_cast<size_t>(end - p) >= n){
+            for(; i < n && (p[i] & 0xC0) == 0x80; ++i){
+                code_point = (code_point << 6) | (p[i] & 0x3F);
+            }
+        }
+        // reject truncated, overlong and surrogate sequences
+        if(n == 0 || i < n || code_point < min || code_point > 0x10FFFF ||
+                (code_point >= 0xD800 && code_point <= 0xDFFF)){
+            out = putCodePoint(out, REPLACEMENT_CHARACTER);
+            ++p;
+            continue;
+        }
+        out = putCodePoint(out, code_point);
+        p += n;
+    }
+    return out - dest;
+}
+
+template<typename char_type>
+static size_t encodeUtf8(const char_type* src, size_t length, char* dest)
+{
+    const char_type* p = src;
+    const char_type* end = src + length;
+    unsigned char* out = reinterpret_cast<unsigned char*>(dest);
+    while(p < end){
+        char32_t c = static_cast<char32_t>(*p++);
+        if(c < 0x80){
+            *out++ = static_cast<unsigned char>(c);
+            continue;
+        }
+
+        if(sizeof(char_type) == 2 && c >= 0xD800 && c <= 0xDBFF && p < end &&
+                static_cast<char32_t>(*p) >= 0xDC00 && static_cast<char32_t>(*p) <= 0xDFFF){
+            c = 0x10000 + ((c - 0xD800) << 10) + (static_cast<char32_t>(*p++) - 0xDC00);
+        }
+        if(c > 0x10FFFF || (c >= 0xD800 && c <= 0xDFFF)){
+            c = REPLACEMENT_CHARACTER;
+        }
+
+        if(c < 0x800){
+            *out++ = static_cast<unsigned char>(0xC0 | (c >> 6));
+            *out++ = static_cast<unsigned char>(0x80 | (c & 0x3F));
+        }
+        else if(c < 0x10000){
+            *out++ = static_cast<unsigned char>(0xE0 | (c >> 12));
+            *out++ = static_cast<unsigned char>(0x80 | ((c >> 6) & 0x3F));
+            *out++ = static_cast<unsigned char>(0x80 | (c & 0x3F));
+        }
+        else{
+            *out++ = static_cast<unsigned char>(0xF0 | (c >> 18));
+            *out++ = static_cast<unsigned char>(0x80 | ((c >> 12) & 0x3F));
+            *out++ = static_cast<unsigned char>(0x80 | ((c >> 6) & 0x3F));
+            *out++ = static_cast<unsigned char>(0x80 | (c & 0x3F));
+        }
+    }
+    return out - reinterpret_cast<unsigned char*>(dest);
+}
+
+size_t decode_utf8(const char* src, size_t length, wchar_t* dest)
+{
+    return decodeUtf8(src, length, dest);
+}
+
+size_t decode_utf8(const char* src, size_t length, char32_t* dest)
+{
+    return decodeUtf8(src, length, dest);
+}
+
+size_t encode_utf8(const wchar_t* src, size_t length, char* dest)
+{
+    return encodeUtf8(src, length, dest);
+}
+
+size_t encode_utf8(const char32_t* src, size_t length, char* dest)
+{
+    return encodeUtf8(src, length, dest);
+}
+
 template<>
 void cast_string(const std::string& src, std::wstring& dest)
 {
-    std::wstring::value_type *wcs = new std::wstring::value_type[src.length() + 1];
-    mbstowcs(wcs, src.c_str(), src.length() + 1);
-    dest = wcs;
-    delete [] wcs;
+    // reuses the capacity of dest
+    dest.resize(src.length());
+    dest.resize(decode_utf8(src.data(), src.length(), &dest[0]));
 }
 
 template<>
 void cast_string(const std::wstring& src, std::string& dest)
 {
-    std::string::value_type *mbs = new std::string::value_type[src.length() * MB_CUR_MAX + 1];
-    wcstombs(mbs, src.c_str(), src.length() * MB_CUR_MAX + 1);
-    dest = mbs;
-    delete [] mbs;
+    dest.resize(src.length() * 4);
+    dest.resize(encode_utf8(src.data(), src.length(), &dest[0]));
+}
+
+template<>
+void cast_string(const std::string& src, std::u32string& dest)
+{
+    dest.resize(src.length());
+    dest.resize(decode_utf8(src.data(), src.length(), &dest[0]));
+}
+
+template<>
+void cast_string(const std::u32string& src, std::string& dest)
+{
+    dest.resize(src.length() * 4);
+    dest.resize(encode_utf8(src.data(), src.length(), &dest[0]));
+}
+
+template<>
+void cast_string(const std::u32string& src, std::wstring& dest)
+{
+    dest.clear();
+    dest.reserve(src.length());
+    for(auto c: src){
+        wchar_t units[2];
+        dest.append(units, putCodePoint(units, c));
+    }
+}
+
+template<>
+void cast_string(const std::wstring& src, std::u32string& dest)
+{
+    dest.clear();
+    dest.reserve(src.length());
+    for(size_t i = 0; i < src.length(); ++i){
+        char32_t c = static_cast<char32_t>(src[i]);
+        if(sizeof(wchar_t) == 2 && c >= 0xD800 && c <= 0xDBFF && i + 1 < src.length() &&
+                static_cast<char32_t>(src[i + 1]) >= 0xDC00 && static_cast<char32_t>(src[i + 1]) <= 0xDFFF){
+            c = 0x10000 + ((c - 0xD800) << 10) + (static_cast<char32_t>(src[++i]) - 0xDC00);
+        }
+        dest.push_back(c);
+    }
 }
 
 template<>
@@ -75,15 +265,44 @@ void cast_string(const UnicodeString& src, std::string& dest)
 template<>
 void cast_string(const std::wstring& src, UnicodeString& dest)
 {
-    dest = UnicodeString::fromUTF8(cast_string<std::string>(src));
+    dest.remove();
+    for(auto c: src){
+        // surrogates of 16-bit wchar_t are appended as is
+        dest.append(static_cast<UChar32>(c));
+    }
 }
 
 template<>
 void cast_string(const UnicodeString& src, std::wstring& dest)
 {
-    std::string tmp;
-    src.toUTF8String(tmp);
-    cast_string(tmp, dest);
+    dest.clear();
+    if(sizeof(wchar_t) == 2){
+        dest.assign(src.getBuffer(), src.getBuffer() + src.length());
+        return;
+    }
+    dest.reserve(src.length());
+    for(int32_t i = 0; i < src.length(); i = src.moveIndex32(i, 1)){
+        dest.push_back(static_cast<wchar_t>(src.char32At(i)));
+    }
+}
+
+template<>
+void cast_string(const std::u32string& src, UnicodeString& dest)
+{
+    dest.remove();
+    for(auto c: src){
+        dest.append(static_cast<UChar32>(c));
+    }
+}
+
+template<>
+void cast_string(const UnicodeString& src, std::u32string& dest)
+{
+    dest.clear();
+    dest.reserve(src.length());
+    for(int32_t i = 0; i < src.length(); i = src.moveIndex32(i, 1)){
+        dest.push_back(static_cast<char32_t>(src.char32At(i)));
+    }
 }
 
 }
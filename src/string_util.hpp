@@ -25,11 +25,29 @@ limitations under the License.
 
 namespace resembla {
 
+// texts are stored as UTF-32 if RESEMBLA_UTF32_STRING is defined at compile time, otherwise as wchar_t.
+// literals of string_type and its characters must be written with RESEMBLA_TEXT
+#ifdef RESEMBLA_UTF32_STRING
+using string_type = std::u32string;
+#define RESEMBLA_TEXT(literal) U ## literal
+#else
 using string_type = std::wstring;
+#define RESEMBLA_TEXT(literal) L ## literal
+#endif
 
 // common initialization procedures for using wchar_t
 void init_locale();
 
+// converts UTF-8 to wide characters regardless of locale. dest must have room for length characters.
+// invalid bytes are replaced with U+FFFD. returns the number of characters written
+size_t decode_utf8(const char* src, size_t length, wchar_t* dest);
+size_t decode_utf8(const char* src, size_t length, char32_t* dest);
+
+// converts wide characters to UTF-8 regardless of locale. dest must have room for 4 * length bytes.
+// returns the number of bytes written
+size_t encode_utf8(const wchar_t* src, size_t length, char* dest);
+size_t encode_utf8(const char32_t* src, size_t length, char* dest);
+
 template<typename src_type, typename dest_type>
 void cast_string(const src_type& src, dest_type& dest);
 
@@ -65,6 +83,12 @@ constexpr wchar_t column_delimiter()
     return L'\t';
 }
 
+template<>
+constexpr char32_t column_delimiter()
+{
+    return U'\t';
+}
+
 template<typename char_type = char>
 constexpr char_type feature_delimiter();
 
@@ -80,6 +104,12 @@ constexpr wchar_t feature_delimiter()
     return L'&';
 }
 
+template<>
+constexpr char32_t feature_delimiter()
+{
+    return U'&';
+}
+
 template<typename char_type = char>
 constexpr char_type keyvalue_delimiter();
 
@@ -95,6 +125,12 @@ constexpr wchar_t keyvalue_delimiter()
     return L'=';
 }
 
+template<>
+constexpr char32_t keyvalue_delimiter()
+{
+    return U'=';
+}
+
 template<typename char_type = char>
 constexpr char_type value_delimiter();
 
@@ -110,6 +146,12 @@ constexpr wchar_t value_delimiter()
     return L',';
 }
 
+template<>
+constexpr char32_t value_delimiter()
+{
+    return U',';
+}
+
 // split text by delimiter
 template<typename string_type>
 std::vector<string_type> split(const string_type& text, const typename string_type::value_type delimiter)
@@ -0,0 +1,82 @@
+/*
+Resembla: Word-based Japanese similar sentence search library
+https://github.com/tuem/resembla
+
+Copyright 2017 Takashi Uemura
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "thread_affinity.hpp"
+
+#include <stdexcept>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "string_util.hpp"
+
+namespace resembla {
+
+static size_t parseCpu(const std::string& s, const std::string& cpu_list)
+{
+    if(s.empty() || s.find_first_not_of("0123456789") != std::string::npos){
+        throw std::invalid_argument("invalid CPU list: " + cpu_list);
+    }
+    return std::stoul(s);
+}
+
+std::vector<size_t> parse_cpu_list(const std::string& cpu_list)
+{
+    std::vector<size_t> cpus;
+    if(cpu_list.empty()){
+        return cpus;
+    }
+    for(const auto& range: split(cpu_list, ',')){
+        auto i = range.find('-');
+        if(i == std::string::npos){
+            cpus.push_back(parseCpu(range, cpu_list));
+            continue;
+        }
+        auto first = parseCpu(range.substr(0, i), cpu_list);
+        auto last = parseCpu(range.substr(i + 1), cpu_list);
+        if(last < first){
+            throw std::invalid_argument("invalid CPU list: " + cpu_list);
+        }
+        for(auto cpu = first; cpu <= last; ++cpu){
+            cpus.push_back(cpu);
+        }
+    }
+    return cpus;
+}
+
+bool set_thread_affinity(std::thread& thread, size_t cpu)
+{
+#ifdef __linux__
+    if(cpu >= CPU_SETSIZE){
+        return false;
+    }
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    CPU_SET(cpu, &cpu_set);
+    return pthread_setaffinity_np(thread.native_handle(), sizeof(cpu_set), &cpu_set) == 0;
+#else
+    (void)thread;
+    (void)cpu;
+    return false;
+#endif
+}
+
+}
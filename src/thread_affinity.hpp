@@ -0,0 +1,36 @@
+/*
+Resembla: Word-based Japanese similar sentence search library
+https://github.com/tuem/resembla
+
+Copyright 2017 Takashi Uemura
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef RESEMBLA_THREAD_AFFINITY_HPP
+#define RESEMBLA_THREAD_AFFINITY_HPP
+
+#include <string>
+#include <vector>
+#include <thread>
+
+namespace resembla {
+
+// parses a list of CPU numbers such as "0-3,8,10-11". throws std::invalid_argument if malformed
+std::vector<size_t> parse_cpu_list(const std::string& cpu_list);
+
+// binds thread to cpu. returns false if failed or not supported on the platform
+bool set_thread_affinity(std::thread& thread, size_t cpu);
+
+}
+#endif
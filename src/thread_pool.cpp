@@ -0,0 +1,125 @@
+/*
+Resembla: Word-based Japanese similar sentence search library
+https://github.com/tuem/resembla
+
+Copyright 2017 Takashi Uemura
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "thread_pool.hpp"
+
+namespace resembla {
+
+thread_local ThreadPool* ThreadPool::current_pool = nullptr;
+thread_local size_t ThreadPool::current_queue = 0;
+
+ThreadPool::ThreadPool(size_t num_threads): pending(0), next_queue(0), stopped(false)
+{
+    if(num_threads == 0){
+        num_threads = 1;
+    }
+    for(size_t i = 0; i < num_threads; ++i){
+        queues.emplace_back(new Queue);
+    }
+    for(size_t i = 0; i < num_threads; ++i){
+        workers.emplace_back(&ThreadPool::work, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_idle);
+        stopped = true;
+    }
+    idle.notify_all();
+    for(auto& worker: workers){
+        worker.join();
+    }
+}
+
+size_t ThreadPool::size() const
+{
+    return workers.size();
+}
+
+bool ThreadPool::is_worker() const
+{
+    return current_pool == this;
+}
+
+void ThreadPool::submit(task_type task)
+{
+    size_t i = current_pool == this ? current_queue : next_queue++ % queues.size();
+    {
+        std::lock_guard<std::mutex> lock(queues[i]->mutex);
+        queues[i]->tasks.push_back(std::move(task));
+    }
+    ++pending;
+    {
+        std::lock_guard<std::mutex> lock(mutex_idle);
+    }
+    idle.notify_one();
+}
+
+void ThreadPool::work(size_t i)
+{
+    current_pool = this;
+    current_queue = i;
+
+    task_type task;
+    while(true){
+        if(pop(i, task) || steal(i, task)){
+            --pending;
+            task();
+            task = nullptr;
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(mutex_idle);
+        idle.wait(lock, [this](){
+            return stopped || pending.load() > 0;
+        });
+        if(stopped && pending.load() == 0){
+            break;
+        }
+    }
+}
+
+bool ThreadPool::pop(size_t i, task_type& task)
+{
+    std::lock_guard<std::mutex> lock(queues[i]->mutex);
+    if(queues[i]->tasks.empty()){
+        return false;
+    }
+    task = std::move(queues[i]->tasks.back());
+    queues[i]->tasks.pop_back();
+    return true;
+}
+
+bool ThreadPool::steal(size_t i, task_type& task)
+{
+    for(size_t j = 1; j < queues.size(); ++j){
+        auto& q = *queues[(i + j) % queues.size()];
+        std::lock_guard<std::mutex> lock(q.mutex);
+        if(!q.tasks.empty()){
+            task = std::move(q.tasks.front());
+            q.tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+}
@@ -0,0 +1,141 @@
+/*
+Resembla: Word-based Japanese similar sentence search library
+https://github.com/tuem/resembla
+
+Copyright 2017 Takashi Uemura
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef RESEMBLA_THREAD_POOL_HPP
+#define RESEMBLA_THREAD_POOL_HPP
+
+#include <vector>
+#include <deque>
+#include <memory>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <exception>
+#include <algorithm>
+
+namespace resembla {
+
+// work-stealing thread pool. each worker has its own task queue and steals tasks from others when idle
+class ThreadPool final
+{
+public:
+    using task_type = std::function<void()>;
+
+    ThreadPool(size_t num_threads = std::thread::hardware_concurrency());
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    size_t size() const;
+
+    // returns true if the calling thread is a worker of this pool
+    bool is_worker() const;
+
+    // enqueues a task. tasks must not throw exceptions
+    void submit(task_type task);
+
+    // calls func(i) for i in [0, n) on the calling thread and idle workers, and returns after all calls finished.
+    // the calling thread also processes tasks, so it is safe to call this from a task running on the same pool
+    template<typename Function>
+    void parallel_for(size_t n, const Function& func)
+    {
+        if(n == 0){
+            return;
+        }
+
+        struct State
+        {
+            std::atomic<size_t> next;
+            std::atomic<size_t> done;
+            std::exception_ptr error;
+            std::mutex mutex;
+            std::condition_variable finished;
+        };
+        auto state = std::make_shared<State>();
+        state->next = 0;
+        state->done = 0;
+
+        // func is only accessed while the calling thread is waiting
+        const Function* f = &func;
+        auto run = [state, n, f](){
+            for(size_t i = state->next++; i < n; i = state->next++){
+                try{
+                    (*f)(i);
+                }
+                catch(...){
+                    std::lock_guard<std::mutex> lock(state->mutex);
+                    if(!state->error){
+                        state->error = std::current_exception();
+                    }
+                }
+                if(++state->done == n){
+                    std::lock_guard<std::mutex> lock(state->mutex);
+                    state->finished.notify_all();
+                }
+            }
+        };
+
+        for(size_t i = 1; i < std::min(n, size() + 1); ++i){
+            submit(run);
+        }
+        run();
+
+        std::unique_lock<std::mutex> lock(state->mutex);
+        state->finished.wait(lock, [&state, n](){
+            return state->done.load() == n;
+        });
+        if(state->error){
+            std::rethrow_exception(state->error);
+        }
+    }
+
+protected:
+    struct Queue
+    {
+        std::deque<task_type> tasks;
+        std::mutex mutex;
+    };
+
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::vector<std::thread> workers;
+
+    std::atomic<size_t> pending;
+    std::atomic<size_t> next_queue;
+
+    bool stopped;
+    std::mutex mutex_idle;
+    std::condition_variable idle;
+
+    // pool and queue which the current thread belongs to
+    static thread_local ThreadPool* current_pool;
+    static thread_local size_t current_queue;
+
+    void work(size_t i);
+
+    // takes the newest task from own queue
+    bool pop(size_t i, task_type& task);
+    // takes the oldest task from other queues
+    bool steal(size_t i, task_type& task);
+};
+
+}
+#endif
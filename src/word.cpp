@@ -0,0 +1,161 @@
+/*
+Resembla: Word-based Japanese similar sentence search library
+https://github.com/tuem/resembla
+
+Copyright 2017 Takashi Uemura
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "word.hpp"
+
+#include <cstring>
+
+namespace resembla {
+
+FeatureView::FeatureView(const char* begin, const char* end): begin(begin), end(end) {}
+
+FeatureView::FeatureView(const std::string& feature): begin(feature.data()), end(feature.data() + feature.size()) {}
+
+size_t FeatureView::size() const
+{
+    size_t n = 0;
+    const char* start = begin;
+    for(const char* p = begin; p != end; ++p){
+        if(*p == ','){
+            if(start < p){
+                ++n;
+            }
+            start = p + 1;
+        }
+    }
+    return start < end ? n + 1 : n;
+}
+
+string_type FeatureView::operator[](size_t pos) const
+{
+    const char* field_begin;
+    const char* field_end;
+    if(!find(pos, field_begin, field_end)){
+        return string_type();
+    }
+    return cast_string<string_type>(std::string(field_begin, field_end));
+}
+
+bool FeatureView::equals(size_t pos, const char* utf8) const
+{
+    const char* field_begin;
+    const char* field_end;
+    if(!find(pos, field_begin, field_end)){
+        return *utf8 == '\0';
+    }
+    size_t length = field_end - field_begin;
+    return std::strlen(utf8) == length && std::memcmp(field_begin, utf8, length) == 0;
+}
+
+bool FeatureView::find(size_t pos, const char*& field_begin, const char*& field_end) const
+{
+    const char* start = begin;
+    for(const char* p = begin; p <= end; ++p){
+        if(p == end || *p == ','){
+            if(start < p){
+                if(pos == 0){
+                    field_begin = start;
+                    field_end = p;
+                    return true;
+                }
+                --pos;
+            }
+            start = p + 1;
+        }
+    }
+    return false;
+}
+
+const size_t Word::POS_POS = 0;
+const size_t Word::SUBCATEGORY_POS = 1;
+const size_t Word::BASE_FORM_POS = 6;
+const size_t Word::READING_POS = 7;
+
+// classifies features given by equals(pos, UTF-8 string)
+template<typename Equals>
+Word::PartOfSpeech classifyPos(Equals equals)
+{
+    if(equals(Word::POS_POS, "名詞")){
+        return Word::NOUN;
+    }
+    else if(equals(Word::POS_POS, "動詞")){
+        return Word::VERB;
+    }
+    else if(equals(Word::POS_POS, "形容詞")){
+        return Word::ADJECTIVE;
+    }
+    return Word::OTHER_POS;
+}
+
+template<typename Equals>
+Word::Subcategory classifySubcategory(Equals equals)
+{
+    if(equals(Word::SUBCATEGORY_POS, "接尾")){
+        return Word::SUFFIX;
+    }
+    else if(equals(Word::SUBCATEGORY_POS, "非自立")){
+        return Word::NON_INDEPENDENT;
+    }
+    else if(equals(Word::SUBCATEGORY_POS, "副詞可能")){
+        return Word::ADVERBIAL;
+    }
+    else if(equals(Word::SUBCATEGORY_POS, "代名詞")){
+        return Word::PRONOUN;
+    }
+    return Word::OTHER_SUBCATEGORY;
+}
+
+// "*" means unknown
+static string_type knownFeature(string_type feature)
+{
+    if(feature == RESEMBLA_TEXT("*")){
+        feature.clear();
+    }
+    return feature;
+}
+
+Word::Word(): pos(OTHER_POS), subcategory(OTHER_SUBCATEGORY) {}
+
+Word::Word(const string_type& surface, PartOfSpeech pos, Subcategory subcategory,
+        const string_type& base_form, const string_type& reading):
+    surface(surface), pos(pos), subcategory(subcategory), base_form(knownFeature(base_form)), reading(knownFeature(reading))
+{}
+
+Word::Word(const string_type& surface, const FeatureView& feature):
+    surface(surface),
+    pos(classifyPos([&feature](size_t i, const char* s){ return feature.equals(i, s); })),
+    subcategory(classifySubcategory([&feature](size_t i, const char* s){ return feature.equals(i, s); })),
+    base_form(knownFeature(feature[BASE_FORM_POS])), reading(knownFeature(feature[READING_POS]))
+{}
+
+Word::Word(const string_type& surface, const std::vector<string_type>& feature):
+    surface(surface),
+    pos(classifyPos([&feature](size_t i, const char* s){ return i < feature.size() && feature[i] == cast_string<string_type>(std::string(s)); })),
+    subcategory(classifySubcategory([&feature](size_t i, const char* s){ return i < feature.size() && feature[i] == cast_string<string_type>(std::string(s)); })),
+    base_form(BASE_FORM_POS < feature.size() ? knownFeature(feature[BASE_FORM_POS]) : string_type()),
+    reading(READING_POS < feature.size() ? knownFeature(feature[READING_POS]) : string_type())
+{}
+
+bool Word::operator==(const Word& other) const
+{
+    return surface == other.surface && pos == other.pos && subcategory == other.subcategory &&
+        base_form == other.base_form && reading == other.reading;
+}
+
+}
@@ -27,10 +27,83 @@ limitations under the License.
 
 namespace resembla {
 
+// comma-separated features of a morpheme in MeCab output, read without copy.
+// empty fields are skipped and fields are decoded only when requested
+class FeatureView
+{
+public:
+    FeatureView(const char* begin, const char* end);
+    FeatureView(const std::string& feature);
+
+    // number of non-empty fields
+    size_t size() const;
+
+    // returns the pos-th non-empty field, or an empty string if not exists
+    string_type operator[](size_t pos) const;
+
+    // compares the pos-th non-empty field with a UTF-8 string without decoding
+    bool equals(size_t pos, const char* utf8) const;
+
+protected:
+    const char* begin;
+    const char* end;
+
+    bool find(size_t pos, const char*& field_begin, const char*& field_end) const;
+};
+
+// result of morphological analysis before conversion into tokens of a measure
+struct Morpheme
+{
+    string_type surface;
+    std::string feature;
+
+    FeatureView features() const
+    {
+        return FeatureView(feature);
+    }
+};
+
+// word with the features used by word-based measures
 struct Word
 {
+    enum PartOfSpeech: unsigned char
+    {
+        OTHER_POS,
+        NOUN,
+        VERB,
+        ADJECTIVE
+    };
+
+    enum Subcategory: unsigned char
+    {
+        OTHER_SUBCATEGORY,
+        SUFFIX,
+        NON_INDEPENDENT,
+        ADVERBIAL,
+        PRONOUN
+    };
+
+    static const size_t POS_POS;
+    static const size_t SUBCATEGORY_POS;
+    static const size_t BASE_FORM_POS;
+    static const size_t READING_POS;
+
     string_type surface;
-    std::vector<string_type> feature;
+    PartOfSpeech pos;
+    Subcategory subcategory;
+    // empty if unknown
+    string_type base_form;
+    string_type reading;
+
+    Word();
+    Word(const string_type& surface, PartOfSpeech pos, Subcategory subcategory,
+            const string_type& base_form, const string_type& reading);
+    // picks features from MeCab output
+    Word(const string_type& surface, const FeatureView& feature);
+    // picks features from decoded MeCab features
+    Word(const string_type& surface, const std::vector<string_type>& feature);
+
+    bool operator==(const Word& other) const;
 };
 
 }
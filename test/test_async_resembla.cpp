@@ -0,0 +1,133 @@
+/*
+Resembla: Word-based Japanese similar sentence search library
+https://github.com/tuem/resembla
+
+Copyright 2017 Takashi Uemura
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <future>
+#include <mutex>
+#include <condition_variable>
+#include <stdexcept>
+#include <chrono>
+
+#include "Catch/catch.hpp"
+
+#include "string_util.hpp"
+
+#include "async_resembla.hpp"
+#include "thread_affinity.hpp"
+
+using namespace resembla;
+
+// returns the query itself after the gate is opened
+class GatedResembla: public ResemblaInterface
+{
+public:
+    void waitStarted(size_t n)
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        gate.wait(lock, [this, n](){ return started >= n; });
+    }
+
+    void open()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            opened = true;
+        }
+        gate.notify_all();
+    }
+
+    std::vector<output_type> find(const string_type& query, double threshold = 0.0, size_t = 0) const
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        ++started;
+        gate.notify_all();
+        gate.wait(lock, [this](){ return opened; });
+        if(query.empty()){
+            throw std::invalid_argument("empty query");
+        }
+        return {{query, "gated", threshold}};
+    }
+
+    std::vector<output_type> eval(const string_type& query, const std::vector<string_type>&,
+            double threshold = 0.0, size_t max_response = 0) const
+    {
+        return find(query, threshold, max_response);
+    }
+
+private:
+    mutable std::mutex mutex;
+    mutable std::condition_variable gate;
+    mutable size_t started = 0;
+    bool opened = false;
+};
+
+TEST_CASE( "async resembla: future and callback", "[language]" ) {
+    init_locale();
+    auto gated = std::make_shared<GatedResembla>();
+    gated->open();
+    AsyncResembla async(gated, 2);
+
+    auto future = async.find_async(RESEMBLA_TEXT("あい"), 0.5, 10);
+    auto response = future.get();
+    REQUIRE(response.size() == 1);
+    CHECK(response[0].text == RESEMBLA_TEXT("あい"));
+    CHECK(response[0].score == 0.5);
+
+    CHECK_THROWS_AS(async.eval_async(RESEMBLA_TEXT(""), {RESEMBLA_TEXT("あい")}, 0.5, 10).get(), const std::invalid_argument&);
+
+    std::promise<string_type> received;
+    async.find_async(RESEMBLA_TEXT("うえ"), 0.3, 10, [&received](std::vector<AsyncResembla::output_type>&& response, std::exception_ptr error){
+        received.set_value(error || response.empty() ? RESEMBLA_TEXT("") : response[0].text);
+    });
+    CHECK(received.get_future().get() == RESEMBLA_TEXT("うえ"));
+}
+
+TEST_CASE( "async resembla: reject requests when queue is full", "[language]" ) {
+    init_locale();
+    auto gated = std::make_shared<GatedResembla>();
+    AsyncResembla async(gated, 1, 1);
+
+    auto running = async.find_async(RESEMBLA_TEXT("あ"));
+    gated->waitStarted(1);
+    auto queued = async.find_async(RESEMBLA_TEXT("い"));
+    auto rejected = async.find_async(RESEMBLA_TEXT("う"));
+    REQUIRE(rejected.wait_for(std::chrono::seconds(0)) == std::future_status::ready);
+    CHECK_THROWS_AS(rejected.get(), const std::runtime_error&);
+
+    gated->open();
+    CHECK(running.get()[0].text == RESEMBLA_TEXT("あ"));
+    CHECK(queued.get()[0].text == RESEMBLA_TEXT("い"));
+}
+
+TEST_CASE( "async resembla: bind threads to CPUs", "[language]" ) {
+    init_locale();
+    CHECK(parse_cpu_list("") == std::vector<size_t>{});
+    CHECK(parse_cpu_list("0-2,5") == (std::vector<size_t>{0, 1, 2, 5}));
+    CHECK_THROWS_AS(parse_cpu_list("3-1"), const std::invalid_argument&);
+    CHECK_THROWS_AS(parse_cpu_list("0,,1"), const std::invalid_argument&);
+    CHECK_THROWS_AS(parse_cpu_list("a"), const std::invalid_argument&);
+
+    // binding fails on unavailable CPUs, but requests are still processed
+    auto gated = std::make_shared<GatedResembla>();
+    gated->open();
+    AsyncResembla async(gated, 3, 0, {0, 100000});
+    CHECK(async.find_async(RESEMBLA_TEXT("あい")).get()[0].text == RESEMBLA_TEXT("あい"));
+}
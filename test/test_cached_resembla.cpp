@@ -0,0 +1,133 @@
+/*
+Resembla: Word-based Japanese similar sentence search library
+https://github.com/tuem/resembla
+
+Copyright 2017 Takashi Uemura
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <chrono>
+#include <iostream>
+#include <stdexcept>
+
+#include "Catch/catch.hpp"
+
+#include "string_util.hpp"
+
+#include "cached_resembla.hpp"
+
+using namespace resembla;
+
+// returns the query itself and counts calls
+class EchoResembla: public ResemblaInterface
+{
+public:
+    mutable size_t calls = 0;
+
+    std::vector<output_type> find(const string_type& query, double threshold = 0.0, size_t = 0) const
+    {
+        ++calls;
+        return {{query, "echo", threshold}};
+    }
+
+    std::vector<output_type> eval(const string_type& query, const std::vector<string_type>&,
+            double threshold = 0.0, size_t max_response = 0) const
+    {
+        return find(query, threshold, max_response);
+    }
+};
+
+TEST_CASE( "cached resembla: hits and misses", "[language]" ) {
+    init_locale();
+    auto echo = std::make_shared<EchoResembla>();
+    CachedResembla cache(echo, 1 << 20, 4);
+
+    CHECK(cache.find(RESEMBLA_TEXT("あい"), 0.5, 10)[0].text == RESEMBLA_TEXT("あい"));
+    CHECK(cache.find(RESEMBLA_TEXT("あい"), 0.5, 10)[0].text == RESEMBLA_TEXT("あい"));
+    CHECK(cache.find(RESEMBLA_TEXT("あい"), 0.3, 10)[0].score == 0.3);
+    CHECK(cache.find(RESEMBLA_TEXT("あい"), 0.3, 5)[0].score == 0.3);
+    CHECK(echo->calls == 3);
+    CHECK(cache.hits() == 1);
+    CHECK(cache.misses() == 3);
+    CHECK(cache.size() == 3);
+
+    cache.invalidate();
+    CHECK(cache.size() == 0);
+    CHECK(cache.bytes() == 0);
+    cache.find(RESEMBLA_TEXT("あい"), 0.5, 10);
+    CHECK(echo->calls == 4);
+}
+
+TEST_CASE( "cached resembla: memory limit", "[language]" ) {
+    init_locale();
+    auto echo = std::make_shared<EchoResembla>();
+    CachedResembla cache(echo, 4096, 1);
+
+    for(int i = 0; i < 100; ++i){
+        cache.find(cast_string<string_type>(std::to_string(i)));
+        CHECK(cache.bytes() <= 4096);
+    }
+    CHECK(cache.size() < 100);
+
+    // the most recently used entry survives
+    cache.find(RESEMBLA_TEXT("1"));
+    cache.find(RESEMBLA_TEXT("0"));
+    for(int i = 100; i < 200; ++i){
+        cache.find(RESEMBLA_TEXT("0"));
+        cache.find(cast_string<string_type>(std::to_string(i)));
+    }
+    size_t calls = echo->calls;
+    cache.find(RESEMBLA_TEXT("0"));
+    CHECK(echo->calls == calls);
+}
+
+TEST_CASE( "cached resembla: expiration", "[language]" ) {
+    init_locale();
+    auto echo = std::make_shared<EchoResembla>();
+    CachedResembla cache(echo, 1 << 20, 1, 0.02);
+
+    cache.find(RESEMBLA_TEXT("あい"));
+    cache.find(RESEMBLA_TEXT("あい"));
+    CHECK(echo->calls == 1);
+    std::this_thread::sleep_for(std::chrono::milliseconds(40));
+    cache.find(RESEMBLA_TEXT("あい"));
+    CHECK(echo->calls == 2);
+}
+
+TEST_CASE( "cached resembla: invalid parameters", "[language]" ) {
+    auto echo = std::make_shared<EchoResembla>();
+    CHECK_THROWS_AS(CachedResembla(echo, 1 << 20, 0), std::invalid_argument&);
+    CHECK_THROWS_AS(CachedResembla(echo, 1 << 20, 1, -1.0), std::invalid_argument&);
+}
+
+TEST_CASE( "cached resembla: batch", "[language]" ) {
+    init_locale();
+    auto echo = std::make_shared<EchoResembla>();
+    CachedResembla cache(echo, 1 << 20, 4);
+
+    cache.find(RESEMBLA_TEXT("あい"), 0.5, 10);
+    auto results = cache.find_batch({RESEMBLA_TEXT("あい"), RESEMBLA_TEXT("いう"), RESEMBLA_TEXT("あい")}, 0.5, 10);
+    REQUIRE(results.size() == 3);
+    CHECK(results[0][0].text == RESEMBLA_TEXT("あい"));
+    CHECK(results[1][0].text == RESEMBLA_TEXT("いう"));
+    CHECK(results[2][0].text == RESEMBLA_TEXT("あい"));
+    CHECK(echo->calls == 2);
+    CHECK(cache.hits() == 2);
+    CHECK(cache.find(RESEMBLA_TEXT("いう"), 0.5, 10)[0].text == RESEMBLA_TEXT("いう"));
+    CHECK(echo->calls == 2);
+}
@@ -0,0 +1,95 @@
+/*
+Resembla: Word-based Japanese similar sentence search library
+https://github.com/tuem/resembla
+
+Copyright 2017 Takashi Uemura
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <vector>
+#include <limits>
+
+#include "Catch/catch.hpp"
+
+#include "cascade.hpp"
+
+using namespace resembla;
+
+void test_cascade_select(size_t size, double min_score, const std::vector<double>& scores,
+        const std::vector<size_t>& correct)
+{
+    Cascade cascade;
+    cascade.configure(size, min_score);
+    CHECK(cascade.select(scores) == correct);
+}
+
+TEST_CASE( "cascade: select all without limits", "[cascade]" ) {
+    Cascade cascade;
+    CHECK_FALSE(cascade.enabled());
+    test_cascade_select(0, 0.0, {0.3, 0.1, 0.2}, {0, 1, 2});
+    test_cascade_select(0, 0.0, {}, {});
+}
+
+TEST_CASE( "cascade: select top candidates", "[cascade]" ) {
+    test_cascade_select(2, 0.0, {0.3, 0.1, 0.2, 0.5}, {0, 3});
+    test_cascade_select(1, 0.0, {0.3, 0.1, 0.2, 0.5}, {3});
+    test_cascade_select(4, 0.0, {0.3, 0.1, 0.2, 0.5}, {0, 1, 2, 3});
+    test_cascade_select(5, 0.0, {0.3, 0.1, 0.2, 0.5}, {0, 1, 2, 3});
+
+    // missing scores are ranked last
+    const double missing = -std::numeric_limits<double>::infinity();
+    test_cascade_select(2, 0.0, {missing, 0.1, missing, 0.2}, {1, 3});
+}
+
+TEST_CASE( "cascade: ties are selected in original order", "[cascade]" ) {
+    test_cascade_select(2, 0.0, {0.2, 0.5, 0.2, 0.2}, {0, 1});
+    test_cascade_select(3, 0.0, {0.2, 0.2, 0.2, 0.2, 0.2}, {0, 1, 2});
+    test_cascade_select(2, 0.0, {0.1, 0.4, 0.4, 0.4}, {1, 2});
+}
+
+TEST_CASE( "cascade: select candidates with minimum score", "[cascade]" ) {
+    test_cascade_select(0, 0.2, {0.3, 0.1, 0.2, 0.5}, {0, 2, 3});
+    test_cascade_select(0, 0.6, {0.3, 0.1, 0.2, 0.5}, {});
+    const double missing = -std::numeric_limits<double>::infinity();
+    test_cascade_select(0, 0.1, {missing, 0.1}, {1});
+
+    // both limits
+    test_cascade_select(2, 0.2, {0.3, 0.1, 0.2, 0.5}, {0, 3});
+    test_cascade_select(2, 0.4, {0.3, 0.1, 0.2, 0.5}, {3});
+}
+
+TEST_CASE( "cascade: count queries", "[cascade]" ) {
+    Cascade cascade;
+    cascade.configure(2, 0.0, 3);
+    CHECK(cascade.enabled());
+
+    std::vector<bool> checked;
+    for(size_t i = 0; i < 7; ++i){
+        checked.push_back(cascade.countCascaded());
+    }
+    CHECK(checked == std::vector<bool>({false, false, true, false, false, true, false}));
+    cascade.countChanged();
+    CHECK(cascade.cascadedQueries() == 7);
+    CHECK(cascade.checkedQueries() == 2);
+    CHECK(cascade.changedQueries() == 1);
+
+    // never checked without interval
+    Cascade unchecked;
+    unchecked.configure(2);
+    for(size_t i = 0; i < 5; ++i){
+        CHECK_FALSE(unchecked.countCascaded());
+    }
+    CHECK(unchecked.cascadedQueries() == 5);
+    CHECK(unchecked.checkedQueries() == 0);
+}
@@ -0,0 +1,76 @@
+/*
+Resembla: Word-based Japanese similar sentence search library
+https://github.com/tuem/resembla
+
+Copyright 2017 Takashi Uemura
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <string>
+#include <vector>
+#include <iostream>
+
+#include "Catch/catch.hpp"
+
+#include "string_util.hpp"
+
+#include "eliminator.hpp"
+
+using namespace resembla;
+
+void test_eliminator_distance(const std::wstring& pattern, const std::wstring& text, int correct)
+{
+    init_locale();
+    Eliminator<std::wstring> eliminate(pattern);
+    CHECK(eliminate.distance(text) == correct);
+}
+
+TEST_CASE( "eliminator: distance", "[language]" ) {
+    test_eliminator_distance(L"", L"", 0);
+    test_eliminator_distance(L"", L"abc", 3);
+    test_eliminator_distance(L"abc", L"", 3);
+    test_eliminator_distance(L"abc", L"abc", 0);
+    test_eliminator_distance(L"kitten", L"sitting", 3);
+    test_eliminator_distance(L"京都市北区", L"京都府北区", 1);
+    test_eliminator_distance(std::wstring(100, L'a') + L"b", std::wstring(100, L'a'), 1);
+    test_eliminator_distance(std::wstring(70, L'あ'), std::wstring(65, L'あ') + L"いいいいい", 5);
+}
+
+TEST_CASE( "eliminator: keep k candidates with their distances", "[language]" ) {
+    init_locale();
+    Eliminator<std::wstring> eliminate(L"abcd");
+    std::vector<std::wstring> candidates = {L"xyz", L"abcd", L"abxd", L"wxyz", L"abc"};
+    std::vector<int> distances;
+    eliminate(candidates, 3, distances);
+    REQUIRE(candidates.size() == 3);
+    REQUIRE(distances.size() == 3);
+    CHECK(candidates[0] == L"abcd");
+    CHECK(candidates[1] == L"abxd");
+    CHECK(candidates[2] == L"abc");
+    CHECK(distances[0] == 0);
+    CHECK(distances[1] == 1);
+    CHECK(distances[2] == 1);
+}
+
+TEST_CASE( "eliminator: reuse with different patterns", "[language]" ) {
+    init_locale();
+    Eliminator<std::wstring> eliminate;
+    eliminate.init(std::wstring(130, L'z'));
+    CHECK(eliminate.distance(std::wstring(128, L'z')) == 2);
+    eliminate.init(L"ab");
+    CHECK(eliminate.distance(L"ab") == 0);
+    CHECK(eliminate.distance(L"zb") == 1);
+    eliminate.init(L"");
+    CHECK(eliminate.distance(L"ab") == 2);
+}
@@ -0,0 +1,262 @@
+/*
+Resembla: Word-based Japanese similar sentence search library
+https://github.com/tuem/resembla
+
+Copyright 2017 Takashi Uemura
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <string>
+#include <vector>
+#include <memory>
+
+#include "Catch/catch.hpp"
+
+#include "string_util.hpp"
+
+#include "regression/feature.hpp"
+#include "regression/extractor/feature_extractor.hpp"
+#include "regression/aggregator/feature_aggregator.hpp"
+#include "regression/aggregator/flag_feature_aggregator.hpp"
+#include "regression/aggregator/real_feature_aggregator.hpp"
+#include "regression/aggregator/interval_feature_aggregator.hpp"
+#include "regression/predictor/prejudiced_predictor.hpp"
+
+using namespace resembla;
+
+std::shared_ptr<const FeatureSchema> test_feature_schema()
+{
+    return std::make_shared<const FeatureSchema>(std::vector<std::vector<std::string>>{
+        {"base_similarity", "-", "-"},
+        {"is_question", "re", "flag"},
+        {"sentiment", "re", "real"},
+        {"open_hours", "-", "interval"}
+    });
+}
+
+struct TestLengthFeature
+{
+    Feature::real_type operator()(const string_type& text) const
+    {
+        return static_cast<Feature::real_type>(text.size());
+    }
+};
+
+TEST_CASE( "assign positions to features", "[regression]" ) {
+    auto schema = test_feature_schema();
+    CHECK(schema->size() == 4);
+    CHECK(schema->width() == 5);
+    CHECK(schema->index("sentiment") == 2);
+    CHECK(schema->offset(2) == 2);
+    CHECK(schema->offset(3) == 3);
+    CHECK(schema->width(3) == 2);
+    CHECK(schema->find("unknown") == FeatureSchema::npos);
+    CHECK_THROWS(schema->index("unknown"));
+
+    auto x = schema->parse({{"is_question", "1"}, {"open_hours", "0900,1800"}, {"unknown", "3"}});
+    REQUIRE(x.size() == 5);
+    CHECK(Feature::isMissing(x[0]));
+    CHECK(x[1] == Approx(1.0));
+    CHECK(Feature::isMissing(x[2]));
+    CHECK(x[3] == Approx(900.0));
+    CHECK(x[4] == Approx(1800.0));
+
+    auto texts = schema->format(x);
+    CHECK(texts.size() == 2);
+    CHECK(texts["is_question"] == "1");
+    CHECK(texts["open_hours"] == "900,1800");
+}
+
+TEST_CASE( "extract features into vectors", "[regression]" ) {
+    init_locale();
+
+    auto schema = test_feature_schema();
+    FeatureExtractor extract(schema);
+    extract.append("sentiment", std::make_shared<FeatureExtractor::StringToRealFunction<TestLengthFeature>>());
+    CHECK_THROWS(extract.append("unknown", std::make_shared<FeatureExtractor::StringToRealFunction<TestLengthFeature>>()));
+
+    auto x = extract(RESEMBLA_TEXT("テスト"));
+    CHECK(x[2] == Approx(3.0));
+    CHECK(Feature::isMissing(x[1]));
+
+    // given features are not extracted again
+    auto y = extract(RESEMBLA_TEXT("テスト"), schema->parse({{"sentiment", "0.5"}}));
+    CHECK(y[2] == Approx(0.5));
+
+    auto z = extract("テスト", "sentiment=-1&is_question=1");
+    CHECK(z[2] == Approx(-1.0));
+    CHECK(Feature::isMissing(z[1]));
+
+    auto texts = extract(RESEMBLA_TEXT("テキスト\tsentiment=2"), true);
+    CHECK(texts.size() == 1);
+    CHECK(texts["sentiment"] == "2");
+}
+
+TEST_CASE( "aggregate vectors of features", "[regression]" ) {
+    auto schema = test_feature_schema();
+    FeatureAggregator aggregate(schema);
+    aggregate.append("base_similarity", nullptr);
+    aggregate.append("is_question", std::make_shared<FlagFeatureAggregator>());
+    aggregate.append("sentiment", std::make_shared<RealFeatureAggregator>());
+    aggregate.append("open_hours", std::make_shared<IntervalFeatureAggregator>());
+
+    auto a = schema->parse({{"is_question", "1"}, {"sentiment", "0.5"}, {"open_hours", "1200"}});
+    auto b = schema->parse({{"base_similarity", "0.8"}, {"is_question", "1"}, {"open_hours", "0900,1800"}});
+    auto x = aggregate(a, b);
+    REQUIRE(x.size() == 4);
+    CHECK(x[0] == Approx(0.8));
+    CHECK(x[1] == Approx(1.0));
+    CHECK(x[2] == Approx(0.5));
+    CHECK(x[3] == Approx(1.0));
+
+    auto c = schema->parse({{"open_hours", "2000,0800"}});
+    CHECK(aggregate(a, c)[3] == Approx(-1.0));
+    CHECK(Feature::isMissing(aggregate(c, c)[0]));
+
+    PrejudicedPredictor predict(*schema);
+    CHECK(predict(x) == Approx(0.8));
+    CHECK_THROWS(predict(aggregate(c, c)));
+
+    // batch aggregation gives the same results as aggregation of each pair
+    auto d = schema->parse({{"sentiment", "-0.3"}, {"open_hours", "1000,1100"}});
+    std::vector<const FeatureVector*> references = {&b, &c, &d, &a};
+    auto xs = aggregate(a, references);
+    REQUIRE(xs.size() == references.size());
+    for(size_t i = 0; i < references.size(); ++i){
+        auto y = aggregate(a, *references[i]);
+        REQUIRE(xs[i].size() == y.size());
+        for(size_t j = 0; j < y.size(); ++j){
+            CHECK((xs[i][j] == y[j] || (Feature::isMissing(xs[i][j]) && Feature::isMissing(y[j]))));
+        }
+    }
+}
+
+bool same_feature_vectors(const FeatureVector& x, const FeatureVector& y)
+{
+    if(x.size() != y.size()){
+        return false;
+    }
+    for(size_t i = 0; i < x.size(); ++i){
+        if(!(x[i] == y[i] || (Feature::isMissing(x[i]) && Feature::isMissing(y[i])))){
+            return false;
+        }
+    }
+    return true;
+}
+
+TEST_CASE( "overlay values on vectors of features", "[regression]" ) {
+    auto schema = test_feature_schema();
+    FeatureAggregator aggregate(schema);
+    aggregate.append("base_similarity", nullptr);
+    aggregate.append("is_question", std::make_shared<FlagFeatureAggregator>());
+    aggregate.append("sentiment", std::make_shared<RealFeatureAggregator>());
+    aggregate.append("open_hours", std::make_shared<IntervalFeatureAggregator>());
+
+    auto a = schema->parse({{"is_question", "1"}, {"sentiment", "0.5"}, {"open_hours", "1200"}});
+    auto b = schema->parse({{"base_similarity", "0.8"}, {"is_question", "0"}, {"open_hours", "0900,1800"}});
+    const std::vector<size_t> offsets = {schema->offset(schema->index("base_similarity")),
+            schema->offset(schema->index("sentiment"))};
+    const std::vector<std::vector<Feature::real_type>> values = {
+        {Feature::missing(), Feature::missing()},
+        {0.3, Feature::missing()},
+        {Feature::missing(), -0.7},
+        {0.6, 0.2}};
+
+    // overlaid vectors are the same as copies with values replaced
+    std::vector<FeatureVector> copies;
+    std::vector<FeatureOverlay> overlays;
+    for(const auto& v: values){
+        for(const auto* x: {&a, &b}){
+            FeatureVector copied = *x;
+            for(size_t i = 0; i < offsets.size(); ++i){
+                if(!Feature::isMissing(v[i])){
+                    copied[offsets[i]] = v[i];
+                }
+            }
+            copies.push_back(copied);
+            overlays.push_back(FeatureOverlay(*x, offsets, v.data()));
+        }
+    }
+    for(size_t n = 0; n < copies.size(); ++n){
+        REQUIRE(overlays[n].size() == copies[n].size());
+        FeatureVector overlaid;
+        for(size_t i = 0; i < overlays[n].size(); ++i){
+            overlaid.push_back(overlays[n][i]);
+        }
+        CHECK(same_feature_vectors(overlaid, copies[n]));
+    }
+
+    // and aggregated into the same vectors
+    std::vector<const FeatureVector*> copy_references;
+    std::vector<const FeatureOverlay*> overlay_references;
+    for(size_t n = 0; n < copies.size(); ++n){
+        copy_references.push_back(&copies[n]);
+        overlay_references.push_back(&overlays[n]);
+    }
+    for(size_t n = 0; n < copies.size(); ++n){
+        for(size_t m = 0; m < copies.size(); ++m){
+            CHECK(same_feature_vectors(aggregate(overlays[n], overlays[m]), aggregate(copies[n], copies[m])));
+        }
+        auto xs = aggregate(overlays[n], overlay_references);
+        auto ys = aggregate(copies[n], copy_references);
+        REQUIRE(xs.size() == ys.size());
+        for(size_t m = 0; m < xs.size(); ++m){
+            CHECK(same_feature_vectors(xs[m], ys[m]));
+        }
+    }
+}
+
+struct TestDifferenceFeature
+{
+    Feature::real_type operator()(Feature::real_type a, Feature::real_type b) const
+    {
+        return a - b;
+    }
+};
+
+// overrides a function defined in the library
+struct TestNegatedIntervalFeature: public IntervalFeatureAggregator
+{
+    Feature::real_type operator()(const Feature::real_type* a, const Feature::real_type* b) const
+    {
+        return -IntervalFeatureAggregator::operator()(a, b);
+    }
+};
+
+TEST_CASE( "aggregate vectors with user-defined functions", "[regression]" ) {
+    auto schema = test_feature_schema();
+    FeatureAggregator aggregate(schema);
+    aggregate.append("sentiment", std::make_shared<FeatureAggregator::RealsToRealFunction<TestDifferenceFeature>>());
+    aggregate.append("is_question", std::make_shared<FlagFeatureAggregator>());
+    // replaces the function appended before
+    aggregate.append("is_question", std::make_shared<FeatureAggregator::RealsToRealFunction<TestDifferenceFeature>>());
+
+    auto a = schema->parse({{"is_question", "1"}, {"sentiment", "0.5"}});
+    auto b = schema->parse({{"is_question", "-1"}, {"sentiment", "0.25"}});
+    auto x = aggregate(a, b);
+    CHECK(x[1] == Approx(2.0));
+    CHECK(x[2] == Approx(0.25));
+
+    auto xs = aggregate(b, std::vector<const FeatureVector*>{&a});
+    REQUIRE(xs.size() == 1);
+    CHECK(xs[0][1] == Approx(-2.0));
+    CHECK(xs[0][2] == Approx(-0.25));
+
+    // subclasses of functions in the library are not replaced with the original ones
+    aggregate.append("open_hours", std::make_shared<TestNegatedIntervalFeature>());
+    auto c = schema->parse({{"open_hours", "1200"}});
+    auto d = schema->parse({{"open_hours", "0900,1800"}});
+    CHECK(aggregate(c, d)[3] == Approx(-1.0));
+    CHECK(aggregate(c, std::vector<const FeatureVector*>{&d})[0][3] == Approx(-1.0));
+}
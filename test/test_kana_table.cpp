@@ -0,0 +1,164 @@
+/*
+Resembla: Word-based Japanese similar sentence search library
+https://github.com/tuem/resembla
+
+Copyright 2017 Takashi Uemura
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Catch/catch.hpp"
+
+#include "string_util.hpp"
+
+#include "measure/kana_table.hpp"
+
+using namespace resembla;
+
+using kana_token_type = string_type::value_type;
+
+string_type kana_table_to_string(const char32_t* s)
+{
+    string_type t;
+    for(; *s != 0; ++s){
+        t.push_back(static_cast<kana_token_type>(*s));
+    }
+    return t;
+}
+
+// straightforward conversion with hash maps, as a reference for the table
+struct KanaTableReference
+{
+    std::unordered_map<kana_token_type, string_type> katakana;
+    std::unordered_map<string_type, string_type> romaji;
+
+    KanaTableReference()
+    {
+        for(size_t i = 0; i < KanaTable::KATAKANA_MAPPINGS_SIZE; ++i){
+            const auto& m = KanaTable::KATAKANA_MAPPINGS[i];
+            katakana[static_cast<kana_token_type>(m.from[0])] = kana_table_to_string(m.to);
+        }
+        for(size_t i = 0; i < KanaTable::ROMAJI_MAPPINGS_SIZE; ++i){
+            const auto& m = KanaTable::ROMAJI_MAPPINGS[i];
+            romaji[kana_table_to_string(m.from)] = kana_table_to_string(m.to);
+        }
+    }
+
+    string_type toKatakana(const string_type& text) const
+    {
+        string_type y;
+        for(auto c: text){
+            if(katakana.find(c) == katakana.end()){
+                y.push_back(c);
+            }
+            else{
+                y += katakana.at(c);
+            }
+        }
+        return y;
+    }
+
+    string_type toRomaji(const string_type& pronunciation) const
+    {
+        string_type s;
+        for(size_t i = 0; i < pronunciation.size(); ++i){
+            string_type p = {pronunciation[i]};
+            if(i + 1 < pronunciation.size()){
+                auto q = p + pronunciation[i + 1];
+                if(romaji.find(q) != romaji.end()){
+                    if(p == RESEMBLA_TEXT("ッ")){
+                        p = {romaji.at(q)[0]};
+                    }
+                    else{
+                        p = q;
+                        ++i;
+                    }
+                }
+            }
+            if(romaji.count(p) > 0){
+                p = romaji.at(p);
+            }
+            s += p;
+        }
+        return s;
+    }
+};
+
+std::vector<kana_token_type> kana_table_test_letters()
+{
+    std::vector<kana_token_type> letters = {RESEMBLA_TEXT('a'), RESEMBLA_TEXT('-'), RESEMBLA_TEXT('漢')};
+    for(char32_t c = 0x3030; c < 0x3110; ++c){
+        letters.push_back(static_cast<kana_token_type>(c));
+    }
+    return letters;
+}
+
+TEST_CASE( "kana table: katakana of all letters", "[language]" ) {
+    const auto& table = KanaTable::get();
+    KanaTableReference reference;
+
+    for(auto c: kana_table_test_letters()){
+        string_type s = {c};
+        string_type t;
+        table.appendKatakana(c, t);
+        CHECK(t == reference.toKatakana(s));
+        CHECK(table.isKana(c) == (reference.katakana.count(c) > 0));
+    }
+}
+
+TEST_CASE( "kana table: romaji of all sequences up to three letters", "[language]" ) {
+    const auto& table = KanaTable::get();
+    KanaTableReference reference;
+    const auto letters = kana_table_test_letters();
+
+    size_t mismatches = 0;
+    for(auto c: letters){
+        for(auto d: letters){
+            string_type s = {c, d};
+            string_type t;
+            table.appendRomaji(s, t);
+            if(t != reference.toRomaji(s)){
+                ++mismatches;
+            }
+        }
+    }
+
+    // lookahead only matters within the katakana block
+    string_type s(3, 0), t;
+    for(char32_t c = 0x30a0; c < 0x3100; ++c){
+        for(char32_t d = 0x30a0; d < 0x3100; ++d){
+            for(char32_t e = 0x30a0; e < 0x3100; ++e){
+                s[0] = static_cast<kana_token_type>(c);
+                s[1] = static_cast<kana_token_type>(d);
+                s[2] = static_cast<kana_token_type>(e);
+                t.clear();
+                table.appendRomaji(s, t);
+                if(t != reference.toRomaji(s)){
+                    ++mismatches;
+                }
+            }
+        }
+    }
+    CHECK(mismatches == 0);
+
+    t.clear();
+    table.appendRomaji(RESEMBLA_TEXT("ヴァイヴレーション"), t);
+    CHECK(t == RESEMBLA_TEXT("VAIVURE-Syon"));
+    t.clear();
+    table.appendRomaji(RESEMBLA_TEXT("スカッシュ"), t);
+    CHECK(t == RESEMBLA_TEXT("SUKAsSyu"));
+}
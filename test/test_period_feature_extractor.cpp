@@ -0,0 +1,62 @@
+/*
+Resembla: Word-based Japanese similar sentence search library
+https://github.com/tuem/resembla
+
+Copyright 2017 Takashi Uemura
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <ctime>
+#include <memory>
+
+#include "Catch/catch.hpp"
+
+#include "analysis_context.hpp"
+#include "regression/extractor/date_period_feature_extractor.hpp"
+#include "regression/extractor/time_period_feature_extractor.hpp"
+
+using namespace resembla;
+
+TEST_CASE( "extract date and time of request from analysis context", "[regression]" ) {
+    DatePeriodFeatureExtractor date_period;
+    TimePeriodFeatureExtractor time_period;
+
+    std::tm local = {};
+    local.tm_year = 117;
+    local.tm_mon = 11;
+    local.tm_mday = 24;
+    local.tm_hour = 23;
+    local.tm_min = 59;
+    local.tm_sec = 30;
+    local.tm_isdst = -1;
+    auto context = std::make_shared<AnalysisContext>(std::mktime(&local));
+    CHECK(context->localTime().tm_mday == 24);
+    {
+        AnalysisContext::Scope scope(context);
+        CHECK(date_period(RESEMBLA_TEXT("a")) == 1224);
+        CHECK(time_period(RESEMBLA_TEXT("a")) == 2359);
+
+        // nested scopes share the request time
+        AnalysisContext::Scope nested(RESEMBLA_TEXT("b"));
+        CHECK(AnalysisContext::current() == context);
+        CHECK(time_period(RESEMBLA_TEXT("b")) == 2359);
+    }
+
+    // without context, the current time is used
+    CHECK(AnalysisContext::current() == nullptr);
+    auto t = std::time(nullptr);
+    std::tm now;
+    localtime_r(&t, &now);
+    CHECK(date_period(RESEMBLA_TEXT("a")) == (now.tm_mon + 1) * 100 + now.tm_mday);
+}
@@ -32,128 +32,128 @@ const std::string PRONUNCIATION_SEQUENCE_PARSER_MECAB_OPTIONS = "-d ../misc/meca
 const size_t PRONUNCIATION_SEQUENCE_PARSER_MECAB_FUTURE_POS = 9;
 const std::string PRONUNCIATION_SEQUENCE_PARSER_MECAB_PRONUNCIATION_OF_MARKS = "記号";
 
-void test_pronunciation_sequence_builder_build(const std::wstring& input, const std::wstring& correct)
+void test_pronunciation_sequence_builder_build(const string_type& input, const string_type& correct)
 {
     init_locale();
     PronunciationSequenceBuilder preprocess(PRONUNCIATION_SEQUENCE_PARSER_MECAB_OPTIONS, PRONUNCIATION_SEQUENCE_PARSER_MECAB_FUTURE_POS, PRONUNCIATION_SEQUENCE_PARSER_MECAB_PRONUNCIATION_OF_MARKS);
     auto answer = preprocess(input);
 #ifdef DEBUG
-    std::wcerr << "input text: " << input <<  std::endl;
-    std::wcerr << "pronunciation: " << answer << std::endl;
+    std::cerr << "input text: " << cast_string<std::string>(input) << std::endl;
+    std::cerr << "pronunciation: " << cast_string<std::string>(answer) << std::endl;
 #endif
     CHECK(answer == correct);
 }
 
-void test_pronunciation_sequence_builder_build_indexing_text(const std::wstring& input, const std::wstring& correct)
+void test_pronunciation_sequence_builder_build_indexing_text(const string_type& input, const string_type& correct)
 {
     init_locale();
     PronunciationSequenceBuilder preprocess(PRONUNCIATION_SEQUENCE_PARSER_MECAB_OPTIONS, PRONUNCIATION_SEQUENCE_PARSER_MECAB_FUTURE_POS, PRONUNCIATION_SEQUENCE_PARSER_MECAB_PRONUNCIATION_OF_MARKS);
     auto answer = preprocess.index(input);
 #ifdef DEBUG
-    std::wcerr << "input text: " << input <<  std::endl;
-    std::wcerr << "indexing text: " << answer <<  std::endl;
+    std::cerr << "input text: " << cast_string<std::string>(input) << std::endl;
+    std::cerr << "indexing text: " << cast_string<std::string>(answer) << std::endl;
 #endif
     CHECK(answer == correct);
 }
 
 TEST_CASE( "parse an empty string to pronunciation sequence", "[language]" ) {
-    std::wstring input = L"";
-    std::wstring correct = L"";
+    string_type input = RESEMBLA_TEXT("");
+    string_type correct = RESEMBLA_TEXT("");
     test_pronunciation_sequence_builder_build(input, correct);
 }
 
 TEST_CASE( "parse a katakana word to pronunciation sequence", "[language]" ) {
-    std::wstring input = L"シケン";
-    std::wstring correct = L"シケン";
+    string_type input = RESEMBLA_TEXT("シケン");
+    string_type correct = RESEMBLA_TEXT("シケン");
     test_pronunciation_sequence_builder_build(input, correct);
 }
 
 TEST_CASE( "parse a hiragana word to pronunciation sequence", "[language]" ) {
-    std::wstring input= L"しけん";
-    std::wstring correct = L"シケン";
+    string_type input= RESEMBLA_TEXT("しけん");
+    string_type correct = RESEMBLA_TEXT("シケン");
     test_pronunciation_sequence_builder_build(input, correct);
 }
 
 TEST_CASE( "parse a kanji word to pronunciation sequence", "[language]" ) {
-    std::wstring input = L"試験";
-    std::wstring correct = L"シケン";
+    string_type input = RESEMBLA_TEXT("試験");
+    string_type correct = RESEMBLA_TEXT("シケン");
     test_pronunciation_sequence_builder_build(input, correct);
 }
 
 TEST_CASE( "parse a sentence including hiragana, katakana and kanji to pronunciation sequence", "[language]" ) {
-    std::wstring input = L"このテストは難関です";
-    std::wstring correct = L"コノテストハナンカンデス";
+    string_type input = RESEMBLA_TEXT("このテストは難関です");
+    string_type correct = RESEMBLA_TEXT("コノテストハナンカンデス");
     test_pronunciation_sequence_builder_build(input, correct);
 }
 
 TEST_CASE( "parse a sentence including hiragana, katakana, kanji and unknown hiragana word to pronunciation sequence", "[language]" ) {
-    std::wstring input = L"平仮名の未知語ぁぃぅぇぉをカタカナに変換する";
-    std::wstring correct = L"ヒラガナノミチゴァィゥェォヲカタカナニヘンカンスル";
+    string_type input = RESEMBLA_TEXT("平仮名の未知語ぁぃぅぇぉをカタカナに変換する");
+    string_type correct = RESEMBLA_TEXT("ヒラガナノミチゴァィゥェォヲカタカナニヘンカンスル");
     test_pronunciation_sequence_builder_build(input, correct);
 }
 
 TEST_CASE( "parse a sentence including hiragana, katakana, kanji and unknown katakana word to pronunciation sequence", "[language]" ) {
-    std::wstring input = L"カタカナの未知語リセンブラをカタカナに変換する";
-    std::wstring correct = L"カタカナノミチゴリセンブラヲカタカナニヘンカンスル";
+    string_type input = RESEMBLA_TEXT("カタカナの未知語リセンブラをカタカナに変換する");
+    string_type correct = RESEMBLA_TEXT("カタカナノミチゴリセンブラヲカタカナニヘンカンスル");
     test_pronunciation_sequence_builder_build(input, correct);
 }
 
 TEST_CASE( "parse a sentence including hiragana, katakana, kanji and unknown kanji word to pronunciation sequence", "[language]" ) {
-    std::wstring input = L"漢字の未知語挫宛はそのまま出力される";
-    std::wstring correct = L"カンジノミチゴ挫宛ハソノママシュツリョクサレル";
+    string_type input = RESEMBLA_TEXT("漢字の未知語挫宛はそのまま出力される");
+    string_type correct = RESEMBLA_TEXT("カンジノミチゴ挫宛ハソノママシュツリョクサレル");
     test_pronunciation_sequence_builder_build(input, correct);
 }
 
 TEST_CASE( "parse a sentence including old hiraganas", "[language]" ) {
-    std::wstring input = L"ゐゑゔゕゖゝゞゟヰヱヿ";
-    std::wstring correct = L"イエヴヵヶヽヾヨリイエコト";
+    string_type input = RESEMBLA_TEXT("ゐゑゔゕゖゝゞゟヰヱヿ");
+    string_type correct = RESEMBLA_TEXT("イエヴヵヶヽヾヨリイエコト");
     test_pronunciation_sequence_builder_build(input, correct);
 }
 
 TEST_CASE( "parse a sentence including a conjugated form", "[language]" ) {
-    std::wstring input = L"今日はもう出かけなきゃ";
-    std::wstring correct = L"キョーハモウデカケナキャ";
+    string_type input = RESEMBLA_TEXT("今日はもう出かけなきゃ");
+    string_type correct = RESEMBLA_TEXT("キョーハモウデカケナキャ");
     test_pronunciation_sequence_builder_build(input, correct);
 }
 
 TEST_CASE( "parse a sentence including hiragana, katakana and kanji to text", "[language]" ) {
-    std::wstring input = L"このテストは難関です";
-    std::wstring correct = L"コノテストハナンカンデス";
+    string_type input = RESEMBLA_TEXT("このテストは難関です");
+    string_type correct = RESEMBLA_TEXT("コノテストハナンカンデス");
     test_pronunciation_sequence_builder_build_indexing_text(input, correct);
 }
 
 TEST_CASE( "parse a sentence including hiragana, katakana, kanji and unknown hiragana word to text", "[language]" ) {
-    std::wstring input = L"平仮名の未知語ぁぃぅぇぉをカタカナに変換する";
-    std::wstring correct = L"ヒラガナノミチゴァィゥェォヲカタカナニヘンカンスル";
+    string_type input = RESEMBLA_TEXT("平仮名の未知語ぁぃぅぇぉをカタカナに変換する");
+    string_type correct = RESEMBLA_TEXT("ヒラガナノミチゴァィゥェォヲカタカナニヘンカンスル");
     test_pronunciation_sequence_builder_build_indexing_text(input, correct);
 }
 
 TEST_CASE( "parse a sentence including hiragana, katakana, kanji and unknown katakana word to text", "[language]" ) {
-    std::wstring input = L"カタカナの未知語リセンブラをカタカナに変換する";
-    std::wstring correct = L"カタカナノミチゴリセンブラヲカタカナニヘンカンスル";
+    string_type input = RESEMBLA_TEXT("カタカナの未知語リセンブラをカタカナに変換する");
+    string_type correct = RESEMBLA_TEXT("カタカナノミチゴリセンブラヲカタカナニヘンカンスル");
     test_pronunciation_sequence_builder_build_indexing_text(input, correct);
 }
 
 TEST_CASE( "parse a sentence including hiragana, katakana, kanji and unknown kanji word to text", "[language]" ) {
-    std::wstring input = L"漢字の未知語挫宛はそのまま出力される";
-    std::wstring correct = L"カンジノミチゴ挫宛ハソノママシュツリョクサレル";
+    string_type input = RESEMBLA_TEXT("漢字の未知語挫宛はそのまま出力される");
+    string_type correct = RESEMBLA_TEXT("カンジノミチゴ挫宛ハソノママシュツリョクサレル");
     test_pronunciation_sequence_builder_build_indexing_text(input, correct);
 }
 
 TEST_CASE( "parse a sentence including old hiraganas to text", "[language]" ) {
-    std::wstring input = L"ゐゑゔゕゖゝゞゟヰヱヿ";
-    std::wstring correct = L"イエヴヵヶヽヾヨリイエコト";
+    string_type input = RESEMBLA_TEXT("ゐゑゔゕゖゝゞゟヰヱヿ");
+    string_type correct = RESEMBLA_TEXT("イエヴヵヶヽヾヨリイエコト");
     test_pronunciation_sequence_builder_build_indexing_text(input, correct);
 }
 
 TEST_CASE( "parse a sentence including a conjugated form to text", "[language]" ) {
-    std::wstring input = L"今日はもう出かけなきゃ";
-    std::wstring correct = L"キョーハモウデカケナキャ";
+    string_type input = RESEMBLA_TEXT("今日はもう出かけなきゃ");
+    string_type correct = RESEMBLA_TEXT("キョーハモウデカケナキャ");
     test_pronunciation_sequence_builder_build_indexing_text(input, correct);
 }
 
 TEST_CASE( "parse a sentence including marks to text", "[language]" ) {
-    std::wstring input = L"あっ!!今日何の日だっけ？教えて。";
-    std::wstring correct = L"アッ!!キョーナンノヒダッケ？オシエテ。";
+    string_type input = RESEMBLA_TEXT("あっ!!今日何の日だっけ？教えて。");
+    string_type correct = RESEMBLA_TEXT("アッ!!キョーナンノヒダッケ？オシエテ。");
     test_pronunciation_sequence_builder_build_indexing_text(input, correct);
 }
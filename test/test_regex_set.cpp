@@ -0,0 +1,157 @@
+/*
+Resembla: Word-based Japanese similar sentence search library
+https://github.com/tuem/resembla
+
+Copyright 2017 Takashi Uemura
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <string>
+#include <vector>
+#include <regex>
+#include <random>
+#include <fstream>
+#include <set>
+
+#include "Catch/catch.hpp"
+
+#include "string_util.hpp"
+
+#include "regression/extractor/regex_set.hpp"
+#include "regression/extractor/regex_feature_extractor.hpp"
+
+using namespace resembla;
+
+static size_t regex_set_match_one_by_one(const std::vector<std::string>& patterns, const string_type& text)
+{
+    const auto target = cast_string<std::wstring>(text);
+    for(size_t i = 0; i < patterns.size(); ++i){
+        if(std::regex_match(target, std::wregex(cast_string<std::wstring>(patterns[i])))){
+            return i;
+        }
+    }
+    return RegexSet::npos;
+}
+
+static void test_regex_set(const std::vector<std::string>& patterns, const std::vector<string_type>& texts)
+{
+    std::vector<string_type> converted;
+    for(const auto& p: patterns){
+        converted.push_back(cast_string<string_type>(p));
+    }
+    RegexSet re_set(converted);
+    for(const auto& text: texts){
+        INFO("text=" << cast_string<std::string>(text));
+        CHECK(re_set.match(text) == regex_set_match_one_by_one(patterns, text));
+    }
+}
+
+static std::vector<string_type> regex_set_texts(const std::vector<std::string>& strings)
+{
+    std::vector<string_type> texts;
+    for(const auto& s: strings){
+        texts.push_back(cast_string<string_type>(s));
+    }
+    return texts;
+}
+
+TEST_CASE( "match patterns in the order of priority", "[regression]" ) {
+    init_locale();
+
+    test_regex_set({"a.*", ".*b", "ab", "(c|d)+e?", "x{2,3}", "y{2}", "z{2,}", "(?:ab|cd)*?", "[^a-c]x", "[a-c-]+", "\\.\\*\\?", "^q$", "()+r"},
+            regex_set_texts({"", "a", "ab", "b", "cb", "cde", "ccdd", "ce", "e", "xx", "xxx", "xxxx", "yy", "yyy", "z", "zz", "zzzz",
+                "abcd", "abab", "abc", "dx", "ax", "-", "a-c", ".*?", "..", "q", "r", "rr", "\n", "a\n", "\nb", "a\r"}));
+    test_regex_set({}, regex_set_texts({"", "a"}));
+    test_regex_set({"", "a|", "|b"}, regex_set_texts({"", "a", "b", "ab"}));
+}
+
+TEST_CASE( "reject syntax not supported by regex set", "[regression]" ) {
+    init_locale();
+
+    CHECK_THROWS_AS(RegexSet({cast_string<string_type>(std::string("(a)\\1"))}), std::invalid_argument&);
+    CHECK_THROWS_AS(RegexSet({cast_string<string_type>(std::string("\\d+"))}), std::invalid_argument&);
+    CHECK_THROWS_AS(RegexSet({cast_string<string_type>(std::string("a(?=b)"))}), std::invalid_argument&);
+    CHECK_THROWS_AS(RegexSet({cast_string<string_type>(std::string("[[:alpha:]]"))}), std::invalid_argument&);
+    CHECK_THROWS_AS(RegexSet({cast_string<string_type>(std::string("a^b"))}), std::invalid_argument&);
+    CHECK_THROWS_AS(RegexSet({cast_string<string_type>(std::string("(ab"))}), std::invalid_argument&);
+    CHECK_THROWS_AS(RegexSet({cast_string<string_type>(std::string("a**"))}), std::invalid_argument&);
+    // too many states are rejected before allocating them
+    CHECK_THROWS_AS(RegexSet({cast_string<string_type>(std::string("((a{1000}){1000}){1000}"))}), std::invalid_argument&);
+}
+
+TEST_CASE( "fall back to std::regex for unsupported patterns", "[regression]" ) {
+    init_locale();
+
+    RegexFeatureExtractor extract({{1.0, "\\d+"}, {0.5, "a.*"}});
+    CHECK(extract(cast_string<string_type>(std::string("12"))) == Approx(1.0));
+    CHECK(extract(cast_string<string_type>(std::string("ab"))) == Approx(0.5));
+    CHECK(extract(cast_string<string_type>(std::string("b"))) == Approx(0.0));
+}
+
+TEST_CASE( "match example patterns in the same way as std::regex", "[regression]" ) {
+    init_locale();
+
+    const std::vector<std::string> names = {"is_firstperson", "is_future", "is_imperative", "is_negative", "is_past",
+        "is_question", "is_secondperson", "is_thirdperson", "sentiment"};
+    std::mt19937 gen(0);
+    for(const auto& name: names){
+        std::ifstream ifs("../example/regression/patterns/" + name + ".tsv");
+        REQUIRE(ifs.good());
+        std::vector<std::string> patterns;
+        std::string line;
+        while(std::getline(ifs, line) && !line.empty()){
+            patterns.push_back(line.substr(line.find('\t') + 1));
+        }
+
+        // texts made of letters in patterns
+        std::set<string_type::value_type> letters;
+        for(const auto& p: patterns){
+            for(auto c: cast_string<string_type>(p)){
+                letters.insert(c);
+            }
+        }
+        std::vector<string_type::value_type> alphabet(std::begin(letters), std::end(letters));
+        std::vector<string_type> texts;
+        for(size_t i = 0; i < 300; ++i){
+            string_type text;
+            for(size_t n = gen() % 12; n > 0; --n){
+                text.push_back(alphabet[gen() % alphabet.size()]);
+            }
+            texts.push_back(text);
+        }
+
+        // texts in corpus and texts concatenated from literals in patterns
+        std::ifstream corpus("../example/corpus/apple.tsv");
+        while(std::getline(corpus, line)){
+            auto columns = split(line, '\t');
+            if(columns.size() > 1){
+                texts.push_back(cast_string<string_type>(columns[1]));
+            }
+        }
+        for(const auto& p: patterns){
+            auto t = cast_string<string_type>(p);
+            string_type text;
+            for(auto c: t){
+                if(std::string("()[]|*+?.^\\-").find(static_cast<char>(c)) == std::string::npos || c > 0x7f){
+                    text.push_back(c);
+                }
+            }
+            texts.push_back(text);
+            texts.push_back(text.substr(text.size() / 2));
+        }
+
+        INFO("patterns=" << name);
+        test_regex_set(patterns, texts);
+    }
+}
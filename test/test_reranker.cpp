@@ -0,0 +1,215 @@
+/*
+Resembla: Word-based Japanese similar sentence search library
+https://github.com/tuem/resembla
+
+Copyright 2017 Takashi Uemura
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <iostream>
+#include <limits>
+
+#include "Catch/catch.hpp"
+
+#include "string_util.hpp"
+
+#include "thread_pool.hpp"
+#include "reranker.hpp"
+#include "measure/edit_distance.hpp"
+#include "measure/weighted_edit_distance.hpp"
+
+using namespace resembla;
+
+std::vector<std::pair<std::wstring, std::wstring>> make_reranker_candidates(size_t n)
+{
+    std::vector<std::pair<std::wstring, std::wstring>> candidates;
+    std::wstring letters = L"あいうえおかきくけこ";
+    for(size_t i = 0; i < n; ++i){
+        std::wstring text;
+        for(size_t j = i; text.size() < 2 + i % 7; j = j * 7 + 3){
+            text += letters[j % letters.size()];
+        }
+        candidates.push_back(std::make_pair(text, text));
+    }
+    return candidates;
+}
+
+void test_reranker_parallel(const std::wstring& query, size_t n, double threshold, size_t max_output, size_t chunk_size)
+{
+    init_locale();
+    auto candidates = make_reranker_candidates(n);
+    auto target = std::make_pair(query, query);
+    EditDistance<> score_func;
+
+    auto pool = std::make_shared<ThreadPool>(4);
+    Reranker<std::wstring> serial;
+    Reranker<std::wstring> parallel(pool, 1, chunk_size);
+    auto expected = serial.rerank(target, std::begin(candidates), std::end(candidates), score_func, threshold, max_output);
+    auto actual = parallel.rerank(target, std::begin(candidates), std::end(candidates), score_func, threshold, max_output);
+    CHECK(actual == expected);
+}
+
+TEST_CASE( "reranker: parallel reranking returns the same results as serial reranking", "[language]" ) {
+    test_reranker_parallel(L"あいう", 0, 0.0, 0, 0);
+    test_reranker_parallel(L"あいう", 1000, 0.0, 0, 0);
+    test_reranker_parallel(L"あいう", 1000, 0.0, 10, 0);
+    test_reranker_parallel(L"あいう", 1000, 0.3, 10, 0);
+    test_reranker_parallel(L"かきくけこ", 1000, 0.5, 0, 7);
+    test_reranker_parallel(L"かきくけこ", 1000, 0.0, 1, 1);
+    test_reranker_parallel(L"おかき", 3, 0.0, 10, 0);
+}
+
+struct WeightedLetter
+{
+    wchar_t token;
+    double weight;
+};
+
+std::vector<WeightedLetter> make_weighted_letters(const std::wstring& text)
+{
+    std::vector<WeightedLetter> letters;
+    for(auto c: text){
+        letters.push_back({c, 1.0 + (c % 3) * 0.5});
+    }
+    return letters;
+}
+
+// scores with floor are the same as without floor if not below it, otherwise an upper bound below the floor
+template<typename Distance, typename Sequence>
+void test_edit_distance_floor(const Distance& distance, const std::vector<Sequence>& sequences)
+{
+    size_t num_stopped = 0;
+    for(const auto& a: sequences){
+        for(const auto& b: sequences){
+            double exact = distance(a, b);
+            for(double floor: {-std::numeric_limits<double>::infinity(), 0.0, 0.2, 0.5, 0.8, 1.0, exact}){
+                double bounded = distance(a, b, floor);
+                if(exact >= floor){
+                    CHECK(bounded == exact);
+                }
+                else{
+                    CHECK(bounded < floor);
+                    CHECK(bounded >= exact);
+                    if(bounded != exact){
+                        ++num_stopped;
+                    }
+                }
+            }
+        }
+    }
+    // some computations must actually stop early
+    CHECK(num_stopped > 0);
+}
+
+TEST_CASE( "edit distance: computation stops below floor", "[language]" ) {
+    std::vector<std::wstring> texts = {L"あ", L"あいう", L"あいうえおかきくけこ", L"こけくきかおえういあ"};
+    for(const auto& c: make_reranker_candidates(30)){
+        texts.push_back(c.first);
+    }
+    test_edit_distance_floor(EditDistance<>(), texts);
+
+    std::vector<std::vector<WeightedLetter>> weighted;
+    for(const auto& t: texts){
+        weighted.push_back(make_weighted_letters(t));
+    }
+    test_edit_distance_floor(WeightedEditDistance<>(), weighted);
+}
+
+// results with max_output are the first max_output results of all candidates
+void test_reranker_top_k(const Reranker<std::wstring>& reranker, const std::wstring& query, double threshold)
+{
+    init_locale();
+    auto candidates = make_reranker_candidates(200);
+    // duplicated texts have the same scores
+    auto duplicated = make_reranker_candidates(50);
+    candidates.insert(std::end(candidates), std::begin(duplicated), std::end(duplicated));
+    auto target = std::make_pair(query, query);
+    EditDistance<> score_func;
+
+    auto all = reranker.rerank(target, std::begin(candidates), std::end(candidates), score_func, threshold, 0);
+    for(size_t k: {1, 2, 5, 10, 50, 1000}){
+        auto top_k = reranker.rerank(target, std::begin(candidates), std::end(candidates), score_func, threshold, k);
+        auto correct = all;
+        if(correct.size() > k){
+            correct.resize(k);
+        }
+        CHECK(top_k == correct);
+    }
+}
+
+TEST_CASE( "reranker: bounded top-k is the same as sorting all candidates", "[language]" ) {
+    Reranker<std::wstring> serial;
+    Reranker<std::wstring> parallel(std::make_shared<ThreadPool>(4), 1, 16);
+    for(const auto& query: {L"あいう", L"かきくけこ", L"あ"}){
+        test_reranker_top_k(serial, query, 0.0);
+        test_reranker_top_k(serial, query, 0.3);
+        test_reranker_top_k(parallel, query, 0.0);
+        test_reranker_top_k(parallel, query, 0.3);
+    }
+}
+
+// scores candidates only in batches
+struct BatchEditDistance
+{
+    EditDistance<> score_func;
+
+    std::vector<double> operator()(const std::wstring& target, const std::vector<const std::wstring*>& references) const
+    {
+        std::vector<double> scores;
+        for(const auto r: references){
+            scores.push_back(score_func(target, *r));
+        }
+        return scores;
+    }
+};
+
+void test_reranker_batch(const std::wstring& query, size_t n, double threshold, size_t max_output)
+{
+    init_locale();
+    auto candidates = make_reranker_candidates(n);
+    auto target = std::make_pair(query, query);
+    EditDistance<> score_func;
+    BatchEditDistance batch_score_func;
+
+    auto pool = std::make_shared<ThreadPool>(4);
+    Reranker<std::wstring> serial;
+    Reranker<std::wstring> parallel(pool, 1, 0);
+    auto expected = serial.rerank(target, std::begin(candidates), std::end(candidates), score_func, threshold, max_output);
+    CHECK(serial.rerank(target, std::begin(candidates), std::end(candidates), batch_score_func, threshold, max_output) == expected);
+    CHECK(parallel.rerank(target, std::begin(candidates), std::end(candidates), batch_score_func, threshold, max_output) == expected);
+    CHECK(parallel.score(target, std::begin(candidates), std::end(candidates), batch_score_func) ==
+            serial.score(target, std::begin(candidates), std::end(candidates), score_func));
+}
+
+TEST_CASE( "reranker: batch score functions return the same results as score functions for each candidate", "[language]" ) {
+    test_reranker_batch(L"あいう", 0, 0.0, 0);
+    test_reranker_batch(L"あいう", 1000, 0.0, 0);
+    test_reranker_batch(L"あいう", 1000, 0.3, 10);
+    test_reranker_batch(L"かきくけこ", 1000, 0.0, 1);
+}
+
+TEST_CASE( "thread pool: nested parallel_for", "[language]" ) {
+    ThreadPool pool(3);
+    std::atomic<int> count(0);
+    pool.parallel_for(20, [&](size_t){
+        pool.parallel_for(20, [&](size_t){
+            ++count;
+        });
+    });
+    CHECK(count == 400);
+}
@@ -0,0 +1,223 @@
+/*
+Resembla: Word-based Japanese similar sentence search library
+https://github.com/tuem/resembla
+
+Copyright 2017 Takashi Uemura
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <future>
+#include <atomic>
+#include <stdexcept>
+#include <chrono>
+#include <iostream>
+#include <cmath>
+
+#include "Catch/catch.hpp"
+
+#include "string_util.hpp"
+
+#include "resembla_ensemble.hpp"
+
+using namespace resembla;
+
+// returns fixed responses after sleeping for given milliseconds
+class FixedResembla: public ResemblaInterface
+{
+public:
+    FixedResembla(const std::vector<output_type>& responses, size_t delay = 0):
+        responses(responses), delay(delay)
+    {}
+
+    std::vector<output_type> find(const string_type&, double = 0.0, size_t = 0) const
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(delay));
+        return responses;
+    }
+
+    std::vector<output_type> eval(const string_type& query, const std::vector<string_type>&,
+            double threshold = 0.0, size_t max_response = 0) const
+    {
+        return find(query, threshold, max_response);
+    }
+
+protected:
+    const std::vector<output_type> responses;
+    const size_t delay;
+};
+
+// counts calls of find
+class CountingResembla: public FixedResembla
+{
+public:
+    CountingResembla(const std::vector<output_type>& responses): FixedResembla(responses), calls(0) {}
+
+    std::vector<output_type> find(const string_type& input, double threshold = 0.0, size_t max_response = 0) const
+    {
+        ++calls;
+        return FixedResembla::find(input, threshold, max_response);
+    }
+
+    mutable std::atomic<size_t> calls;
+};
+
+void test_resembla_ensemble_fanout(std::shared_ptr<ThreadPool> pool, size_t timeout, size_t slow_delay,
+        const std::vector<ResemblaInterface::output_type>& correct, bool share_candidates = false)
+{
+    init_locale();
+    ResemblaEnsemble ensemble("ensemble", 0, pool, timeout, share_candidates);
+    ensemble.append(std::make_shared<FixedResembla>(std::vector<ResemblaInterface::output_type>{
+            {RESEMBLA_TEXT("あい"), "a", 0.8}, {RESEMBLA_TEXT("あう"), "a", 0.6}}), 1.0);
+    ensemble.append(std::make_shared<FixedResembla>(std::vector<ResemblaInterface::output_type>{
+            {RESEMBLA_TEXT("あい"), "b", 0.4}, {RESEMBLA_TEXT("いう"), "b", 1.0}}, slow_delay), 3.0, false);
+
+    auto result = ensemble.find(RESEMBLA_TEXT("あい"));
+    REQUIRE(result.size() == correct.size());
+    for(size_t i = 0; i < result.size(); ++i){
+        CHECK(cast_string<std::string>(result[i].text) == cast_string<std::string>(correct[i].text));
+        CHECK(result[i].measure == "ensemble");
+        CHECK(result[i].score == Approx(correct[i].score));
+    }
+}
+
+TEST_CASE( "resembla ensemble: concurrent child measures", "[language]" ) {
+    std::vector<ResemblaInterface::output_type> all = {
+        {RESEMBLA_TEXT("いう"), "", std::sqrt(3.0 / 4.0)},
+        {RESEMBLA_TEXT("あい"), "", std::sqrt((0.64 + 3 * 0.16) / 4.0)},
+        {RESEMBLA_TEXT("あう"), "", std::sqrt(0.36 / 4.0)}};
+    test_resembla_ensemble_fanout(nullptr, 0, 0, all);
+    test_resembla_ensemble_fanout(std::make_shared<ThreadPool>(2), 0, 0, all);
+    test_resembla_ensemble_fanout(std::make_shared<ThreadPool>(2), 0, 50, all);
+}
+
+TEST_CASE( "resembla ensemble: slow child measures are dropped", "[language]" ) {
+    // weights are renormalized to the first measure only
+    std::vector<ResemblaInterface::output_type> fast_only = {
+        {RESEMBLA_TEXT("あい"), "", 0.8},
+        {RESEMBLA_TEXT("あう"), "", 0.6}};
+    test_resembla_ensemble_fanout(std::make_shared<ThreadPool>(2), 20, 500, fast_only);
+}
+
+TEST_CASE( "resembla ensemble: children not started before timeout are skipped", "[language]" ) {
+    init_locale();
+    // the only worker is busy until the deadline has passed
+    auto pool = std::make_shared<ThreadPool>(1);
+    std::promise<void> blocked;
+    pool->submit([&blocked](){
+        blocked.set_value();
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    });
+    blocked.get_future().wait();
+    ResemblaEnsemble ensemble("ensemble", 0, pool, 20);
+    ensemble.append(std::make_shared<FixedResembla>(std::vector<ResemblaInterface::output_type>{
+            {RESEMBLA_TEXT("あい"), "a", 0.8}}), 1.0);
+    auto expired = std::make_shared<CountingResembla>(std::vector<ResemblaInterface::output_type>{
+            {RESEMBLA_TEXT("いう"), "b", 1.0}});
+    ensemble.append(expired, 3.0);
+
+    auto result = ensemble.find(RESEMBLA_TEXT("あい"));
+    REQUIRE(result.size() == 1);
+    CHECK(result[0].score == Approx(0.8));
+
+    // wait until the worker has processed all tasks submitted before
+    std::promise<void> drained;
+    pool->submit([&drained](){
+        drained.set_value();
+    });
+    drained.get_future().wait();
+    CHECK(expired->calls == 0);
+}
+
+TEST_CASE( "resembla ensemble: shared candidates", "[language]" ) {
+    // only candidates of the first measure are scored by both measures
+    std::vector<ResemblaInterface::output_type> shared = {
+        {RESEMBLA_TEXT("あい"), "", std::sqrt((0.64 + 3 * 0.16) / 4.0)},
+        {RESEMBLA_TEXT("あう"), "", std::sqrt(0.36 / 4.0)}};
+    test_resembla_ensemble_fanout(nullptr, 0, 0, shared, true);
+    test_resembla_ensemble_fanout(std::make_shared<ThreadPool>(2), 0, 10, shared, true);
+}
+
+TEST_CASE( "resembla ensemble: batch", "[language]" ) {
+    init_locale();
+    ResemblaEnsemble ensemble("ensemble", 0, std::make_shared<ThreadPool>(2), 0, false, std::make_shared<ThreadPool>(2));
+    ensemble.append(std::make_shared<FixedResembla>(std::vector<ResemblaInterface::output_type>{
+            {RESEMBLA_TEXT("あい"), "a", 0.8}, {RESEMBLA_TEXT("あう"), "a", 0.6}}), 1.0);
+    ensemble.append(std::make_shared<FixedResembla>(std::vector<ResemblaInterface::output_type>{
+            {RESEMBLA_TEXT("あい"), "b", 0.4}, {RESEMBLA_TEXT("いう"), "b", 1.0}}), 3.0);
+
+    std::vector<string_type> queries = {RESEMBLA_TEXT("あいう"), RESEMBLA_TEXT("あ"), RESEMBLA_TEXT(""), RESEMBLA_TEXT("あい")};
+    auto results = ensemble.find_batch(queries);
+    REQUIRE(results.size() == queries.size());
+    for(size_t i = 0; i < queries.size(); ++i){
+        auto correct = ensemble.find(queries[i]);
+        REQUIRE(results[i].size() == correct.size());
+        for(size_t j = 0; j < correct.size(); ++j){
+            CHECK(results[i][j].text == correct[j].text);
+            CHECK(results[i][j].score == Approx(correct[j].score));
+        }
+    }
+
+    // queries are processed one by one without batch_pool
+    ResemblaEnsemble unbatched("ensemble", 0, std::make_shared<ThreadPool>(2));
+    unbatched.append(std::make_shared<FixedResembla>(std::vector<ResemblaInterface::output_type>{
+            {RESEMBLA_TEXT("あい"), "a", 0.8}}), 1.0);
+    CHECK(unbatched.find_batch(queries).size() == queries.size());
+
+    auto pool = std::make_shared<ThreadPool>(2);
+    CHECK_THROWS_AS(ResemblaEnsemble("ensemble", 0, pool, 0, false, pool), std::invalid_argument&);
+}
+
+TEST_CASE( "resembla ensemble: batch with timeout", "[language]" ) {
+    init_locale();
+    // more queries than threads. children of queries in batch must not wait for workers busy with other queries
+    std::vector<std::shared_ptr<ResemblaInterface>> children = {
+        std::make_shared<FixedResembla>(std::vector<ResemblaInterface::output_type>{
+                {RESEMBLA_TEXT("あい"), "a", 0.8}, {RESEMBLA_TEXT("あう"), "a", 0.6}}),
+        std::make_shared<FixedResembla>(std::vector<ResemblaInterface::output_type>{
+                {RESEMBLA_TEXT("あい"), "b", 0.4}, {RESEMBLA_TEXT("いう"), "b", 1.0}}, 5),
+        std::make_shared<FixedResembla>(std::vector<ResemblaInterface::output_type>{
+                {RESEMBLA_TEXT("いう"), "c", 0.2}, {RESEMBLA_TEXT("ええ"), "c", 0.9}}, 5)};
+    ResemblaEnsemble ensemble("ensemble", 0, std::make_shared<ThreadPool>(2), 1000, false, std::make_shared<ThreadPool>(2));
+    ResemblaEnsemble serial("ensemble");
+    for(size_t i = 0; i < children.size(); ++i){
+        ensemble.append(children[i], i + 1.0);
+        serial.append(children[i], i + 1.0);
+    }
+
+    std::vector<string_type> queries;
+    std::vector<std::vector<string_type>> targets;
+    for(size_t i = 0; i < 12; ++i){
+        queries.push_back(string_type(i, RESEMBLA_TEXT('あ')));
+        targets.push_back({RESEMBLA_TEXT("あい")});
+    }
+    auto found = ensemble.find_batch(queries);
+    auto evaluated = ensemble.eval_batch(queries, targets);
+    REQUIRE(found.size() == queries.size());
+    REQUIRE(evaluated.size() == queries.size());
+    for(size_t i = 0; i < queries.size(); ++i){
+        auto correct = serial.find(queries[i]);
+        REQUIRE(found[i].size() == correct.size());
+        REQUIRE(evaluated[i].size() == correct.size());
+        for(size_t j = 0; j < correct.size(); ++j){
+            CHECK(found[i][j].text == correct[j].text);
+            CHECK(found[i][j].score == Approx(correct[j].score));
+            CHECK(evaluated[i][j].text == correct[j].text);
+            CHECK(evaluated[i][j].score == Approx(correct[j].score));
+        }
+    }
+}
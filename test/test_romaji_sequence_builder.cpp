@@ -36,13 +36,20 @@ void test_romaji_sequence_builder_build_indexing_text(const std::string& input,
 {
     init_locale();
     RomajiSequenceBuilder preprocess(ROMAJI_SEQUENCE_PARSER_MECAB_OPTIONS, ROMAJI_SEQUENCE_PARSER_MECAB_FUTURE_POS, ROMAJI_SEQUENCE_PARSER_MECAB_ROMAJI_OF_MARKS, true);
-    std::wstring winput = cast_string<std::wstring>(input);
+    string_type winput = cast_string<string_type>(input);
     std::string answer = cast_string<std::string>(preprocess.index(winput));
 #ifdef DEBUG
     std::cerr << "input text: " << input <<  std::endl;
     std::cerr << "parsed text: " << answer <<  std::endl;
 #endif
     CHECK(answer == correct);
+
+    // results shared in an analysis context are the same
+    {
+        AnalysisContext::Scope scope(winput);
+        CHECK(cast_string<std::string>(preprocess.index(winput)) == correct);
+        CHECK(cast_string<std::string>(preprocess.index(winput)) == correct);
+    }
 }
 
 TEST_CASE( "romaji: empty", "[language]" ) {
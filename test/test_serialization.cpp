@@ -19,11 +19,14 @@ limitations under the License.
 
 #include <string>
 #include <iostream>
+#include <sstream>
+#include <stdexcept>
 
 #include <Catch/catch.hpp>
 #include <json.hpp>
 
 #include "string_util.hpp"
+#include "analysis_context.hpp"
 
 #include "measure/asis_sequence_builder.hpp"
 #include "measure/word_sequence_builder.hpp"
@@ -36,7 +39,7 @@ using json = nlohmann::json;
 TEST_CASE( "serialize and deserialize output data of asis sequence builder", "[serialization]" ) {
     init_locale();
 
-    AsIsSequenceBuilder<string_type>::output_type o0 = L"テキスト!";
+    AsIsSequenceBuilder<string_type>::output_type o0 = RESEMBLA_TEXT("テキスト!");
 
     json j0 = o0;
     const std::string s = j0.dump();
@@ -50,7 +53,7 @@ TEST_CASE( "serialize and deserialize output data of asis sequence builder", "[s
 TEST_CASE( "serialize and deserialize output data of keyword match preprocessor", "[serialization]" ) {
     init_locale();
 
-    KeywordMatchPreprocessor<string_type>::output_type o0 = {L"テキスト!", {L"キーワード0", L"キーワード1"}};
+    KeywordMatchPreprocessor<string_type>::output_type o0 = {RESEMBLA_TEXT("テキスト!"), {RESEMBLA_TEXT("キーワード0"), RESEMBLA_TEXT("キーワード1")}};
 
     json j0 = o0;
     const std::string s = j0.dump();
@@ -65,26 +68,35 @@ TEST_CASE( "serialize and deserialize output data of keyword match preprocessor"
 TEST_CASE( "serialize and deserialize output data of weighted word sequence builder", "[serialization]" ) {
     init_locale();
 
-    WeightedSequenceBuilder<WordSequenceBuilder, WordWeight>::output_type o0 = {{{L"単語0", {L"素性00", L"素性01"}}, 0.3}, {{L"単語1", {L"素性10", L"素性11"}}, 0.7}};
+    WeightedSequenceBuilder<WordSequenceBuilder, WordWeight>::output_type o0 = {
+        {{RESEMBLA_TEXT("単語0"), {RESEMBLA_TEXT("名詞"), RESEMBLA_TEXT("代名詞"), RESEMBLA_TEXT("*"), RESEMBLA_TEXT("*"), RESEMBLA_TEXT("*"), RESEMBLA_TEXT("*"), RESEMBLA_TEXT("単語"), RESEMBLA_TEXT("タンゴ")}}, 0.3},
+        {{RESEMBLA_TEXT("単語1"), {RESEMBLA_TEXT("動詞"), RESEMBLA_TEXT("自立"), RESEMBLA_TEXT("*"), RESEMBLA_TEXT("*"), RESEMBLA_TEXT("*"), RESEMBLA_TEXT("*"), RESEMBLA_TEXT("*"), RESEMBLA_TEXT("*")}}, 0.7}
+    };
 
     json j0 = o0;
     const std::string s = j0.dump();
-    CHECK(s == "[{\"t\":{\"f\":[\"素性00\",\"素性01\"],\"s\":\"単語0\"},\"w\":0.3},{\"t\":{\"f\":[\"素性10\",\"素性11\"],\"s\":\"単語1\"},\"w\":0.7}]");
+    CHECK(s == "[{\"t\":{\"b\":\"単語\",\"c\":4,\"p\":1,\"r\":\"タンゴ\",\"s\":\"単語0\"},\"w\":0.3},{\"t\":{\"b\":\"\",\"c\":0,\"p\":2,\"r\":\"\",\"s\":\"単語1\"},\"w\":0.7}]");
 
     json j1 = json::parse(s);
     WeightedSequenceBuilder<WordSequenceBuilder, WordWeight>::output_type o1 = j1;
     REQUIRE(o1.size() == o0.size());
     for(size_t i = 0; i < o1.size(); ++i){
         CHECK(o1[i].token.surface == o0[i].token.surface);
-        CHECK(o1[i].token.feature == o0[i].token.feature);
+        CHECK(o1[i].token == o0[i].token);
         CHECK(o1[i].weight == o0[i].weight);
     }
+
+    // older format keeping all features
+    json j2 = json::parse("[{\"t\":{\"f\":[\"名詞\",\"代名詞\",\"*\",\"*\",\"*\",\"*\",\"単語\",\"タンゴ\"],\"s\":\"単語0\"},\"w\":0.3}]");
+    WeightedSequenceBuilder<WordSequenceBuilder, WordWeight>::output_type o2 = j2;
+    REQUIRE(o2.size() == 1);
+    CHECK(o2[0].token == o0[0].token);
 }
 
 TEST_CASE( "serialize and deserialize output data of weighted romaji sequence builder", "[serialization]" ) {
     init_locale();
 
-    WeightedSequenceBuilder<RomajiSequenceBuilder, RomajiWeight>::output_type o0 = {{L'T', 0.3}, {L'e', 0.7}};
+    WeightedSequenceBuilder<RomajiSequenceBuilder, RomajiWeight>::output_type o0 = {{RESEMBLA_TEXT('T'), 0.3}, {RESEMBLA_TEXT('e'), 0.7}};
 
     json j0 = o0;
     const std::string s = j0.dump();
@@ -98,3 +110,77 @@ TEST_CASE( "serialize and deserialize output data of weighted romaji sequence bu
         CHECK(o1[i].weight == o0[i].weight);
     }
 }
+
+TEST_CASE( "save and load results of morphological analysis", "[serialization]" ) {
+    init_locale();
+
+    int analyzer0 = 0, analyzer1 = 1;
+    const string_type text = RESEMBLA_TEXT("今日は晴れ");
+    const AnalysisContext::morphemes_type morphemes = {
+        {RESEMBLA_TEXT("今日"), "名詞,普通名詞,副詞可能,*,*,*,キョウ,今日,今日,キョー"},
+        {RESEMBLA_TEXT("は"), "助詞,係助詞,*,*,*,*,ハ,は,は,ワ"},
+        {RESEMBLA_TEXT("晴れ"), ""}
+    };
+
+    AnalysisContext context0;
+    context0.get(&analyzer0, text, [&](){ return morphemes; });
+    std::stringstream ss;
+    context0.save(&analyzer0, ss);
+
+    AnalysisContext context1;
+    context1.load(&analyzer1, ss);
+    auto loaded = context1.get(&analyzer1, text, [](){ return AnalysisContext::morphemes_type(); });
+    REQUIRE(loaded->size() == morphemes.size());
+    for(size_t i = 0; i < morphemes.size(); ++i){
+        CHECK((*loaded)[i].surface == morphemes[i].surface);
+        CHECK((*loaded)[i].feature == morphemes[i].feature);
+    }
+
+    std::stringstream truncated(ss.str().substr(0, ss.str().size() - 1));
+    CHECK_THROWS(context1.load(&analyzer1, truncated));
+
+    // corrupt lengths of a text and morphemes are reported as truncated results
+    const auto saved = ss.str();
+    const size_t text_length_pos = 16;
+    const size_t num_morphemes_pos = text_length_pos + 8 + cast_string<std::string>(text).size();
+    for(auto pos: {text_length_pos, num_morphemes_pos}){
+        auto corrupt = saved;
+        for(size_t i = 0; i < 8; ++i){
+            corrupt[pos + i] = static_cast<char>(0xff);
+        }
+        std::stringstream corrupt_ss(corrupt);
+        CHECK_THROWS_AS(context1.load(&analyzer1, corrupt_ss), const std::runtime_error&);
+    }
+}
+
+TEST_CASE( "keep results of query only in request context", "[serialization]" ) {
+    init_locale();
+
+    int analyzer = 0;
+    const string_type query = RESEMBLA_TEXT("今日は晴れ");
+    const string_type candidate = RESEMBLA_TEXT("明日は雨");
+    size_t analyzed = 0;
+    auto analyze = [&](){
+        ++analyzed;
+        return AnalysisContext::morphemes_type();
+    };
+
+    AnalysisContext context(query);
+    auto q0 = context.get(&analyzer, query, analyze);
+    auto q1 = context.get(&analyzer, query, analyze);
+    CHECK(q0 == q1);
+    CHECK(analyzed == 1);
+
+    context.get(&analyzer, candidate, analyze);
+    context.get(&analyzer, candidate, analyze);
+    CHECK(analyzed == 3);
+
+    std::stringstream ss;
+    context.save(&analyzer, ss);
+    AnalysisContext loaded;
+    loaded.load(&analyzer, ss);
+    loaded.get(&analyzer, query, analyze);
+    CHECK(analyzed == 3);
+    loaded.get(&analyzer, candidate, analyze);
+    CHECK(analyzed == 4);
+}
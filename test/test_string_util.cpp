@@ -20,6 +20,8 @@ limitations under the License.
 #include <string>
 #include <iostream>
 
+#include <unicode/unistr.h>
+
 #include "Catch/catch.hpp"
 
 #include "string_util.hpp"
@@ -89,3 +91,43 @@ TEST_CASE( "wstring to string", "[language]" ) {
     test_cast_string_wstring_string(L"漢字", "漢字");
     test_cast_string_wstring_string(L"このﾃｽﾄはcast_stringを実行します。", "このﾃｽﾄはcast_stringを実行します。");
 }
+
+TEST_CASE( "convert UTF-8 regardless of locale", "[language]" ) {
+    setlocale(LC_ALL, "C");
+    CHECK(cast_string<std::wstring>(std::string("漢字とｶﾅ")) == L"漢字とｶﾅ");
+    CHECK(cast_string<std::string>(std::wstring(L"漢字とｶﾅ")) == "漢字とｶﾅ");
+    init_locale();
+
+    // characters out of BMP, long ASCII runs and null characters
+    test_cast_string_string_wstring("𠮷野家", L"𠮷野家");
+    test_cast_string_wstring_string(L"𠮷野家", "𠮷野家");
+    test_cast_string_string_wstring("abcdefghijklmnopqrstuvwxyzテスト0123456789", L"abcdefghijklmnopqrstuvwxyzテスト0123456789");
+    test_cast_string_string_wstring(std::string("a\0b", 3), std::wstring(L"a\0b", 3));
+    test_cast_string_wstring_string(std::wstring(L"a\0b", 3), std::string("a\0b", 3));
+
+    // invalid sequences are replaced with U+FFFD
+    test_cast_string_string_wstring("a\xFF" "b", L"a�b");
+    test_cast_string_string_wstring("\xE3\x83", L"��");
+    test_cast_string_string_wstring("\xC0\xAF", L"��");
+    test_cast_string_string_wstring("\xED\xA0\x80", L"���");
+}
+
+TEST_CASE( "convert between wstring and UnicodeString", "[language]" ) {
+    init_locale();
+    for(const std::wstring& text: {std::wstring(), std::wstring(L"ABC123"), std::wstring(L"ｱﾎﾞｶﾄﾞ"), std::wstring(L"𠮷野家のテスト")}){
+        auto u = cast_string<UnicodeString>(text);
+        CHECK(cast_string<std::string>(u) == cast_string<std::string>(text));
+        CHECK(cast_string<std::wstring>(u) == text);
+    }
+}
+
+TEST_CASE( "convert UTF-32 strings", "[language]" ) {
+    init_locale();
+    for(const std::string& text: {std::string(), std::string("ABC123"), std::string("ｱﾎﾞｶﾄﾞ"), std::string("𠮷野家のテスト")}){
+        auto u32 = cast_string<std::u32string>(text);
+        CHECK(cast_string<std::string>(u32) == text);
+        CHECK(cast_string<std::u32string>(cast_string<std::wstring>(u32)) == u32);
+        CHECK(cast_string<std::u32string>(cast_string<UnicodeString>(u32)) == u32);
+    }
+    CHECK(cast_string<std::u32string>(std::string("𠮷")) == U"𠮷");
+}
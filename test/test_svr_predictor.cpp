@@ -0,0 +1,171 @@
+/*
+Resembla: Word-based Japanese similar sentence search library
+https://github.com/tuem/resembla
+
+Copyright 2017 Takashi Uemura
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <cstdio>
+#include <cmath>
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+
+#include <Catch/catch.hpp>
+#include <libsvm/svm.h>
+
+#include "regression/feature.hpp"
+#include "regression/predictor/svr_model.hpp"
+#include "regression/predictor/approximate_svr_model.hpp"
+#include "regression/predictor/svr_predictor.hpp"
+
+using namespace resembla;
+
+static const std::string SV_LINES =
+    "SV\n"
+    "0.8 0:0.5 1:1 3:-0.2 \n"
+    "-1 1:0.3 2:0.7 \n"
+    "0.25 0:1 3:0.4 \n"
+    "-0.05 2:-1.5 \n";
+
+static const std::vector<std::vector<double>> SVR_INPUTS = {
+    {0.0, 0.0, 0.0, 0.0, 0.0},
+    {0.5, 1.0, 0.0, -0.2, 0.0},
+    {0.1, 0.2, 0.3, 0.4, 0.5},
+    {-1.0, 0.7, 2.5, 0.0, -0.3},
+    {0.9, 0.0, -0.4}
+};
+
+static std::string writeSVRModel(const std::string& kernel_type, const std::string& params)
+{
+    const std::string path = "test_svr_model_" + kernel_type + ".tmp";
+    std::ofstream ofs(path);
+    ofs << "svm_type epsilon_svr\n"
+        << "kernel_type " << kernel_type << "\n"
+        << params
+        << "nr_class 2\n"
+        << "total_sv 4\n"
+        << "rho -0.125\n"
+        << SV_LINES;
+    return path;
+}
+
+static double predictByLibsvm(const std::string& path, const std::vector<double>& x)
+{
+    std::vector<svm_node> nodes;
+    for(size_t j = 0; j < x.size(); ++j){
+        if(x[j] != 0.0){
+            svm_node node;
+            node.index = static_cast<int>(j);
+            node.value = x[j];
+            nodes.push_back(node);
+        }
+    }
+    svm_node end;
+    end.index = -1;
+    end.value = 0.0;
+    nodes.push_back(end);
+
+    svm_model* model = svm_load_model(path.c_str());
+    double s = svm_predict(model, &nodes[0]);
+    svm_free_and_destroy_model(&model);
+    return s;
+}
+
+static void checkSVRModel(const std::string& kernel_type, const std::string& params, SVRModel::KernelType expected_type)
+{
+    const auto path = writeSVRModel(kernel_type, params);
+    SVRModel model(path);
+    CHECK(model.kernelType() == expected_type);
+    CHECK(model.size() == 4);
+    CHECK(model.dimension() == 4);
+    for(const auto& x: SVR_INPUTS){
+        CHECK(std::abs(model.predict(x) - predictByLibsvm(path, x)) < 1e-9);
+    }
+
+    // batch prediction of inputs padded to the same size
+    const size_t n = 5;
+    std::vector<double> xs;
+    for(const auto& x: SVR_INPUTS){
+        std::copy(std::begin(x), std::end(x), std::back_inserter(xs));
+        xs.resize(xs.size() + n - x.size(), 0.0);
+    }
+    std::vector<double> outputs(SVR_INPUTS.size());
+    model.predict(xs.data(), n, SVR_INPUTS.size(), outputs.data());
+    for(size_t k = 0; k < SVR_INPUTS.size(); ++k){
+        CHECK(outputs[k] == model.predict(xs.data() + k * n, n));
+    }
+    std::remove(path.c_str());
+}
+
+TEST_CASE( "predict same values as LIBSVM", "[regression]" ) {
+    checkSVRModel("rbf", "gamma 0.5\n", SVRModel::RBF);
+    checkSVRModel("linear", "", SVRModel::LINEAR);
+    checkSVRModel("polynomial", "degree 3\ngamma 0.25\ncoef0 1\n", SVRModel::POLY);
+    checkSVRModel("sigmoid", "gamma 0.25\ncoef0 -0.5\n", SVRModel::SIGMOID);
+}
+
+TEST_CASE( "treat missing features as absent nodes of LIBSVM", "[regression]" ) {
+    const auto path = writeSVRModel("rbf", "gamma 0.5\n");
+    SVRPredictor predict({"a", "b", "c", "d"}, path);
+    FeatureVector x = {0.5, Feature::missing(), 0.7, Feature::missing()};
+    CHECK(std::abs(predict(x) - predictByLibsvm(path, {0.5, 0.0, 0.7, 0.0})) < 1e-9);
+    std::remove(path.c_str());
+}
+
+TEST_CASE( "approximate SVR with random Fourier features", "[regression]" ) {
+    const auto path = writeSVRModel("rbf", "gamma 0.5\n");
+    SVRModel model(path);
+    ApproximateSVRModel approximated(model, 4096, 1);
+    CHECK(approximated.size() == 4096);
+    for(const auto& x: SVR_INPUTS){
+        CHECK(std::abs(approximated.predict(x) - model.predict(x)) < 0.1);
+    }
+    const size_t n = 5;
+    std::vector<double> xs;
+    for(const auto& x: SVR_INPUTS){
+        std::copy(std::begin(x), std::end(x), std::back_inserter(xs));
+        xs.resize(xs.size() + n - x.size(), 0.0);
+    }
+    CHECK(approximated.maxError(model, xs.data(), n, SVR_INPUTS.size()) < 0.1);
+    CHECK(ApproximateSVRModel(model, 16384, 1).maxError(model, xs.data(), n, SVR_INPUTS.size()) <
+            ApproximateSVRModel(model, 16, 1).maxError(model, xs.data(), n, SVR_INPUTS.size()));
+
+    SVRPredictor predict({"a", "b", "c", "d"}, path);
+    FeatureVector x = {0.5, Feature::missing(), 0.7, 0.1};
+    CHECK_THROWS_AS(predict.approximate(4096, 0.1, {}), std::invalid_argument&);
+    CHECK_THROWS_AS(predict.approximate(16, 1e-12, {x}), std::runtime_error&);
+    CHECK(predict(x) == model.predict({0.5, 0.0, 0.7, 0.1}));
+    CHECK(predict.approximate(4096, 0.1, {x}, 1) < 0.1);
+    CHECK(predict(x) == approximated.predict({0.5, 0.0, 0.7, 0.1}));
+    std::remove(path.c_str());
+
+    const auto linear_path = writeSVRModel("linear", "");
+    CHECK_THROWS(ApproximateSVRModel(SVRModel(linear_path), 16));
+    std::remove(linear_path.c_str());
+}
+
+TEST_CASE( "reject models other than SVR", "[regression]" ) {
+    const std::string path = "test_svr_model_csvc.tmp";
+    {
+        std::ofstream ofs(path);
+        ofs << "svm_type c_svc\nkernel_type linear\nnr_class 2\ntotal_sv 1\nrho 0\nlabel 1 -1\nnr_sv 1 0\nSV\n1 0:1 \n";
+    }
+    CHECK_THROWS(SVRModel(path));
+    std::remove(path.c_str());
+}
@@ -21,6 +21,7 @@ limitations under the License.
 #include <iostream>
 #include <codecvt>
 #include "measure/word_sequence_builder.hpp"
+#include "string_util.hpp"
 
 #include "Catch/catch.hpp"
 
@@ -36,19 +37,17 @@ TEST_CASE( "parse a word", "[language]" ) {
 
     std::string mecab_options = "";
     WordSequenceBuilder preprocess(mecab_options);
-    std::wstring_convert<std::codecvt_utf8<wchar_t>, wchar_t> converter;
 
-    std::wstring text = L"テスト";
+    string_type text = RESEMBLA_TEXT("テスト");
     auto words = preprocess(text);
     CHECK(words.size() == 1);
 
     auto& m = words[0];
-    CHECK(converter.to_bytes(m.surface) == "テスト");
-    CHECK(m.feature.size() == 9);
-    std::vector<std::string> features = {"名詞", "サ変接続", "*", "*", "*", "*", "テスト", "テスト", "テスト"};
-    for(size_t i = 0; i < features.size(); ++i){
-        CHECK(converter.to_bytes(m.feature[i]) == features[i]);
-    }
+    CHECK(cast_string<std::string>(m.surface) == "テスト");
+    CHECK(m.pos == Word::NOUN);
+    CHECK(m.subcategory == Word::OTHER_SUBCATEGORY);
+    CHECK(cast_string<std::string>(m.base_form) == "テスト");
+    CHECK(cast_string<std::string>(m.reading) == "テスト");
 }
 
 TEST_CASE( "parse words", "[language]" ) {
@@ -61,23 +60,46 @@ TEST_CASE( "parse words", "[language]" ) {
 
     std::string mecab_options = "";
     WordSequenceBuilder preprocess(mecab_options);
-    std::wstring_convert<std::codecvt_utf8<wchar_t>, wchar_t> converter;
 
-    std::wstring text = L"私は考える";
+    string_type text = RESEMBLA_TEXT("私は考える");
     auto words = preprocess(text);
     CHECK(words.size() == 3);
 
     auto& m = words[0];
-    CHECK(converter.to_bytes(m.surface) == "私");
-    CHECK(converter.to_bytes(m.feature[0]) == "名詞");
+    CHECK(cast_string<std::string>(m.surface) == "私");
+    CHECK(m.pos == Word::NOUN);
+    CHECK(m.subcategory == Word::PRONOUN);
     m = words[1];
-    CHECK(converter.to_bytes(m.surface) == "は");
-    CHECK(converter.to_bytes(m.feature[0]) == "助詞");
+    CHECK(cast_string<std::string>(m.surface) == "は");
+    CHECK(m.pos == Word::OTHER_POS);
     m = words[2];
-    CHECK(converter.to_bytes(m.surface) == "考える");
-    CHECK(converter.to_bytes(m.feature[0]) == "動詞");
+    CHECK(cast_string<std::string>(m.surface) == "考える");
+    CHECK(m.pos == Word::VERB);
+    CHECK(cast_string<std::string>(m.base_form) == "考える");
+}
 
-    for(auto i = words.begin(); i != words.end(); ++i){
-        CHECK(i->feature.size() == 9);
-    }
+TEST_CASE( "read features without copy", "[language]" ) {
+    init_locale();
+
+    std::string feature = "名詞,,固有名詞,*,*,*,東京,トウキョウ,トーキョー";
+    FeatureView view(feature);
+    CHECK(view.size() == 8);
+    CHECK(view[0] == RESEMBLA_TEXT("名詞"));
+    CHECK(view[1] == RESEMBLA_TEXT("固有名詞"));
+    CHECK(view[6] == RESEMBLA_TEXT("トウキョウ"));
+    CHECK(view[7] == RESEMBLA_TEXT("トーキョー"));
+    CHECK(view[8] == RESEMBLA_TEXT(""));
+    CHECK(view.equals(0, "名詞"));
+    CHECK_FALSE(view.equals(0, "名"));
+    CHECK_FALSE(view.equals(8, "*"));
+
+    Word w(RESEMBLA_TEXT("東京"), view);
+    CHECK(w == Word(RESEMBLA_TEXT("東京"), {RESEMBLA_TEXT("名詞"), RESEMBLA_TEXT("固有名詞"), RESEMBLA_TEXT("*"), RESEMBLA_TEXT("*"), RESEMBLA_TEXT("*"), RESEMBLA_TEXT("東京"), RESEMBLA_TEXT("トウキョウ"), RESEMBLA_TEXT("トーキョー")}));
+    CHECK(w.pos == Word::NOUN);
+    CHECK(w.base_form == RESEMBLA_TEXT("トウキョウ"));
+    CHECK(w.reading == RESEMBLA_TEXT("トーキョー"));
+
+    Word unknown(RESEMBLA_TEXT("ほげ"), FeatureView(std::string("名詞,一般,*,*,*,*,*")));
+    CHECK(unknown.base_form.empty());
+    CHECK(unknown.reading.empty());
 }